@@ -0,0 +1,66 @@
+#ifndef LIBSTORE_AGGREGATE_H
+#define LIBSTORE_AGGREGATE_H
+
+#include <stdbool.h> // bool
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Counts the numeric elements of a list store. Like all aggregations, this runs vectorized over packed arrays and
+ * skips elements that are neither ints nor floats in generic lists.
+ *
+ * @param store			the list store to aggregate
+ * @result				the number of int and float elements, or -1 if the store is not a list
+ */
+LIBSTORE_API int storeListCount(Store *store);
+
+/**
+ * Sums up the numeric elements of a list store
+ *
+ * @param store			the list store to aggregate
+ * @result				the sum of the int and float elements, or 0 if there are none or the store is not a list
+ */
+LIBSTORE_API double storeListSum(Store *store);
+
+/**
+ * Finds the smallest numeric element of a list store
+ *
+ * @param store			the list store to aggregate
+ * @param min			pointer to be set to the smallest element, or to NaN if any element is NaN
+ * @result				true if the list has numeric elements, false otherwise or if the store is not a list
+ */
+LIBSTORE_API bool storeListMin(Store *store, double *min);
+
+/**
+ * Finds the largest numeric element of a list store
+ *
+ * @param store			the list store to aggregate
+ * @param max			pointer to be set to the largest element, or to NaN if any element is NaN
+ * @result				true if the list has numeric elements, false otherwise or if the store is not a list
+ */
+LIBSTORE_API bool storeListMax(Store *store, double *max);
+
+/**
+ * Computes the arithmetic mean of the numeric elements of a list store
+ *
+ * @param store			the list store to aggregate
+ * @param mean			pointer to be set to the mean
+ * @result				true if the list has numeric elements, false otherwise or if the store is not a list
+ */
+LIBSTORE_API bool storeListMean(Store *store, double *mean);
+
+/**
+ * Counts the numeric elements of a list store into equally wide bins spanning [lower, upper).
+ * Elements outside of the range are not counted.
+ *
+ * @param store			the list store to aggregate
+ * @param lower			the inclusive lower bound of the first bin
+ * @param upper			the exclusive upper bound of the last bin, must be larger than the lower bound
+ * @param numBins		the number of bins, must be positive
+ * @param bins			array of numBins counters that the element counts are added to
+ * @result				true if the histogram was computed, false if the store is not a list or the range is invalid
+ */
+LIBSTORE_API bool storeListHistogram(Store *store, double lower, double upper, int numBins, int *bins);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef LIBSTORE_BINARY_H
+#define LIBSTORE_BINARY_H
+
+#include <stddef.h> // size_t
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * The version of the binary encoding, which is increased whenever the encoding changes so that data in previous
+ * versions is rejected rather than misread
+ */
+#define STORE_BINARY_VERSION 1
+
+/**
+ * Encodes a store into a compact binary representation that can be decoded much faster than parsing its text. The
+ * encoding starts with a magic number and STORE_BINARY_VERSION, stores numbers as little endian varints or IEEE
+ * doubles independently of the machine, and keeps packed arrays packed. Tables are encoded as their rows and converted
+ * back into columns when decoded, see storeToColumns.
+ *
+ * @param store			the store to encode
+ * @param length		pointer to be set to the number of encoded bytes
+ * @result				the encoded bytes, must be freed with free
+ */
+LIBSTORE_API char *storeEncodeBinary(Store *store, size_t *length);
+
+/**
+ * Decodes a store from its binary representation, see storeEncodeBinary
+ *
+ * @param data			the encoded bytes
+ * @param length		the number of encoded bytes
+ * @result				the decoded store, must be freed with storeFree, or NULL if the data is malformed, truncated or
+ *						encoded by a different version
+ */
+LIBSTORE_API Store *storeDecodeBinary(const char *data, size_t length);
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef LIBSTORE_CACHE_H
+#define LIBSTORE_CACHE_H
+
+#include <stddef.h> // size_t
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Opaque struct caching parsed stores in memory, keyed by a digest of the parsed text or by a key chosen by the caller.
+ * Cached stores are frozen, see storeFreeze, and handed out as shared references, see storeRetain, so any number of
+ * threads can read them concurrently and an evicted store lives on until its last user frees it. The least recently
+ * used stores are evicted whenever the sizes of the cached stores exceed the cache's budget, see storeGetMemorySize.
+ * A cache can be used by multiple threads at once.
+ */
+typedef struct StoreCacheStruct StoreCache;
+
+/**
+ * Struct holding the counters of a cache
+ */
+typedef struct {
+	/** The number of lookups that found a cached store */
+	unsigned long long hits;
+	/** The number of lookups that didn't find a cached store */
+	unsigned long long misses;
+	/** The number of stores evicted to stay within the budget */
+	unsigned long long evictions;
+	/** The number of cached stores */
+	int numEntries;
+	/** The total size of the cached stores in bytes */
+	size_t size;
+	/** The maximum total size of the cached stores in bytes */
+	size_t budget;
+} StoreCacheStatistics;
+
+/**
+ * Creates an empty cache
+ *
+ * @param budget		the maximum total size of the cached stores in bytes
+ * @param parseFlags	the flags to parse texts with in storeCacheParse, see StoreParseFlag, except that spans are never
+ *						recorded
+ * @result				the created cache, must be freed with storeFreeCache
+ */
+LIBSTORE_API StoreCache *storeCreateCache(size_t budget, int parseFlags);
+
+/**
+ * Frees a cache, releasing its references to the cached stores
+ *
+ * @param cache			the cache to free, must no longer be used by any other thread
+ */
+LIBSTORE_API void storeFreeCache(StoreCache *cache);
+
+/**
+ * Returns the cached store parsed from a text, parsing and caching it on a miss. The cache is keyed by a 128-bit digest
+ * of the text, see storeDigest, and the text is parsed without holding the cache's lock.
+ *
+ * @param cache			the cache to use
+ * @param input			the text to parse
+ * @result				a shared reference to the frozen parsed store, must be released with storeFree, or NULL if the
+ *						text can't be parsed
+ */
+LIBSTORE_API Store *storeCacheParse(StoreCache *cache, const char *input);
+
+/**
+ * Looks up the store cached for a caller's key
+ *
+ * @param cache			the cache to query
+ * @param key			the key of the store
+ * @result				a shared reference to the frozen store, must be released with storeFree, or NULL if no store is
+ *						cached for the key
+ */
+LIBSTORE_API Store *storeCacheLookup(StoreCache *cache, const char *key);
+
+/**
+ * Caches a store for a caller's key, replacing any store previously cached for it. The store is frozen first. A store
+ * larger than the whole budget is not cached.
+ *
+ * @param cache			the cache to insert into
+ * @param key			the key of the store, will be copied
+ * @param store			the store to cache, ownership is transferred to the cache
+ * @result				a shared reference to the frozen store, must be released with storeFree
+ */
+LIBSTORE_API Store *storeCacheInsert(StoreCache *cache, const char *key, Store *store);
+
+/**
+ * Removes all stores from a cache without resetting its counters
+ *
+ * @param cache			the cache to clear
+ */
+LIBSTORE_API void storeCacheClear(StoreCache *cache);
+
+/**
+ * Reads the counters of a cache
+ *
+ * @param cache			the cache to query
+ * @param statistics	the struct to fill in with a consistent view of the counters
+ */
+LIBSTORE_API void storeCacheGetStatistics(StoreCache *cache, StoreCacheStatistics *statistics);
+
+#endif
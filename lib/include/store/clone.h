@@ -0,0 +1,26 @@
+#ifndef LIBSTORE_CLONE_H
+#define LIBSTORE_CLONE_H
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Flags to configure how a store is cloned
+ */
+typedef enum {
+	/** Clones large subtrees below the root on multiple threads */
+	STORE_CLONE_PARALLEL = 1
+} StoreCloneFlag;
+
+/**
+ * Deep copies a store. Every map is copied into an entry array and index sized for it up front, so no container is
+ * regrown while copying. The clone doesn't share any subtrees with the store or within itself, except for tables,
+ * which are never modified and therefore shared, see storeRetain.
+ *
+ * @param store			the store to clone
+ * @param flags			bitwise or of StoreCloneFlag values
+ * @result				the modifiable clone, must be freed with storeFree
+ */
+LIBSTORE_API Store *storeClone(Store *store, int flags);
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef LIBSTORE_COMPACT_H
+#define LIBSTORE_COMPACT_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Opaque struct owning an immutable compact copy of a store tree, whose nodes are all allocated in one arena
+ */
+typedef struct StoreCompactStruct StoreCompact;
+
+/**
+ * A compact value of 8 bytes. Floats are stored as plain doubles, while ints, strings, lists and maps are encoded in
+ * the payload bits of NaNs, so that scalars need no allocation and containers hold their children inline.
+ */
+typedef uint64_t StoreValue;
+
+/**
+ * Creates a compact copy of a store tree. Packed arrays become lists of ints or floats.
+ *
+ * @param store			the store to copy, which is left unchanged
+ * @result				the compact copy, must be freed with storeFreeCompact, or NULL if the tree contains a table
+ */
+LIBSTORE_API StoreCompact *storeCreateCompact(Store *store);
+
+/**
+ * Frees a compact copy together with all of its values
+ *
+ * @param compact		the compact copy to free
+ */
+LIBSTORE_API void storeFreeCompact(StoreCompact *compact);
+
+/**
+ * Returns the root value of a compact copy
+ *
+ * @param compact		the compact copy to query
+ * @result				the root value, valid as long as the compact copy
+ */
+LIBSTORE_API StoreValue storeCompactGetRoot(StoreCompact *compact);
+
+/**
+ * Returns the number of bytes allocated for a compact copy
+ *
+ * @param compact		the compact copy to query
+ * @result				the number of allocated bytes
+ */
+LIBSTORE_API size_t storeCompactGetSize(StoreCompact *compact);
+
+/**
+ * Retrieves the type of a compact value
+ *
+ * @param value			the value to query
+ * @param type			the type to fill in, which is one of STORE_STRING, STORE_INT, STORE_FLOAT, STORE_LIST and STORE_MAP
+ * @result				true if the value has a type, false if it is missing, see storeValueIsMissing
+ */
+LIBSTORE_API bool storeValueGetType(StoreValue value, StoreType *type);
+
+/**
+ * Returns whether a compact value is the missing value returned by failed lookups
+ *
+ * @param value			the value to query
+ * @result				true if the value is missing
+ */
+LIBSTORE_API bool storeValueIsMissing(StoreValue value);
+
+/**
+ * Returns the int of a compact int value
+ *
+ * @param value			the value to query
+ * @param defaultValue	the value to return if the value is not an int
+ * @result				the int, or the default value
+ */
+LIBSTORE_API int storeValueGetInt(StoreValue value, int defaultValue);
+
+/**
+ * Returns the number of a compact int or float value
+ *
+ * @param value			the value to query
+ * @param defaultValue	the value to return if the value is not a number
+ * @result				the number, or the default value
+ */
+LIBSTORE_API double storeValueGetFloat(StoreValue value, double defaultValue);
+
+/**
+ * Returns the string of a compact string value
+ *
+ * @param value			the value to query
+ * @result				the string owned by the compact copy, or NULL if the value is not a string
+ */
+LIBSTORE_API const char *storeValueGetString(StoreValue value);
+
+/**
+ * Returns the number of elements of a compact list value or entries of a compact map value
+ *
+ * @param value			the value to query
+ * @result				the number of children, or -1 if the value is not a container
+ */
+LIBSTORE_API int storeValueGetLength(StoreValue value);
+
+/**
+ * Returns an element of a compact list value
+ *
+ * @param value			the list value to query
+ * @param index			the index of the element
+ * @result				the element, or a missing value if the index is out of bounds or the value is not a list
+ */
+LIBSTORE_API StoreValue storeValueGetElement(StoreValue value, int index);
+
+/**
+ * Looks up the value for a key in a compact map value
+ *
+ * @param value			the map value to query
+ * @param key			the key to look up
+ * @result				the value for the key, or a missing value if there is no such entry or the value is not a map
+ */
+LIBSTORE_API StoreValue storeValueLookup(StoreValue value, const char *key);
+
+/**
+ * Reads an entry of a compact map value, in insertion order
+ *
+ * @param value			the map value to query
+ * @param index			the index of the entry
+ * @param key			pointer to be set to the entry's key, may be NULL
+ * @param entryValue	pointer to be set to the entry's value, may be NULL
+ * @result				true if the entry was read, false if the index is out of bounds or the value is not a map
+ */
+LIBSTORE_API bool storeValueGetEntry(StoreValue value, int index, const char **key, StoreValue *entryValue);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef LIBSTORE_COMPARE_H
+#define LIBSTORE_COMPARE_H
+
+#include <stdbool.h> // bool
+#include <stdint.h> // uint64_t
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Compares two stores for deep equality. Maps are equal if they have the same keys with equal values regardless of
+ * their insertion order, and generic lists are equal to packed arrays with the same elements. Ints are never equal to
+ * floats, floats compare by value except that NaNs are equal to each other. The comparison stops at the first
+ * difference, skips subtrees shared by both stores, and skips subtrees whose cached hashes differ, see storeHash.
+ *
+ * @param first			the first store to compare
+ * @param second		the second store to compare
+ * @result				true if the stores are equal
+ */
+LIBSTORE_API bool storeEquals(Store *first, Store *second);
+
+/**
+ * Computes a structural hash of a store bottom-up, which is equal for stores that are equal according to storeEquals
+ * and doesn't depend on the process, so it can be persisted or compared across machines. The hashes of frozen maps and
+ * lists are cached in them, see storeFreeze, so rehashing a tree whose subtrees were replaced by storeWith only visits
+ * the new stores along the replaced paths.
+ *
+ * @param store			the store to hash
+ * @result				the 64-bit hash of the store
+ */
+LIBSTORE_API uint64_t storeHash(Store *store);
+
+#endif
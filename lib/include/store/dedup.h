@@ -0,0 +1,22 @@
+#ifndef LIBSTORE_DEDUP_H
+#define LIBSTORE_DEDUP_H
+
+#include <stddef.h> // size_t
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Deduplicates a store by hashing its subtrees bottom-up and replacing every subtree that is identical to one seen
+ * before with a reference to that one, see storeRetain. Subtrees are identical if they have the same type and content,
+ * with map entries compared in insertion order. The shared subtrees can no longer be modified, but freeing the store
+ * still releases them correctly. Tables and the elements of lists with indexes maintained over them are left in place,
+ * and so are the descendants of subtrees that are already shared or frozen, since those belong to other owners too.
+ *
+ * @param store			the store to deduplicate, which itself is never replaced, nothing is deduplicated if it is
+ *						shared or frozen
+ * @result				the number of bytes freed by sharing identical subtrees
+ */
+LIBSTORE_API size_t storeDeduplicate(Store *store);
+
+#endif
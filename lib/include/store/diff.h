@@ -0,0 +1,38 @@
+#ifndef LIBSTORE_DIFF_H
+#define LIBSTORE_DIFF_H
+
+#include <stdbool.h> // bool
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Computes a patch transforming one store into another. The patch is itself a store, a list of operation maps such as
+ * '[{op = replace, path = "servers[1].name", value = beta} {op = remove, path = timeout}]', so it can be written with
+ * storeWrite and parsed back with storeParse. Each operation's op is one of:
+ *  - "add", inserting value as a new map entry or list element at path
+ *  - "remove", removing the map entry or list element at path
+ *  - "replace", replacing the value at path, where an empty path replaces the whole store
+ * Paths use the syntax of storeCompilePath, and list indices refer to the list as modified by the preceding operations.
+ * Identical subtrees are skipped by comparing their hashes, see storeHash, maps are matched by key and generic lists by
+ * a longest common subsequence of their elements, while differing packed arrays and tables are replaced as a whole.
+ *
+ * @param first			the store to transform
+ * @param second		the store to transform into
+ * @result				the patch, which is an empty list if the stores are equal, must be freed with storeFree
+ */
+LIBSTORE_API Store *storeDiff(Store *first, Store *second);
+
+/**
+ * Applies a patch computed by storeDiff to a store in place. The operations are applied in order, and the patch's
+ * values are copied so that it can be applied to any number of stores.
+ *
+ * @param store			the store to modify
+ * @param patch			the patch to apply
+ * @result				true if the patch was applied, false if it is malformed or an operation failed, e.g. because its
+ *						path doesn't exist in the store or leads through a frozen or shared store, in which case the
+ *						preceding operations remain applied
+ */
+LIBSTORE_API bool storePatch(Store *store, Store *patch);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef LIBSTORE_DIGEST_H
+#define LIBSTORE_DIGEST_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t
+
+#include <store/api.h>
+
+/**
+ * The number of characters of a digest formatted by storeFormatDigest, excluding the terminating null character
+ */
+#define STORE_DIGEST_STRING_LENGTH 32
+
+/**
+ * Struct holding a 128-bit content digest
+ */
+typedef struct {
+	/** The lower 64 bits of the digest */
+	uint64_t low;
+	/** The upper 64 bits of the digest */
+	uint64_t high;
+} StoreDigest;
+
+/**
+ * Computes a fast non-cryptographic 128-bit digest of a byte buffer (MurmurHash3 x64 128), to recognize unchanged
+ * contents. It doesn't depend on the process or the machine, so digests can be persisted, but it must not be relied
+ * upon against deliberately colliding inputs.
+ *
+ * @param data			the bytes to digest
+ * @param length		the number of bytes to digest
+ * @result				the digest of the bytes
+ */
+LIBSTORE_API StoreDigest storeDigest(const void *data, size_t length);
+
+/**
+ * Compares two digests
+ *
+ * @param first			the first digest to compare
+ * @param second		the second digest to compare
+ * @result				true if the digests are equal
+ */
+LIBSTORE_API bool storeDigestEquals(StoreDigest first, StoreDigest second);
+
+/**
+ * Formats a digest as hexadecimal digits, the upper bits first
+ *
+ * @param digest		the digest to format
+ * @param string		the buffer of at least STORE_DIGEST_STRING_LENGTH + 1 characters to write the digits to
+ */
+LIBSTORE_API void storeFormatDigest(StoreDigest digest, char *string);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef LIBSTORE_FILE_H
+#define LIBSTORE_FILE_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+
+#include <store/api.h>
+
+/**
+ * Reads the whole contents of a file into a null-terminated buffer
+ *
+ * @param filename		the name of the file to read
+ * @param length		set to the number of bytes read if not NULL
+ * @result				the contents of the file, must be freed with free, or NULL if the file can't be read
+ */
+LIBSTORE_NO_EXPORT char *storeReadFile(const char *filename, size_t *length);
+
+/**
+ * Writes a file atomically by writing a temporary file next to it and renaming it over the file, so that readers see
+ * either the previous or the complete new contents
+ *
+ * @param filename		the name of the file to write
+ * @param contents		the bytes to write
+ * @param length		the number of bytes to write
+ * @result				true if the file was written, false otherwise, in which case the file is unchanged
+ */
+LIBSTORE_NO_EXPORT bool storeWriteFileAtomically(const char *filename, const char *contents, size_t length);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef LIBSTORE_FILECACHE_H
+#define LIBSTORE_FILECACHE_H
+
+#include <stddef.h> // size_t
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Parses a store file through an on-disk cache of parsed trees, so that processes repeatedly parsing the same large
+ * files decode them from their binary encoding instead, see storeEncodeBinary. Cache entries are named by a 128-bit
+ * digest of the file contents and the parse flags, so a changed file misses the cache without checking timestamps.
+ * Entries are written atomically, so concurrent processes sharing the cache directory never see partial entries.
+ * Entries of other binary encoding versions are deleted, and the least recently used entries are deleted whenever the
+ * cache exceeds its size. Failing to read or write the cache only makes it miss.
+ *
+ * @param filename			the name of the store file to parse
+ * @param cacheDirectory	the existing directory to keep the cache entries in
+ * @param parseFlags		the flags to parse the file with, see StoreParseFlag, except that spans are never recorded
+ * @param maxCacheSize		the maximum total number of bytes of the cache entries in the directory
+ * @result					the parsed store, must be freed with storeFree, or NULL if the file can't be read or parsed
+ */
+LIBSTORE_API Store *storeParseFileCached(const char *filename, const char *cacheDirectory, int parseFlags, size_t maxCacheSize);
+
+#endif
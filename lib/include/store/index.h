@@ -0,0 +1,123 @@
+#ifndef LIBSTORE_INDEX_H
+#define LIBSTORE_INDEX_H
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Opaque struct representing a secondary index over the elements of a list store by the value at a key path
+ */
+typedef struct StoreIndexStruct StoreIndex;
+
+/**
+ * Enumeration of the index kinds
+ */
+typedef enum {
+	/** A hash index for exact lookups */
+	STORE_INDEX_HASH,
+	/** A sorted index for exact lookups and range queries */
+	STORE_INDEX_SORTED
+} StoreIndexType;
+
+/**
+ * Adds an element of the indexed list to an index
+ *
+ * @param index			the index to add to
+ * @param element		the element to add, not indexed if it has no int or string value at the index's key path
+ */
+LIBSTORE_NO_EXPORT void storeIndexAddElement(StoreIndex *index, Store *element);
+
+/**
+ * Removes an element of the indexed list from an index
+ *
+ * @param index			the index to remove from
+ * @param element		the element to remove
+ */
+LIBSTORE_NO_EXPORT void storeIndexRemoveElement(StoreIndex *index, Store *element);
+
+/**
+ * Creates an index over the elements of a generic list store by the int or string value at a key path within each
+ * element, e.g. "id" or "meta.name". Elements without an int or string value at the path are not indexed.
+ * The index is kept up to date while the list is modified through storeListAppend, storeListInsert and
+ * storeListRemove, but not when an element itself is modified.
+ *
+ * @param store			the list store to index
+ * @param keyPath		the path of the key within each element, see storeCompilePath
+ * @param type			the kind of index to create
+ * @result				the created index, which is freed together with the list or earlier with storeFreeIndex,
+ *						or NULL if the store is not a generic list or the key path is malformed
+ */
+LIBSTORE_API StoreIndex *storeCreateIndex(Store *store, const char *keyPath, StoreIndexType type);
+
+/**
+ * Frees an index and stops maintaining it
+ *
+ * @param index			the index to free
+ */
+LIBSTORE_API void storeFreeIndex(StoreIndex *index);
+
+/**
+ * Returns the number of elements in an index
+ *
+ * @param index			the index to query
+ * @result				the number of indexed elements
+ */
+LIBSTORE_API int storeIndexGetSize(StoreIndex *index);
+
+/**
+ * Looks up an element by its key
+ *
+ * @param index			the index to query
+ * @param key			an int or string store holding the key to look up
+ * @result				an element with the key, or NULL if there is no such element
+ */
+LIBSTORE_API Store *storeIndexLookup(StoreIndex *index, Store *key);
+
+/**
+ * Looks up an element by its int key
+ *
+ * @param index			the index to query
+ * @param key			the key to look up
+ * @result				an element with the key, or NULL if there is no such element
+ */
+LIBSTORE_API Store *storeIndexLookupInt(StoreIndex *index, int key);
+
+/**
+ * Looks up an element by its string key
+ *
+ * @param index			the index to query
+ * @param key			the key to look up
+ * @result				an element with the key, or NULL if there is no such element
+ */
+LIBSTORE_API Store *storeIndexLookupString(StoreIndex *index, const char *key);
+
+/**
+ * Returns the position of the first element of a sorted index whose key is not less than a key.
+ * Int keys sort before string keys, and elements with equal keys are in the order they were indexed.
+ *
+ * @param index			the sorted index to query
+ * @param key			an int or string store holding the key to search for
+ * @result				the position between 0 and the size of the index, or -1 if the index is not sorted
+ */
+LIBSTORE_API int storeIndexLowerBound(StoreIndex *index, Store *key);
+
+/**
+ * Returns the position of the first element of a sorted index whose key is greater than a key
+ *
+ * @param index			the sorted index to query
+ * @param key			an int or string store holding the key to search for
+ * @result				the position between 0 and the size of the index, or -1 if the index is not sorted
+ */
+LIBSTORE_API int storeIndexUpperBound(StoreIndex *index, Store *key);
+
+/**
+ * Returns the element at a position of a sorted index, to iterate over a range found with storeIndexLowerBound and
+ * storeIndexUpperBound
+ *
+ * @param index			the sorted index to query
+ * @param position		the position of the element
+ * @result				the element at the position, or NULL if the position is out of bounds or the index is not sorted
+ */
+LIBSTORE_API Store *storeIndexGetElement(StoreIndex *index, int position);
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef LIBSTORE_LIST_H
+#define LIBSTORE_LIST_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t
+
+#include <glib.h>
+
+#include <store/api.h>
+#include <store/index.h>
+#include <store/store.h>
+
+/**
+ * Creates an empty generic list
+ *
+ * @result				the created list, must be freed with storeFreeList
+ */
+LIBSTORE_NO_EXPORT GQueue *storeCreateList();
+
+/**
+ * Frees a generic list together with all of its elements and the indexes maintained over it
+ *
+ * @param list			the list to free
+ */
+LIBSTORE_NO_EXPORT void storeFreeList(GQueue *list);
+
+/**
+ * Copies the elements of a generic list into a new list without indexes
+ *
+ * @param list			the list to copy
+ * @param copyElement	the function to copy the elements with, e.g. one that shares them with storeRetain
+ * @param userData		the user data to pass to the function
+ * @result				the copied list, must be freed with storeFreeList
+ */
+LIBSTORE_NO_EXPORT GQueue *storeCopyList(GQueue *list, StoreCopyFunction copyElement, void *userData);
+
+/**
+ * Freezes a generic list, which makes it reject any further modifications
+ *
+ * @param list			the list to freeze
+ */
+LIBSTORE_NO_EXPORT void storeFreezeList(GQueue *list);
+
+/**
+ * Returns the structural hash cached in a generic list by storeListCacheHash
+ *
+ * @param list			the list to query
+ * @result				the cached hash, or zero if none was cached
+ */
+LIBSTORE_NO_EXPORT uint64_t storeListGetCachedHash(GQueue *list);
+
+/**
+ * Caches the structural hash of a generic list if it is frozen and therefore can't change anymore
+ *
+ * @param list			the list to cache the hash in
+ * @param hash			the hash to cache
+ */
+LIBSTORE_NO_EXPORT void storeListCacheHash(GQueue *list, uint64_t hash);
+
+/**
+ * Returns the number of bytes allocated for a generic list's links, excluding its elements
+ *
+ * @param list			the list to measure
+ * @result				the size of the list in bytes
+ */
+LIBSTORE_NO_EXPORT size_t storeGetListMemorySize(GQueue *list);
+
+/**
+ * Registers an index to be updated when elements are added to or removed from a generic list store
+ *
+ * @param store			the list store to register the index with
+ * @param index			the index to register
+ */
+LIBSTORE_NO_EXPORT void storeListAttachIndex(Store *store, StoreIndex *index);
+
+/**
+ * Unregisters an index from a generic list store
+ *
+ * @param store			the list store to unregister the index from
+ * @param index			the index to unregister
+ */
+LIBSTORE_NO_EXPORT void storeListDetachIndex(Store *store, StoreIndex *index);
+
+/**
+ * Returns whether any indexes are maintained over a generic list store
+ *
+ * @param store			the list store to query
+ * @result				true if the store is a generic list with indexes registered
+ */
+LIBSTORE_NO_EXPORT bool storeListHasIndexes(Store *store);
+
+/**
+ * Returns whether a generic list store was frozen by storeFreeze
+ *
+ * @param store			the list store to query
+ * @result				true if the store is a frozen generic list
+ */
+LIBSTORE_API bool storeListIsFrozen(Store *store);
+
+/**
+ * Returns the number of elements in a list store, which may be a generic list or a packed int or float array
+ *
+ * @param store			the list store to query
+ * @result				the number of elements, or -1 if the store is not a list
+ */
+LIBSTORE_API int storeListGetLength(Store *store);
+
+/**
+ * Returns the element at an index of a generic list store
+ *
+ * @param store			the list store to query
+ * @param index			the index of the element to return
+ * @result				the element at the index, or NULL if the index is out of bounds or the store is not a generic list
+ */
+LIBSTORE_API Store *storeListGet(Store *store, int index);
+
+/**
+ * Reads the element at an index of a list store into a caller provided store, which works for both generic lists and
+ * packed arrays. Elements of packed arrays are returned as int or float stores. The element shares its content with
+ * the list and must not be freed.
+ *
+ * @param store			the list store to query
+ * @param index			the index of the element to read
+ * @param element		the store to read the element into
+ * @result				true if the element was read, false if the index is out of bounds or the store is not a list
+ */
+LIBSTORE_API bool storeListGetElement(Store *store, int index, Store *element);
+
+/**
+ * Returns the int element at an index of a list store
+ *
+ * @param store			the list store to query
+ * @param index			the index of the element to return
+ * @param defaultValue	the value to return if there is no int at the index
+ * @result				the int at the index, or the default value
+ */
+LIBSTORE_API int storeListGetInt(Store *store, int index, int defaultValue);
+
+/**
+ * Returns the number element at an index of a list store, converting int elements to float
+ *
+ * @param store			the list store to query
+ * @param index			the index of the element to return
+ * @param defaultValue	the value to return if there is no number at the index
+ * @result				the number at the index, or the default value
+ */
+LIBSTORE_API double storeListGetFloat(Store *store, int index, double defaultValue);
+
+/**
+ * Appends an element to a generic list store, updating the indexes maintained over it
+ *
+ * @param store			the list store to append to
+ * @param value			the element to append, ownership is transferred to the list unless the store is not a generic list, frozen or shared
+ * @result				true if the element was appended, false if the store is not a generic list, frozen or shared
+ */
+LIBSTORE_API bool storeListAppend(Store *store, Store *value);
+
+/**
+ * Inserts an element into a generic list store, updating the indexes maintained over it
+ *
+ * @param store			the list store to insert into
+ * @param index			the index to insert the element at, between 0 and the length of the list
+ * @param value			the element to insert, ownership is transferred to the list unless the insertion fails
+ * @result				true if the element was inserted, false if the index is out of bounds or the store is not a generic list, frozen or shared
+ */
+LIBSTORE_API bool storeListInsert(Store *store, int index, Store *value);
+
+/**
+ * Removes and frees an element of a generic list store, updating the indexes maintained over it
+ *
+ * @param store			the list store to remove from
+ * @param index			the index of the element to remove
+ * @result				true if the element was removed, false if the index is out of bounds or the store is not a generic list, frozen or shared
+ */
+LIBSTORE_API bool storeListRemove(Store *store, int index);
+
+/**
+ * Converts a non-empty generic list store whose elements are all ints or all floats into a packed array in place
+ *
+ * @param store			the list store to pack
+ * @result				true if the list was packed, false if it can't be packed, is frozen or shared, or has indexes
+ *						maintained over it
+ */
+LIBSTORE_API bool storeListPack(Store *store);
+
+/**
+ * Packs every list in a store and its descendants that can be packed, see storeListPack. Shared stores and their
+ * descendants are left as they are.
+ *
+ * @param store			the store to pack the lists of
+ */
+LIBSTORE_API void storePackLists(Store *store);
+
+#endif
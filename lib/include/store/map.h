@@ -0,0 +1,219 @@
+#ifndef LIBSTORE_MAP_H
+#define LIBSTORE_MAP_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Struct to iterate over the entries of a map store
+ */
+typedef struct {
+	/** The map being iterated */
+	StoreMap *map;
+	/** The position of the next entry in the map's insertion order */
+	int index;
+} StoreMapIterator;
+
+/**
+ * Struct to represent a map key together with its precomputed hash, for repeated lookups of the same key
+ */
+typedef struct {
+	/** The key string */
+	char *string;
+	/** The precomputed hash of the key string */
+	unsigned int hash;
+} StoreKey;
+
+/**
+ * Creates an empty map
+ *
+ * @result				the created map, must be freed with storeFreeMap
+ */
+LIBSTORE_NO_EXPORT StoreMap *storeCreateMap();
+
+/**
+ * Frees a map together with all of its keys and values
+ *
+ * @param map			the map to free
+ */
+LIBSTORE_NO_EXPORT void storeFreeMap(StoreMap *map);
+
+/**
+ * Copies the entries of a map into a new modifiable map whose entry array and index are sized for them up front
+ *
+ * @param map			the map to copy
+ * @param copyValue		the function to copy the values with, e.g. one that shares them with storeRetain
+ * @param userData		the user data to pass to the function
+ * @result				the copied map, must be freed with storeFreeMap
+ */
+LIBSTORE_NO_EXPORT StoreMap *storeCopyMap(StoreMap *map, StoreCopyFunction copyValue, void *userData);
+
+/**
+ * Returns the number of bytes allocated for a map's entry array, index and keys, excluding its values
+ *
+ * @param map			the map to measure
+ * @result				the size of the map in bytes
+ */
+LIBSTORE_NO_EXPORT size_t storeGetMapMemorySize(StoreMap *map);
+
+/**
+ * Computes the 32-bit FNV-1a hash of a string, as used for map keys
+ *
+ * @param string		the string to hash
+ * @result				the hash of the string
+ */
+LIBSTORE_NO_EXPORT unsigned int storeHashString(const char *string);
+
+/**
+ * Freezes a map, which packs its keys into a single block, replaces its index with a perfect hash and
+ * makes it reject any further modifications. Lookups in a frozen map need a single probe and key comparison.
+ *
+ * @param map			the map to freeze
+ */
+LIBSTORE_NO_EXPORT void storeFreezeMap(StoreMap *map);
+
+/**
+ * Returns the structural hash cached in a map by storeMapCacheHash
+ *
+ * @param map			the map to query
+ * @result				the cached hash, or zero if none was cached
+ */
+LIBSTORE_NO_EXPORT uint64_t storeMapGetCachedHash(StoreMap *map);
+
+/**
+ * Caches the structural hash of a map if it is frozen and therefore can't change anymore
+ *
+ * @param map			the map to cache the hash in
+ * @param hash			the hash to cache
+ */
+LIBSTORE_NO_EXPORT void storeMapCacheHash(StoreMap *map, uint64_t hash);
+
+/**
+ * Returns whether a map store was frozen by storeFreeze
+ *
+ * @param store			the map store to query
+ * @result				true if the store is a frozen map
+ */
+LIBSTORE_API bool storeMapIsFrozen(Store *store);
+
+/**
+ * Returns the number of entries in a map store
+ *
+ * @param store			the map store to query
+ * @result				the number of entries, or -1 if the store is not a map
+ */
+LIBSTORE_API int storeMapGetSize(Store *store);
+
+/**
+ * Looks up the value for a key in a map store
+ *
+ * @param store			the map store to query
+ * @param key			the key to look up
+ * @result				the value stored for the key, or NULL if there is no such entry or the store is not a map
+ */
+LIBSTORE_API Store *storeMapLookup(Store *store, const char *key);
+
+/**
+ * Creates a key handle, hashing the key string once so that lookups with it skip rehashing
+ *
+ * @param string		the key string, will be copied
+ * @result				the created key, must be freed with storeFreeKey
+ */
+LIBSTORE_API StoreKey *storeCreateKey(const char *string);
+
+/**
+ * Frees a key handle
+ *
+ * @param key			the key to free
+ */
+LIBSTORE_API void storeFreeKey(StoreKey *key);
+
+/**
+ * Looks up the value for a key handle in a map store using its precomputed hash
+ *
+ * @param store			the map store to query
+ * @param key			the key handle to look up
+ * @result				the value stored for the key, or NULL if there is no such entry or the store is not a map
+ */
+LIBSTORE_API Store *storeMapGet(Store *store, StoreKey *key);
+
+/**
+ * Looks up an int value for a key handle in a map store
+ *
+ * @param store			the map store to query
+ * @param key			the key handle to look up
+ * @param defaultValue	the value to return if there is no int stored for the key
+ * @result				the int stored for the key, or the default value
+ */
+LIBSTORE_API int storeMapGetInt(Store *store, StoreKey *key, int defaultValue);
+
+/**
+ * Looks up a float value for a key handle in a map store, converting int values to float
+ *
+ * @param store			the map store to query
+ * @param key			the key handle to look up
+ * @param defaultValue	the value to return if there is no number stored for the key
+ * @result				the number stored for the key, or the default value
+ */
+LIBSTORE_API double storeMapGetFloat(Store *store, StoreKey *key, double defaultValue);
+
+/**
+ * Looks up a string value for a key handle in a map store
+ *
+ * @param store			the map store to query
+ * @param key			the key handle to look up
+ * @param defaultValue	the value to return if there is no string stored for the key
+ * @result				the string stored for the key, owned by the store, or the default value
+ */
+LIBSTORE_API const char *storeMapGetString(Store *store, StoreKey *key, const char *defaultValue);
+
+/**
+ * Inserts a value into a map store, replacing and freeing any previous value for the same key
+ *
+ * @param store			the map store to insert into
+ * @param key			the key to insert, will be copied
+ * @param value			the value to insert, ownership is transferred to the map unless the store is not a map, frozen or shared
+ * @result				true if the key was newly inserted, false if an existing value was replaced or the store is not a map, frozen or shared
+ */
+LIBSTORE_API bool storeMapInsert(Store *store, const char *key, Store *value);
+
+/**
+ * Removes and frees an entry from a map store
+ *
+ * @param store			the map store to remove from
+ * @param key			the key of the entry to remove
+ * @result				true if an entry was removed, false if there was no such entry or the store is not a map, frozen or shared
+ */
+LIBSTORE_API bool storeMapRemove(Store *store, const char *key);
+
+/**
+ * Initializes an iterator over the entries of a map store, which visits them in insertion order
+ *
+ * @param iterator		the iterator to initialize
+ * @param store			the map store to iterate over, must not be modified while iterating
+ */
+LIBSTORE_API void storeMapIteratorInit(StoreMapIterator *iterator, Store *store);
+
+/**
+ * Advances a map iterator to the next entry
+ *
+ * @param iterator		the iterator to advance
+ * @param key			pointer to be set to the entry's key, may be NULL
+ * @param value			pointer to be set to the entry's value, may be NULL
+ * @result				true if an entry was returned, false if the end of the map was reached
+ */
+LIBSTORE_API bool storeMapIteratorNext(StoreMapIterator *iterator, const char **key, Store **value);
+
+/**
+ * Replaces the value of the entry last returned by a map iterator, without freeing the previous value
+ *
+ * @param iterator		the iterator whose last returned entry to modify
+ * @param value			the new value of the entry, ownership is transferred to the map
+ */
+LIBSTORE_NO_EXPORT void storeMapIteratorReplace(StoreMapIterator *iterator, Store *value);
+
+#endif
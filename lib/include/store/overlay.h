@@ -0,0 +1,83 @@
+#ifndef LIBSTORE_OVERLAY_H
+#define LIBSTORE_OVERLAY_H
+
+#include <stdbool.h> // bool
+
+#include <store/api.h>
+#include <store/path.h>
+#include <store/store.h>
+
+/**
+ * Opaque struct stacking several layers of stores, such as base, environment, host and tenant settings, into one
+ * deep-merged view. Maps defined by several layers are merged key by key, while any other value of a higher layer
+ * replaces the values of the layers below it. The merged maps are built lazily while looking up paths and memoized, so
+ * a lookup selects one child per segment regardless of the number of layers. Changing a layer only discards the merged
+ * maps it contributed to. An overlay must only be used by one thread at a time.
+ */
+typedef struct StoreOverlayStruct StoreOverlay;
+
+/**
+ * Creates an overlay without any layers
+ *
+ * @result				the created overlay, must be freed with storeFreeOverlay
+ */
+LIBSTORE_API StoreOverlay *storeCreateOverlay();
+
+/**
+ * Frees an overlay together with its layers and merged maps
+ *
+ * @param overlay		the overlay to free
+ */
+LIBSTORE_API void storeFreeOverlay(StoreOverlay *overlay);
+
+/**
+ * Adds a layer on top of the existing layers of an overlay
+ *
+ * @param overlay		the overlay to add to
+ * @param layer			the store of the layer, or NULL for an empty layer, ownership is transferred to the overlay
+ *						unless adding fails. It must not be modified while it is part of the overlay.
+ * @result				the index of the added layer, counting from the bottom layer at zero, or -1 if the overlay
+ *						already has the maximum number of 64 layers
+ */
+LIBSTORE_API int storeOverlayPushLayer(StoreOverlay *overlay, Store *layer);
+
+/**
+ * Replaces the store of a layer of an overlay, freeing the previous one and discarding the merged maps it contributed to
+ *
+ * @param overlay		the overlay to modify
+ * @param index			the index of the layer to replace
+ * @param layer			the new store of the layer, or NULL for an empty layer, ownership is transferred to the overlay
+ *						unless replacing fails. It must not be modified while it is part of the overlay.
+ * @result				true if the layer was replaced, false if there is no layer at the index
+ */
+LIBSTORE_API bool storeOverlaySetLayer(StoreOverlay *overlay, int index, Store *layer);
+
+/**
+ * Returns the store of a layer of an overlay
+ *
+ * @param overlay		the overlay to query
+ * @param index			the index of the layer
+ * @result				the store of the layer, owned by the overlay, or NULL if the layer is empty or doesn't exist
+ */
+LIBSTORE_API Store *storeOverlayGetLayer(StoreOverlay *overlay, int index);
+
+/**
+ * Returns the number of layers of an overlay
+ *
+ * @param overlay		the overlay to query
+ * @result				the number of layers
+ */
+LIBSTORE_API int storeOverlayGetNumLayers(StoreOverlay *overlay);
+
+/**
+ * Looks up the value at a path in the merged view of an overlay, see storeGetPath. A returned merged map is flattened
+ * completely, so it can be used like any other store, but the order of its entries is unspecified.
+ *
+ * @param overlay		the overlay to query
+ * @param path			the compiled path to look up, an empty path returns the whole merged view
+ * @result				the value at the path, owned by the overlay and valid until one of its layers changes or it is
+ *						freed, must not be modified, or NULL if there is no such value
+ */
+LIBSTORE_API Store *storeOverlayGetPath(StoreOverlay *overlay, StorePath *path);
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef LIBSTORE_PARSER_H
 #define LIBSTORE_PARSER_H
 
+#include <store/spans.h>
 #include <store/store.h>
 
 typedef struct {
@@ -23,15 +24,50 @@ typedef struct StoreParseStateStruct {
 	int depth;
 	/** list of (StoreParseReport *) */
 	GQueue *reports;
+	/** The table to record the spans of parsed stores into, or NULL */
+	StoreSpanTable *spans;
 } StoreParseState;
 
+typedef enum {
+	/** Packs lists whose elements are all ints or all floats into arrays, see storeListPack */
+	STORE_PARSE_PACK_LISTS = 1,
+	/** Shares identical subtrees between their occurrences, see storeDeduplicate */
+	STORE_PARSE_DEDUPLICATE = 2,
+	/** Retains the source span of every parsed store in the parser's span table, which allows re-parsing edits incrementally, see storeReparse */
+	STORE_PARSE_SPANS = 4
+} StoreParseFlag;
+
 typedef struct {
 	StoreParseState state;
+	/** bitwise or of StoreParseFlag values */
+	int flags;
+	/** The spans of the stores of the last parse if parsing with STORE_PARSE_SPANS, see storeSpanTableLookup, or NULL */
+	StoreSpanTable *spans;
 } StoreParser;
 
 StoreParser *storeCreateParser();
 void storeResetParser(StoreParser *parser);
 void storeFreeParser(StoreParser *parser);
+void storeSetParserFlags(StoreParser *parser, int flags);
 Store *storeParse(StoreParser *parser, const char *input);
 
+/**
+ * Updates a store after an edit of the input it was parsed from by the same parser with STORE_PARSE_SPANS, re-parsing
+ * only the innermost list or map enclosing the edited bytes and splicing it into the store in place. The spans of the
+ * parser are updated accordingly, so that further edits can be re-parsed incrementally as well. If no list or map
+ * within the store encloses the edit, or the enclosing one can't be modified because it is frozen or shared, the whole
+ * input is parsed again instead.
+ *
+ * @param parser			the parser that parsed the store
+ * @param store				the store to update
+ * @param input				the whole edited input
+ * @param editStart			the byte offset at which the edit starts
+ * @param removedLength		the number of bytes the edit removed from the previous input
+ * @param insertedLength	the number of bytes the edit inserted in their place
+ * @result					the updated store, which is either the store modified in place or a newly parsed store in
+ *							which case the previous one was freed, or NULL if the edited input doesn't parse, in which
+ *							case the store is left unchanged
+ */
+Store *storeReparse(StoreParser *parser, Store *store, const char *input, int editStart, int removedLength, int insertedLength);
+
 #endif
@@ -0,0 +1,158 @@
+#ifndef LIBSTORE_PATH_H
+#define LIBSTORE_PATH_H
+
+#include <stdbool.h> // bool
+
+#include <store/api.h>
+#include <store/map.h>
+#include <store/store.h>
+
+/**
+ * Opaque struct representing a compiled path query such as "servers[3].tls.cert" or "items[*].id"
+ */
+typedef struct StorePathStruct StorePath;
+
+/**
+ * Opaque struct to iterate over all values matched by a path
+ */
+typedef struct StorePathIteratorStruct StorePathIterator;
+
+/**
+ * Compiles a path query, splitting it into segments and precomputing the hashes of its keys.
+ * Keys are separated by '.', list indices are given in square brackets, and '*' or '[*]' match every child.
+ * Keys containing special characters can be quoted in square brackets, e.g. 'hosts["example.com"].port'.
+ * A compiled path can be reused for any number of queries.
+ *
+ * @param pathString	the path query to compile
+ * @result				the compiled path, must be freed with storeFreePath, or NULL if the path is malformed
+ */
+LIBSTORE_API StorePath *storeCompilePath(const char *pathString);
+
+/**
+ * Frees a compiled path
+ *
+ * @param path			the path to free
+ */
+LIBSTORE_API void storeFreePath(StorePath *path);
+
+/**
+ * Looks up the value at a path in a store. If the path contains wildcards, the first match is returned.
+ * Elements of packed arrays are returned in a buffer of the path that is overwritten by the next lookup,
+ * so a path that selects such elements must not be used by multiple threads at once.
+ *
+ * @param store			the store to query
+ * @param path			the compiled path to look up
+ * @result				the value at the path, or NULL if there is no such value
+ */
+LIBSTORE_API Store *storeGetPath(Store *store, StorePath *path);
+
+/**
+ * Returns the number of segments of a compiled path
+ *
+ * @param path			the path to query
+ * @result				the number of segments
+ */
+LIBSTORE_NO_EXPORT int storePathGetNumSegments(StorePath *path);
+
+/**
+ * Returns whether a compiled path contains a wildcard segment
+ *
+ * @param path			the path to query
+ * @result				true if the path contains a wildcard
+ */
+LIBSTORE_NO_EXPORT bool storePathHasWildcard(StorePath *path);
+
+/**
+ * Returns the key of a key segment of a compiled path
+ *
+ * @param path			the path to query
+ * @param segment		the position of the segment
+ * @result				the key selected by the segment, owned by the path, or NULL if it is not a key segment
+ */
+LIBSTORE_NO_EXPORT StoreKey *storePathGetKey(StorePath *path, int segment);
+
+/**
+ * Looks up the value at the remaining segments of a path without wildcards, starting at a given segment
+ *
+ * @param store			the store to query, reached by the segments before the first one
+ * @param path			the compiled path to look up, must not contain wildcards
+ * @param firstSegment	the position of the first segment to select
+ * @result				the value at the path, or NULL if there is no such value
+ */
+LIBSTORE_NO_EXPORT Store *storeGetPathFrom(Store *store, StorePath *path, int firstSegment);
+
+/**
+ * Creates a new version of a store in which the value at a path is replaced, leaving the store itself unchanged.
+ * Only the stores along the path are copied, while every other subtree is shared between both versions, see
+ * storeRetain, so keeping many versions of a store costs memory proportional to their changes. If the last segment
+ * of the path is a key missing from its map, the entry is inserted.
+ *
+ * @param store			the store to update
+ * @param path			the compiled path of the value to replace, must not contain wildcards
+ * @param value			the new value, ownership is transferred to the new version unless the update fails
+ * @result				the new version of the store, must be freed with storeFree, or NULL if the path leads neither to
+ *						an existing value nor to a missing key of an existing map, or the value doesn't fit a packed array
+ */
+LIBSTORE_API Store *storeWith(Store *store, StorePath *path, Store *value);
+
+/**
+ * Replaces the value at a path in place. If the last segment of the path is a key missing from its map, the entry is
+ * inserted. An empty path replaces the content of the store itself, see storeReplaceContent.
+ *
+ * @param store			the store to modify
+ * @param path			the compiled path of the value to replace, must not contain wildcards
+ * @param value			the new value, ownership is transferred to the store unless the update fails
+ * @result				true if the value was replaced, false if the path leads neither to an existing value nor to a
+ *						missing key of an existing map, the store or any store along the path is frozen or shared, or
+ *						the value doesn't fit a packed array
+ */
+LIBSTORE_API bool storeSetPath(Store *store, StorePath *path, Store *value);
+
+/**
+ * Inserts a value at a path in place, either as a new entry of a map or as a new element of a generic list
+ *
+ * @param store			the store to modify
+ * @param path			the compiled path to insert at, whose last segment is a key missing from its map or an index
+ *						between 0 and the length of its list, must not contain wildcards
+ * @param value			the value to insert, ownership is transferred to the store unless the insertion fails
+ * @result				true if the value was inserted, false if the path doesn't lead to a position to insert at or
+ *						any store along the path is frozen or shared
+ */
+LIBSTORE_API bool storeInsertPath(Store *store, StorePath *path, Store *value);
+
+/**
+ * Removes and frees the value at a path in place, which is an entry of a map or an element of a generic list
+ *
+ * @param store			the store to modify
+ * @param path			the compiled path of the value to remove, must not contain wildcards
+ * @result				true if the value was removed, false if there is no such value or any store along the path is
+ *						frozen or shared
+ */
+LIBSTORE_API bool storeRemovePath(Store *store, StorePath *path);
+
+/**
+ * Creates an iterator over all values matched by a path, in document order
+ *
+ * @param store			the store to query, must not be modified while iterating
+ * @param path			the compiled path to match, must outlive the iterator
+ * @result				the created iterator, must be freed with storeFreePathIterator
+ */
+LIBSTORE_API StorePathIterator *storeCreatePathIterator(Store *store, StorePath *path);
+
+/**
+ * Advances a path iterator to the next matched value
+ *
+ * @param iterator		the iterator to advance
+ * @result				the next matched value, or NULL if there are no further matches. Elements of packed arrays are
+ *						returned in a buffer of the iterator that is only valid until the next call.
+ */
+LIBSTORE_API Store *storePathIteratorNext(StorePathIterator *iterator);
+
+/**
+ * Frees a path iterator
+ *
+ * @param iterator		the iterator to free
+ */
+LIBSTORE_API void storeFreePathIterator(StorePathIterator *iterator);
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef LIBSTORE_READER_H
+#define LIBSTORE_READER_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+
+#include <store/api.h>
+
+/**
+ * Opaque struct reading the tokens of a store input one at a time, so that consumers control the iteration, can skip
+ * subtrees they aren't interested in and can stop early without building any stores. The tokens follow the grammar of
+ * storeParse: an input that consists of entries is read as a map. A reader must only be used by one thread at a time.
+ */
+typedef struct StoreReaderStruct StoreReader;
+
+/**
+ * Enumeration of the token types yielded by a reader
+ */
+typedef enum {
+	/** The beginning of a map, followed by alternating keys and values until the end of the map */
+	STORE_TOKEN_MAP_BEGIN,
+	/** The end of a map */
+	STORE_TOKEN_MAP_END,
+	/** The key of a map entry, followed by the tokens of its value */
+	STORE_TOKEN_KEY,
+	/** The beginning of a list, followed by the tokens of its elements until the end of the list */
+	STORE_TOKEN_LIST_BEGIN,
+	/** The end of a list */
+	STORE_TOKEN_LIST_END,
+	/** An integer value */
+	STORE_TOKEN_INT,
+	/** A floating point number value */
+	STORE_TOKEN_FLOAT,
+	/** A string value */
+	STORE_TOKEN_STRING
+} StoreTokenType;
+
+/**
+ * Struct holding a token yielded by a reader
+ */
+typedef struct {
+	StoreTokenType type;
+	/** The byte offset of the token within the input */
+	size_t offset;
+	/** The characters of a key or string within the input, excluding the delimiters of a long string, or NULL */
+	const char *string;
+	/** The number of characters of a key or string */
+	size_t length;
+	/** Whether the characters of a key or string contain escape sequences, see storeCopyTokenString */
+	bool escaped;
+	/** The value of an int token */
+	int intValue;
+	/** The value of a float token */
+	double floatValue;
+} StoreToken;
+
+/**
+ * Creates a reader of an input. The input isn't copied and must stay valid until the reader is freed.
+ *
+ * @param data			the input to read, which doesn't have to be null terminated
+ * @param length		the number of bytes of the input, a null character before the end makes the input invalid
+ * @result				the created reader, must be freed with storeFreeReader
+ */
+LIBSTORE_API StoreReader *storeCreateReader(const char *data, size_t length);
+
+/**
+ * Frees a reader
+ *
+ * @param reader		the reader to free
+ */
+LIBSTORE_API void storeFreeReader(StoreReader *reader);
+
+/**
+ * Reads the next token of the input. Malformed input is detected as soon as it is reached, so tokens read before may
+ * belong to an input that turns out to be invalid, see storeReaderHasFailed.
+ *
+ * @param reader		the reader to read with
+ * @param token			pointer to the token to fill, whose string points into the input
+ * @result				true if a token was read, false if the input ended or is malformed
+ */
+LIBSTORE_API bool storeReaderNext(StoreReader *reader, StoreToken *token);
+
+/**
+ * Skips the value the next token would begin without reading its tokens. If the reader is positioned before the key of
+ * an entry, the whole entry is skipped. The contents of a skipped list or map are only checked for balanced brackets
+ * and terminated long strings, so that skipping is much faster than reading them, but malformed contents that are
+ * balanced aren't detected.
+ *
+ * @param reader		the reader to skip with
+ * @result				true if a value was skipped, false if the enclosing list or map or the input ended, or the
+ *						input is malformed
+ */
+LIBSTORE_API bool storeReaderSkipValue(StoreReader *reader);
+
+/**
+ * Returns whether a reader stopped because its input is malformed
+ *
+ * @param reader		the reader to query
+ * @param errorOffset	pointer to be set to the byte offset of the malformed input if reading failed, or NULL
+ * @result				true if reading failed
+ */
+LIBSTORE_API bool storeReaderHasFailed(StoreReader *reader, size_t *errorOffset);
+
+/**
+ * Copies the characters of a key or string token, resolving the escape sequences of long strings
+ *
+ * @param token			the key or string token to copy
+ * @result				the null terminated characters, must be freed with free
+ */
+LIBSTORE_API char *storeCopyTokenString(const StoreToken *token);
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef LIBSTORE_SNAPSHOT_H
+#define LIBSTORE_SNAPSHOT_H
+
+#include <stdbool.h> // bool
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Opaque struct publishing a store to concurrent readers, which can be swapped out for a new store at any time.
+ * Replaced stores are freed once no reader can still be reading them, detected through the epochs announced by the
+ * readers, so readers neither lock nor modify any shared counter.
+ */
+typedef struct StorePublisherStruct StorePublisher;
+
+/**
+ * Opaque struct representing a thread reading from a publisher
+ */
+typedef struct StoreSnapshotReaderStruct StoreSnapshotReader;
+
+/**
+ * Opaque struct representing a reference counted handle to a published store, which keeps it alive after it was
+ * replaced for as long as the handle is held
+ */
+typedef struct StoreSnapshotStruct StoreSnapshot;
+
+/**
+ * Creates a publisher
+ *
+ * @param store			the store to publish initially, ownership is transferred to the publisher, see storePublish
+ * @param deferFree		if true, replaced stores are only freed by storePublisherReclaim, e.g. on a background thread,
+ *						instead of by whichever thread drops the last reference to them
+ * @result				the created publisher, must be freed with storeFreePublisher
+ */
+LIBSTORE_API StorePublisher *storeCreatePublisher(Store *store, bool deferFree);
+
+/**
+ * Frees a publisher together with all stores published by it. All readers must have been unregistered and all
+ * snapshots released before.
+ *
+ * @param publisher		the publisher to free
+ */
+LIBSTORE_API void storeFreePublisher(StorePublisher *publisher);
+
+/**
+ * Publishes a store, replacing the previously published one. The store is frozen first, see storeFreeze, and must not
+ * be modified afterwards. Concurrent calls are serialized.
+ *
+ * @param publisher		the publisher to publish with
+ * @param store			the store to publish, ownership is transferred to the publisher
+ */
+LIBSTORE_API void storePublish(StorePublisher *publisher, Store *store);
+
+/**
+ * Frees the replaced stores that no reader can still be reading and no snapshot references anymore
+ *
+ * @param publisher		the publisher to reclaim the stores of
+ * @result				the number of stores freed
+ */
+LIBSTORE_API int storePublisherReclaim(StorePublisher *publisher);
+
+/**
+ * Registers a reader with a publisher. Each reader must only be used by one thread at a time.
+ *
+ * @param publisher		the publisher to read from
+ * @result				the registered reader, must be unregistered with storeUnregisterSnapshotReader
+ */
+LIBSTORE_API StoreSnapshotReader *storeRegisterSnapshotReader(StorePublisher *publisher);
+
+/**
+ * Unregisters and frees a reader, which must not be inside a read section
+ *
+ * @param reader		the reader to unregister
+ */
+LIBSTORE_API void storeUnregisterSnapshotReader(StoreSnapshotReader *reader);
+
+/**
+ * Begins a read section, in which the currently published store remains valid even if it is replaced.
+ * This takes no locks and performs no atomic read-modify-write operations.
+ *
+ * @param reader		the reader beginning the read section, must not be inside one already
+ * @result				the currently published store, valid until storeReadEnd
+ */
+LIBSTORE_API Store *storeReadBegin(StoreSnapshotReader *reader);
+
+/**
+ * Ends a read section, after which the store returned by storeReadBegin must no longer be used
+ *
+ * @param reader		the reader ending its read section
+ */
+LIBSTORE_API void storeReadEnd(StoreSnapshotReader *reader);
+
+/**
+ * Acquires a handle to the currently published store, which keeps it alive across read sections and threads
+ *
+ * @param reader		the reader to acquire the snapshot with, must not be inside a read section
+ * @result				the acquired snapshot, must be released with storeReleaseSnapshot
+ */
+LIBSTORE_API StoreSnapshot *storeAcquireSnapshot(StoreSnapshotReader *reader);
+
+/**
+ * Releases a snapshot handle, freeing its store if it was replaced and this was its last reference
+ *
+ * @param snapshot		the snapshot to release
+ */
+LIBSTORE_API void storeReleaseSnapshot(StoreSnapshot *snapshot);
+
+/**
+ * Returns the store of a snapshot handle
+ *
+ * @param snapshot		the snapshot to query
+ * @result				the snapshot's store, valid until the snapshot is released
+ */
+LIBSTORE_API Store *storeSnapshotGetStore(StoreSnapshot *snapshot);
+
+#endif
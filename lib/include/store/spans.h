@@ -0,0 +1,96 @@
+#ifndef LIBSTORE_SPANS_H
+#define LIBSTORE_SPANS_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Struct holding the source span of a parsed store
+ */
+typedef struct {
+	/** The byte offset of the store's first character */
+	int start;
+	/** The byte offset after the store's last character */
+	int end;
+} StoreSpan;
+
+/**
+ * Opaque struct mapping stores to their source spans, see STORE_PARSE_SPANS. The table is kept apart from the stores
+ * so that only parses requesting spans pay for them, and packs the stores and their offsets into parallel arrays that
+ * are indexed by hashing the addresses of the stores, so a span is looked up in constant expected time.
+ */
+typedef struct StoreSpanTableStruct StoreSpanTable;
+
+/**
+ * Creates an empty span table
+ *
+ * @result				the created span table, must be freed with storeFreeSpanTable
+ */
+LIBSTORE_NO_EXPORT StoreSpanTable *storeCreateSpanTable();
+
+/**
+ * Frees a span table
+ *
+ * @param table			the span table to free
+ */
+LIBSTORE_NO_EXPORT void storeFreeSpanTable(StoreSpanTable *table);
+
+/**
+ * Sets the span of a store, replacing any previous span of a store at the same address
+ *
+ * @param table			the span table to modify
+ * @param store			the store to set the span of
+ * @param start			the byte offset of the store's first character
+ * @param end			the byte offset after the store's last character
+ */
+LIBSTORE_NO_EXPORT void storeSpanTableSet(StoreSpanTable *table, Store *store, int start, int end);
+
+/**
+ * Removes the span of a store
+ *
+ * @param table			the span table to modify
+ * @param store			the store to remove the span of
+ */
+LIBSTORE_NO_EXPORT void storeSpanTableRemove(StoreSpanTable *table, Store *store);
+
+/**
+ * Shifts the spans after an edited position, moving every start and end offset beyond it. The shift is only recorded
+ * and applied once the spans are looked up, so it takes constant time except for every few shifts, which are applied
+ * to all spans at once.
+ *
+ * @param table			the span table to modify
+ * @param position		the offset of the edit, offsets up to which are unchanged
+ * @param delta			the number of bytes to move the offsets beyond the position by
+ */
+LIBSTORE_NO_EXPORT void storeSpanTableShift(StoreSpanTable *table, int position, int delta);
+
+/**
+ * Looks up the span of a store
+ *
+ * @param table			the span table to query, may be NULL
+ * @param store			the store to look up
+ * @param span			the span to fill in
+ * @result				true if the store has a span, false otherwise
+ */
+LIBSTORE_API bool storeSpanTableLookup(StoreSpanTable *table, Store *store, StoreSpan *span);
+
+/**
+ * Returns the number of spans in a span table
+ *
+ * @param table			the span table to query
+ * @result				the number of stores with a span
+ */
+LIBSTORE_API int storeSpanTableGetSize(StoreSpanTable *table);
+
+/**
+ * Returns the number of bytes allocated by a span table
+ *
+ * @param table			the span table to query
+ * @result				the allocated size of the table in bytes
+ */
+LIBSTORE_API size_t storeGetSpanTableMemorySize(StoreSpanTable *table);
+
+#endif
@@ -1,10 +1,23 @@
 #ifndef LIBSTORE_STORE_H
 #define LIBSTORE_STORE_H
 
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+
 #include <glib.h>
 
 #include <store/api.h>
 
+/**
+ * Opaque struct holding the entries of a map store, see store/map.h
+ */
+typedef struct StoreMapStruct StoreMap;
+
+/**
+ * Opaque struct holding the columns of a table store, see store/table.h
+ */
+typedef struct StoreTableStruct StoreTable;
+
 /**
  * Enumeration of the store value types
  */
@@ -18,14 +31,34 @@ typedef enum {
 	/** A list value */
 	STORE_LIST,
 	/** A map value */
-	STORE_MAP
+	STORE_MAP,
+	/** A list of ints packed into an array, see store/list.h */
+	STORE_INT_ARRAY,
+	/** A list of floating point numbers packed into an array, see store/list.h */
+	STORE_FLOAT_ARRAY,
+	/** A list of maps stored column by column, see store/table.h */
+	STORE_TABLE
 } StoreType;
 
+/**
+ * Struct holding the elements of a packed numeric list store
+ */
+typedef struct {
+	/** The number of elements in the array */
+	int length;
+	/** The packed elements of an int array, or NULL for a float array */
+	int *intValues;
+	/** The packed elements of a float array, or NULL for an int array */
+	double *floatValues;
+	/** Whether the array was frozen and rejects modifications, see storeFreeze */
+	bool frozen;
+} StoreArray;
+
 /**
  * Union to store a node value's content
  */
 typedef union {
-	/** A string value */
+	/** A string value, usually allocated together with the store by storeCreateStringValue */
 	char *stringValue;
 	/** An integer value */
 	int intValue;
@@ -34,7 +67,11 @@ typedef union {
 	/** A list value */
 	GQueue *listValue;
 	/** An map value */
-	GHashTable *mapValue;
+	StoreMap *mapValue;
+	/** A packed int or float array value */
+	StoreArray *arrayValue;
+	/** A table value */
+	StoreTable *tableValue;
 } StoreContent;
 
 /**
@@ -43,18 +80,29 @@ typedef union {
 typedef struct Store {
 	/** The store's type */
 	StoreType type;
+	/** The number of owners sharing the store, see storeRetain. Shared stores must not be modified. */
+	unsigned int references;
 	/** The store's content */
 	StoreContent content;
 } Store;
 
 /**
- * Creates a string store
+ * Creates a string store, whose characters are allocated together with it
  *
- * @param stringValue	the content string
+ * @param stringValue	the content string, will be copied
  * @result				the created store, must be freed with StoreFree
  */
 LIBSTORE_API Store *storeCreateStringValue(const char *stringValue);
 
+/**
+ * Creates a string store from a string of known length
+ *
+ * @param stringValue	the content string, will be copied
+ * @param length		the number of characters of the content string
+ * @result				the created store, must be freed with StoreFree
+ */
+LIBSTORE_API Store *storeCreateStringValueLength(const char *stringValue, int length);
+
 /**
  * Creates an int store
  *
@@ -78,6 +126,24 @@ LIBSTORE_API Store *storeCreateFloatValue(double floatValue);
  */
 LIBSTORE_API Store *storeCreateListValue();
 
+/**
+ * Creates a packed int array store
+ *
+ * @param intValues		the content ints, will be copied
+ * @param length		the number of content ints
+ * @result				the created store, must be freed with StoreFree
+ */
+LIBSTORE_API Store *storeCreateIntArrayValue(const int *intValues, int length);
+
+/**
+ * Creates a packed float array store
+ *
+ * @param floatValues	the content floats, will be copied
+ * @param length		the number of content floats
+ * @result				the created store, must be freed with StoreFree
+ */
+LIBSTORE_API Store *storeCreateFloatArrayValue(const double *floatValues, int length);
+
 /**
  * Creates an empty map store
  *
@@ -85,6 +151,32 @@ LIBSTORE_API Store *storeCreateListValue();
  */
 LIBSTORE_API Store *storeCreateMapValue();
 
+/**
+ * Returns the length of the content string of a string store, in constant time
+ *
+ * @param store			the string store to query
+ * @result				the length of the string, or -1 if the store is not a string
+ */
+LIBSTORE_API int storeGetStringLength(Store *store);
+
+/**
+ * Returns the number of bytes allocated for a store and all of its descendants. Subtrees shared within the store are
+ * counted once, see storeRetain, so the result is the memory that freeing the store's last owner releases unless its
+ * subtrees are also shared with other stores.
+ *
+ * @param store			the store to measure
+ * @result				the size of the store in bytes
+ */
+LIBSTORE_API size_t storeGetMemorySize(Store *store);
+
+/**
+ * Returns the number of bytes allocated for a store node itself, excluding its children
+ *
+ * @param store			the store to measure
+ * @result				the size of the store node in bytes
+ */
+LIBSTORE_NO_EXPORT size_t storeGetNodeMemorySize(Store *store);
+
 /**
  * Returns the type name of a store
  *
@@ -94,7 +186,62 @@ LIBSTORE_API Store *storeCreateMapValue();
 LIBSTORE_API const char *storeGetTypeName(Store *store);
 
 /**
- * Frees a store
+ * Freezes a store and all of its descendants for read-mostly use. Every map is rebuilt into an immutable table
+ * indexed by a perfect hash with its keys packed contiguously, and further insertions into or removals from
+ * any map or list fail, as does replacing the elements of packed arrays or any value below a frozen store.
+ * Since lookups in a frozen tree don't modify it, a frozen store can be read from multiple threads concurrently.
+ *
+ * @param store		the store to freeze
+ */
+LIBSTORE_API void storeFreeze(Store *store);
+
+/**
+ * Function to copy the child of a store that is being copied
+ *
+ * @param store		the child to copy
+ * @param userData	the user data passed to storeCopyNode
+ * @result			the copy of the child, which is transferred to the copied store
+ */
+typedef Store *(*StoreCopyFunction)(Store *store, void *userData);
+
+/**
+ * Copies a store, using a function to copy each of its children
+ *
+ * @param store		the store to copy
+ * @param copyChild	the function to copy the children with, called in iteration order
+ * @param userData	the user data to pass to the function
+ * @result			the modifiable copy, must be freed with storeFree, or NULL if the store is a table
+ */
+LIBSTORE_NO_EXPORT Store *storeCopyNode(Store *store, StoreCopyFunction copyChild, void *userData);
+
+/**
+ * Copies a store without its descendants, which are shared between the store and its copy instead, see storeRetain
+ *
+ * @param store		the store to copy
+ * @result			the modifiable copy, must be freed with storeFree, or NULL if the store is a table
+ */
+LIBSTORE_NO_EXPORT Store *storeCopyShallow(Store *store);
+
+/**
+ * Replaces the content of a store in place, so that pointers to the store see the new value
+ *
+ * @param store		the store whose content to free and replace, must not be shared
+ * @param value		the store to move the content from, must not be shared, ownership is transferred
+ */
+LIBSTORE_NO_EXPORT void storeReplaceContent(Store *store, Store *value);
+
+/**
+ * Adds an owner to a store, which is then shared between its owners until all but one of them have freed it.
+ * Modifications of a shared store, such as map insertions or list removals, fail since they would be visible to
+ * every owner. The descendants of a shared store must not be modified either.
+ *
+ * @param store		the store to retain
+ * @result			the retained store
+ */
+LIBSTORE_API Store *storeRetain(Store *store);
+
+/**
+ * Frees a store, or only releases one owner's reference to it if the store is shared, see storeRetain
  *
  * @param store		the store to free
  */
@@ -0,0 +1,115 @@
+#ifndef LIBSTORE_SYNTAX_H
+#define LIBSTORE_SYNTAX_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+#include <stdint.h> // uint32_t
+
+#include <store/api.h>
+
+/**
+ * The maximum depth of nested parse states at which lists and maps are still parsed. Each nested list or map is parsed
+ * at least three parse states deeper than the one enclosing it, see storeParse.
+ */
+#define STORE_MAX_PARSE_DEPTH 1000
+
+/**
+ * Returns whether a character is skipped before a terminal, i.e. whether it is whitespace, ',' or ';'
+ *
+ * @param c				the character to check
+ * @result				true if the character is skipped
+ */
+LIBSTORE_NO_EXPORT bool storeIsTerminalCharacter(char c);
+
+/**
+ * Returns whether a character ends a short string and therefore must follow every value
+ *
+ * @param c				the character to check
+ * @result				true if the character is a separator, which includes the null character
+ */
+LIBSTORE_NO_EXPORT bool storeIsSeparatorCharacter(char c);
+
+/**
+ * Returns the value of a hexadecimal digit
+ *
+ * @param c				the character to convert
+ * @result				the value of the digit, or -1 if the character isn't one
+ */
+LIBSTORE_NO_EXPORT int storeGetHexValue(char c);
+
+/**
+ * Returns the character at a position of an input, or a null character past its end like for a null terminated input
+ *
+ * @param data			the input to read from
+ * @param length		the number of bytes of the input
+ * @param position		the position to read at
+ * @result				the character at the position
+ */
+LIBSTORE_NO_EXPORT char storePeekCharacter(const char *data, size_t length, size_t position);
+
+/**
+ * Skips the characters before a terminal, see storeIsTerminalCharacter
+ *
+ * @param data			the input to scan
+ * @param length		the number of bytes of the input
+ * @param position		the position to start at
+ * @result				the position of the first character that isn't skipped, or the length of the input
+ */
+LIBSTORE_NO_EXPORT size_t storeSkipTerminalCharacters(const char *data, size_t length, size_t position);
+
+/**
+ * Scans a short string, i.e. one or more characters up to the next separator
+ *
+ * @param data			the input to scan
+ * @param length		the number of bytes of the input
+ * @param position		pointer to the position of the string, which is advanced past it if it isn't empty
+ * @result				true if a non-empty short string was scanned
+ */
+LIBSTORE_NO_EXPORT bool storeScanShortString(const char *data, size_t length, size_t *position);
+
+/**
+ * Scans an int, i.e. an optional minus sign followed by one or more digits
+ *
+ * @param data			the input to scan
+ * @param length		the number of bytes of the input
+ * @param position		the position to start at
+ * @result				the position after the int, or the start position if there is none
+ */
+LIBSTORE_NO_EXPORT size_t storeScanInt(const char *data, size_t length, size_t position);
+
+/**
+ * Scans a float, i.e. an int followed by an optional fractional part consisting of a dot and any number of digits, and
+ * an optional exponential part consisting of 'e' or 'E', an optional sign and one or more digits
+ *
+ * @param data			the input to scan
+ * @param length		the number of bytes of the input
+ * @param position		the position to start at
+ * @result				the position after the float, or the start position if there is none
+ */
+LIBSTORE_NO_EXPORT size_t storeScanFloat(const char *data, size_t length, size_t position);
+
+/**
+ * Scans an escape sequence of a long string, rejecting escaped surrogate code points like storeConvertUnicodeToUtf8
+ *
+ * @param data			the input to scan
+ * @param length		the number of bytes of the input
+ * @param position		pointer to the position of the backslash, which is advanced past the escape sequence on success
+ *						or set to the position of the error on failure
+ * @param codepoint		pointer to be set to the code point of the escaped character
+ * @result				true if a valid escape sequence was scanned
+ */
+LIBSTORE_NO_EXPORT bool storeScanEscapeSequence(const char *data, size_t length, size_t *position, uint32_t *codepoint);
+
+/**
+ * Scans a long string including its delimiters and checks its escape sequences, see storeScanEscapeSequence
+ *
+ * @param data			the input to scan
+ * @param length		the number of bytes of the input
+ * @param position		pointer to the position of the opening delimiter, which is advanced past the closing one on
+ *						success or set to the position of the error on failure
+ * @param escaped		pointer to be set to whether the string contains escape sequences, or NULL
+ * @result				true if a long string was scanned
+ */
+LIBSTORE_NO_EXPORT bool storeScanLongString(const char *data, size_t length, size_t *position, bool *escaped);
+
+#endif
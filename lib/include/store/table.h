@@ -0,0 +1,153 @@
+#ifndef LIBSTORE_TABLE_H
+#define LIBSTORE_TABLE_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Enumeration of the value types of a table column
+ */
+typedef enum {
+	/** A column of ints packed into an array */
+	STORE_COLUMN_INT,
+	/** A column of floating point numbers packed into an array, into which ints are converted */
+	STORE_COLUMN_FLOAT,
+	/** A column of strings */
+	STORE_COLUMN_STRING,
+	/** Not a column, returned when querying a column that doesn't exist */
+	STORE_COLUMN_INVALID
+} StoreColumnType;
+
+/**
+ * Predicate to filter the rows of a table by the value of a column
+ *
+ * @param value			the value of the row in the column, only valid during the call
+ * @param userData		the user data passed to the filter
+ * @result				true if the row matches
+ */
+typedef bool (*StoreTablePredicate)(Store *value, void *userData);
+
+/**
+ * Frees a table together with all of its columns
+ *
+ * @param table			the table to free
+ */
+LIBSTORE_NO_EXPORT void storeFreeTable(StoreTable *table);
+
+/**
+ * Returns the number of bytes allocated for a table's columns and their values
+ *
+ * @param table			the table to measure
+ * @result				the size of the table in bytes
+ */
+LIBSTORE_NO_EXPORT size_t storeGetTableMemorySize(StoreTable *table);
+
+/**
+ * Converts a list of maps into a table store holding one packed array per key, in order of first appearance.
+ * Rows missing a key are marked as null in that key's column. Columns of ints and floats are converted to floats.
+ *
+ * @param store			the list store of maps to convert, which is left unchanged
+ * @result				the created table store, must be freed with storeFree, or NULL if the store is not a list
+ *						of maps or a key has values that are not all numbers or all strings
+ */
+LIBSTORE_API Store *storeToColumns(Store *store);
+
+/**
+ * Returns the number of rows of a table store
+ *
+ * @param store			the table store to query
+ * @result				the number of rows, or -1 if the store is not a table
+ */
+LIBSTORE_API int storeTableGetNumRows(Store *store);
+
+/**
+ * Returns the number of columns of a table store
+ *
+ * @param store			the table store to query
+ * @result				the number of columns, or -1 if the store is not a table
+ */
+LIBSTORE_API int storeTableGetNumColumns(Store *store);
+
+/**
+ * Finds a column of a table store by its key
+ *
+ * @param store			the table store to query
+ * @param name			the key of the column to find
+ * @result				the index of the column, or -1 if there is no such column or the store is not a table
+ */
+LIBSTORE_API int storeTableFindColumn(Store *store, const char *name);
+
+/**
+ * Returns the key of a table column
+ *
+ * @param store			the table store to query
+ * @param column		the index of the column
+ * @result				the key of the column, owned by the table, or NULL if there is no such column
+ */
+LIBSTORE_API const char *storeTableGetColumnName(Store *store, int column);
+
+/**
+ * Returns the value type of a table column
+ *
+ * @param store			the table store to query
+ * @param column		the index of the column
+ * @result				the type of the column, or STORE_COLUMN_INVALID if the store is not a table or there is no such
+ *						column
+ */
+LIBSTORE_API StoreColumnType storeTableGetColumnType(Store *store, int column);
+
+/**
+ * Returns whether a row is missing a value in a table column
+ *
+ * @param store			the table store to query
+ * @param column		the index of the column
+ * @param row			the index of the row
+ * @result				true if the value is null or the cell doesn't exist
+ */
+LIBSTORE_API bool storeTableIsNull(Store *store, int column, int row);
+
+/**
+ * Returns the packed values of an int column for direct scans, in which null rows hold 0
+ *
+ * @param store			the table store to query
+ * @param column		the index of the column
+ * @result				the array of storeTableGetNumRows values, or NULL if the column doesn't exist or isn't an int column
+ */
+LIBSTORE_API const int *storeTableGetIntColumn(Store *store, int column);
+
+/**
+ * Returns the packed values of a float column for direct scans, in which null rows hold 0
+ *
+ * @param store			the table store to query
+ * @param column		the index of the column
+ * @result				the array of storeTableGetNumRows values, or NULL if the column doesn't exist or isn't a float column
+ */
+LIBSTORE_API const double *storeTableGetFloatColumn(Store *store, int column);
+
+/**
+ * Reads a table cell into a caller provided store. The cell shares its content with the table and must not be freed.
+ *
+ * @param store			the table store to query
+ * @param column		the index of the column
+ * @param row			the index of the row
+ * @param value			the store to read the cell into
+ * @result				true if the cell was read, false if it is null or doesn't exist
+ */
+LIBSTORE_API bool storeTableGetValue(Store *store, int column, int row, Store *value);
+
+/**
+ * Scans a table column and collects the rows whose non-null values match a predicate
+ *
+ * @param store			the table store to scan
+ * @param column		the index of the column to scan
+ * @param predicate		the predicate to match values against
+ * @param userData		user data to pass to the predicate
+ * @param rows			array of at least storeTableGetNumRows entries that the matching row indices are written to
+ * @result				the number of matching rows, or -1 if the column doesn't exist
+ */
+LIBSTORE_API int storeTableFilter(Store *store, int column, StoreTablePredicate predicate, void *userData, int *rows);
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef LIBSTORE_VALIDATE_H
+#define LIBSTORE_VALIDATE_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+
+#include <store/api.h>
+
+/**
+ * Checks whether an input is a well-formed store without building it, e.g. to reject malformed documents before
+ * queueing them for parsing. The input is recognized with the grammar of storeParse, including its maximum nesting
+ * depth, so it is valid exactly if storeParse succeeds on it, but nothing is allocated and no reports are generated.
+ *
+ * @param data			the input to check, which doesn't have to be null terminated
+ * @param length		the number of bytes of the input, a null character before the end makes the input invalid
+ * @param errorOffset	pointer to be set to the byte offset of the furthest position up to which the input could be
+ *						recognized if it is invalid, or NULL
+ * @result				true if the input is valid
+ */
+LIBSTORE_API bool storeValidate(const char *data, size_t length, size_t *errorOffset);
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef LIBSTORE_WATCHER_H
+#define LIBSTORE_WATCHER_H
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Opaque struct watching a store file through inotify, which re-parses the file whenever it changes and notifies
+ * subscribers about the changes below the paths they subscribed to. A watcher must only be used by one thread at a time.
+ */
+typedef struct StoreWatcherStruct StoreWatcher;
+
+/**
+ * Function to notify a subscriber of a watcher about changes
+ *
+ * @param store			the newly parsed store, valid until the watcher processes the next change or is freed
+ * @param changes		the operations of the diff from the previous store that touch the subscribed path, see storeDiff,
+ *						valid for the duration of the call
+ * @param userData		the user data passed to storeWatcherSubscribe
+ */
+typedef void (*StoreWatchFunction)(Store *store, Store *changes, void *userData);
+
+/**
+ * Creates a watcher and parses the watched file for the first time. The directory of the file is watched, so that
+ * replacing the file by renaming another one over it is noticed as well.
+ *
+ * @param filename		the name of the store file to watch
+ * @param parseFlags	the flags to parse the file with, see StoreParseFlag
+ * @param debounce		the number of milliseconds without further changes to wait for before re-parsing a changed file
+ * @result				the created watcher, must be freed with storeFreeWatcher, or NULL if the file can't be watched,
+ *						read or parsed
+ */
+LIBSTORE_API StoreWatcher *storeCreateWatcher(const char *filename, int parseFlags, int debounce);
+
+/**
+ * Frees a watcher together with its current store
+ *
+ * @param watcher		the watcher to free
+ */
+LIBSTORE_API void storeFreeWatcher(StoreWatcher *watcher);
+
+/**
+ * Returns the store most recently parsed by a watcher
+ *
+ * @param watcher		the watcher to query
+ * @result				the current store, valid until the watcher processes the next change or is freed
+ */
+LIBSTORE_API Store *storeWatcherGetStore(StoreWatcher *watcher);
+
+/**
+ * Returns the file descriptor a watcher receives change events on, which becomes readable when the watched file
+ * changes, e.g. to wait for changes in an event loop before calling storeWatcherProcess
+ *
+ * @param watcher		the watcher to query
+ * @result				the inotify file descriptor of the watcher
+ */
+LIBSTORE_API int storeWatcherGetFd(StoreWatcher *watcher);
+
+/**
+ * Subscribes to the changes of a watched store at and below a path. A subscriber is also notified of changes to an
+ * ancestor of the path, such as replacing the whole store.
+ *
+ * @param watcher		the watcher to subscribe to
+ * @param pathPrefix	the path to subscribe to in the syntax of storeCompilePath, or an empty string for every change
+ * @param callback		the function to call with the changes
+ * @param userData		the user data to pass to the function
+ * @result				the identifier of the subscription
+ */
+LIBSTORE_API int storeWatcherSubscribe(StoreWatcher *watcher, const char *pathPrefix, StoreWatchFunction callback, void *userData);
+
+/**
+ * Cancels a subscription
+ *
+ * @param watcher		the watcher to unsubscribe from
+ * @param subscription	the identifier returned by storeWatcherSubscribe
+ */
+LIBSTORE_API void storeWatcherUnsubscribe(StoreWatcher *watcher, int subscription);
+
+/**
+ * Waits for the watched file to change, and once it does, waits until it stopped changing for the debounce time before
+ * re-parsing it, diffing it against the previous store and notifying the subscribers of the changes
+ *
+ * @param watcher		the watcher to process the changes of
+ * @param timeout		the maximum number of milliseconds to wait for a change, or -1 to wait indefinitely
+ * @result				the number of subscribers notified, or -1 if the changed file can't be read or parsed, in which
+ *						case the previous store is kept
+ */
+LIBSTORE_API int storeWatcherProcess(StoreWatcher *watcher, int timeout);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef LIBSTORE_WRITER_H
+#define LIBSTORE_WRITER_H
+
+#include <store/api.h>
+#include <store/store.h>
+
+/**
+ * Writes a store in the grammar accepted by storeParse, such that parsing the result yields an equal store, see
+ * storeEquals. Strings and keys are always quoted, packed arrays are written as lists and tables as lists of maps
+ * containing each row's present cells.
+ *
+ * @param store			the store to write
+ * @result				the written text, must be freed with free, or NULL if the store contains an infinite or NaN
+ *						float, which the grammar can't represent
+ */
+LIBSTORE_API char *storeWrite(Store *store);
+
+#endif
@@ -0,0 +1,497 @@
+#include <math.h> // NAN isnan
+#include <stdbool.h> // bool true false
+
+#include <glib.h>
+
+#include "store/aggregate.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define LIBSTORE_AGGREGATE_AVX2
+#define LIBSTORE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+/**
+ * Flags selecting which aggregations to compute over packed arrays
+ */
+static const int aggregateSum = 1;
+static const int aggregateMinMax = 2;
+
+typedef struct {
+	/** The number of numeric elements */
+	int count;
+	/** The sum of the numeric elements */
+	double sum;
+	/** The smallest numeric element, or NaN if any element is NaN, only valid if count is positive */
+	double min;
+	/** The largest numeric element, or NaN if any element is NaN, only valid if count is positive */
+	double max;
+} Aggregate;
+
+typedef struct {
+	/** The inclusive lower bound of the first bin */
+	double lower;
+	/** The exclusive upper bound of the last bin */
+	double upper;
+	/** The number of bins per unit */
+	double scale;
+	int numBins;
+	int *bins;
+} Histogram;
+
+static bool aggregateStore(Store *store, int aggregations, Aggregate *aggregate);
+static void aggregateGenericList(GQueue *list, Aggregate *aggregate);
+static void countValue(Histogram *histogram, double value);
+static long long sumInts(const int *values, int length);
+static double sumFloats(const double *values, int length);
+static void minMaxInts(const int *values, int length, int *min, int *max);
+static void minMaxFloats(const double *values, int length, double *min, double *max);
+static long long sumIntsScalar(const int *values, int length);
+static double sumFloatsScalar(const double *values, int length);
+static void minMaxIntsScalar(const int *values, int length, int *min, int *max);
+static void minMaxFloatsScalar(const double *values, int length, double *min, double *max);
+#ifdef LIBSTORE_AGGREGATE_AVX2
+static bool hasAvx2();
+LIBSTORE_TARGET_AVX2 static long long sumIntsAvx2(const int *values, int length);
+LIBSTORE_TARGET_AVX2 static double sumFloatsAvx2(const double *values, int length);
+LIBSTORE_TARGET_AVX2 static void minMaxIntsAvx2(const int *values, int length, int *min, int *max);
+LIBSTORE_TARGET_AVX2 static void minMaxFloatsAvx2(const double *values, int length, double *min, double *max);
+#endif
+
+int storeListCount(Store *store)
+{
+	Aggregate aggregate;
+	if(!aggregateStore(store, 0, &aggregate)) {
+		return -1;
+	}
+
+	return aggregate.count;
+}
+
+double storeListSum(Store *store)
+{
+	Aggregate aggregate;
+	if(!aggregateStore(store, aggregateSum, &aggregate)) {
+		return 0;
+	}
+
+	return aggregate.sum;
+}
+
+bool storeListMin(Store *store, double *min)
+{
+	Aggregate aggregate;
+	if(!aggregateStore(store, aggregateMinMax, &aggregate) || aggregate.count == 0) {
+		return false;
+	}
+
+	*min = aggregate.min;
+	return true;
+}
+
+bool storeListMax(Store *store, double *max)
+{
+	Aggregate aggregate;
+	if(!aggregateStore(store, aggregateMinMax, &aggregate) || aggregate.count == 0) {
+		return false;
+	}
+
+	*max = aggregate.max;
+	return true;
+}
+
+bool storeListMean(Store *store, double *mean)
+{
+	Aggregate aggregate;
+	if(!aggregateStore(store, aggregateSum, &aggregate) || aggregate.count == 0) {
+		return false;
+	}
+
+	*mean = aggregate.sum / aggregate.count;
+	return true;
+}
+
+bool storeListHistogram(Store *store, double lower, double upper, int numBins, int *bins)
+{
+	if(!(upper > lower) || numBins <= 0) {
+		return false;
+	}
+
+	Histogram histogram;
+	histogram.lower = lower;
+	histogram.upper = upper;
+	histogram.scale = numBins / (upper - lower);
+	histogram.numBins = numBins;
+	histogram.bins = bins;
+
+	switch(store->type) {
+		case STORE_INT_ARRAY:
+			for(int i = 0; i < store->content.arrayValue->length; i++) {
+				countValue(&histogram, store->content.arrayValue->intValues[i]);
+			}
+		break;
+		case STORE_FLOAT_ARRAY:
+			for(int i = 0; i < store->content.arrayValue->length; i++) {
+				countValue(&histogram, store->content.arrayValue->floatValues[i]);
+			}
+		break;
+		case STORE_LIST:
+			for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+				Store *element = (Store *) iter->data;
+				if(element->type == STORE_INT) {
+					countValue(&histogram, element->content.intValue);
+				} else if(element->type == STORE_FLOAT) {
+					countValue(&histogram, element->content.floatValue);
+				}
+			}
+		break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Computes aggregations over the numeric elements of a list store, dispatching packed arrays to vectorized kernels
+ *
+ * @param store			the list store to aggregate
+ * @param aggregations	bitwise or of the aggregations to compute for packed arrays, the count is always computed
+ * @param aggregate		the aggregate to fill in
+ * @result				true if the store is a list
+ */
+static bool aggregateStore(Store *store, int aggregations, Aggregate *aggregate)
+{
+	aggregate->count = 0;
+	aggregate->sum = 0;
+	aggregate->min = 0;
+	aggregate->max = 0;
+
+	switch(store->type) {
+		case STORE_INT_ARRAY:
+		{
+			StoreArray *array = store->content.arrayValue;
+			aggregate->count = array->length;
+
+			if(aggregations & aggregateSum) {
+				aggregate->sum = (double) sumInts(array->intValues, array->length);
+			}
+
+			if((aggregations & aggregateMinMax) && array->length > 0) {
+				int min;
+				int max;
+				minMaxInts(array->intValues, array->length, &min, &max);
+				aggregate->min = min;
+				aggregate->max = max;
+			}
+		}
+		break;
+		case STORE_FLOAT_ARRAY:
+		{
+			StoreArray *array = store->content.arrayValue;
+			aggregate->count = array->length;
+
+			if(aggregations & aggregateSum) {
+				aggregate->sum = sumFloats(array->floatValues, array->length);
+			}
+
+			if((aggregations & aggregateMinMax) && array->length > 0) {
+				minMaxFloats(array->floatValues, array->length, &aggregate->min, &aggregate->max);
+			}
+		}
+		break;
+		case STORE_LIST:
+			aggregateGenericList(store->content.listValue, aggregate);
+		break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Computes all aggregations in a single pass over a generic list, skipping non-numeric elements
+ */
+static void aggregateGenericList(GQueue *list, Aggregate *aggregate)
+{
+	for(GList *iter = list->head; iter != NULL; iter = iter->next) {
+		Store *element = (Store *) iter->data;
+
+		double value;
+		if(element->type == STORE_INT) {
+			value = element->content.intValue;
+		} else if(element->type == STORE_FLOAT) {
+			value = element->content.floatValue;
+		} else {
+			continue;
+		}
+
+		// a NaN is kept once found since no value compares less or greater than it
+		if(aggregate->count == 0 || value < aggregate->min || isnan(value)) {
+			aggregate->min = value;
+		}
+		if(aggregate->count == 0 || value > aggregate->max || isnan(value)) {
+			aggregate->max = value;
+		}
+		aggregate->sum += value;
+		aggregate->count++;
+	}
+}
+
+static void countValue(Histogram *histogram, double value)
+{
+	if(!(value >= histogram->lower && value < histogram->upper)) {
+		return;
+	}
+
+	int bin = (int) ((value - histogram->lower) * histogram->scale);
+
+	// rounding may push values just below the upper bound out of the last bin
+	if(bin >= histogram->numBins) {
+		bin = histogram->numBins - 1;
+	}
+
+	histogram->bins[bin]++;
+}
+
+static long long sumInts(const int *values, int length)
+{
+#ifdef LIBSTORE_AGGREGATE_AVX2
+	if(hasAvx2()) {
+		return sumIntsAvx2(values, length);
+	}
+#endif
+	return sumIntsScalar(values, length);
+}
+
+static double sumFloats(const double *values, int length)
+{
+#ifdef LIBSTORE_AGGREGATE_AVX2
+	if(hasAvx2()) {
+		return sumFloatsAvx2(values, length);
+	}
+#endif
+	return sumFloatsScalar(values, length);
+}
+
+static void minMaxInts(const int *values, int length, int *min, int *max)
+{
+#ifdef LIBSTORE_AGGREGATE_AVX2
+	if(hasAvx2()) {
+		minMaxIntsAvx2(values, length, min, max);
+		return;
+	}
+#endif
+	minMaxIntsScalar(values, length, min, max);
+}
+
+static void minMaxFloats(const double *values, int length, double *min, double *max)
+{
+#ifdef LIBSTORE_AGGREGATE_AVX2
+	if(hasAvx2()) {
+		minMaxFloatsAvx2(values, length, min, max);
+		return;
+	}
+#endif
+	minMaxFloatsScalar(values, length, min, max);
+}
+
+static long long sumIntsScalar(const int *values, int length)
+{
+	long long sum = 0;
+	for(int i = 0; i < length; i++) {
+		sum += values[i];
+	}
+
+	return sum;
+}
+
+static double sumFloatsScalar(const double *values, int length)
+{
+	double sum = 0;
+	for(int i = 0; i < length; i++) {
+		sum += values[i];
+	}
+
+	return sum;
+}
+
+static void minMaxIntsScalar(const int *values, int length, int *min, int *max)
+{
+	*min = values[0];
+	*max = values[0];
+	for(int i = 1; i < length; i++) {
+		if(values[i] < *min) {
+			*min = values[i];
+		}
+		if(values[i] > *max) {
+			*max = values[i];
+		}
+	}
+}
+
+/**
+ * Finds the smallest and largest of a non-empty array of floats, both of which are NaN if any of the floats is
+ */
+static void minMaxFloatsScalar(const double *values, int length, double *min, double *max)
+{
+	*min = values[0];
+	*max = values[0];
+	for(int i = 1; i < length; i++) {
+		if(values[i] < *min || isnan(values[i])) {
+			*min = values[i];
+		}
+		if(values[i] > *max || isnan(values[i])) {
+			*max = values[i];
+		}
+	}
+}
+
+#ifdef LIBSTORE_AGGREGATE_AVX2
+
+static bool hasAvx2()
+{
+	return __builtin_cpu_supports("avx2");
+}
+
+LIBSTORE_TARGET_AVX2 static long long sumIntsAvx2(const int *values, int length)
+{
+	// widen to 64 bit lanes so that the sum can't overflow
+	__m256i sum0 = _mm256_setzero_si256();
+	__m256i sum1 = _mm256_setzero_si256();
+
+	int i = 0;
+	for(; i + 8 <= length; i += 8) {
+		sum0 = _mm256_add_epi64(sum0, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *) (values + i))));
+		sum1 = _mm256_add_epi64(sum1, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *) (values + i + 4))));
+	}
+
+	long long lanes[4];
+	_mm256_storeu_si256((__m256i *) lanes, _mm256_add_epi64(sum0, sum1));
+
+	long long sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	for(; i < length; i++) {
+		sum += values[i];
+	}
+
+	return sum;
+}
+
+LIBSTORE_TARGET_AVX2 static double sumFloatsAvx2(const double *values, int length)
+{
+	__m256d sum0 = _mm256_setzero_pd();
+	__m256d sum1 = _mm256_setzero_pd();
+
+	int i = 0;
+	for(; i + 8 <= length; i += 8) {
+		sum0 = _mm256_add_pd(sum0, _mm256_loadu_pd(values + i));
+		sum1 = _mm256_add_pd(sum1, _mm256_loadu_pd(values + i + 4));
+	}
+
+	double lanes[4];
+	_mm256_storeu_pd(lanes, _mm256_add_pd(sum0, sum1));
+
+	double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+	for(; i < length; i++) {
+		sum += values[i];
+	}
+
+	return sum;
+}
+
+LIBSTORE_TARGET_AVX2 static void minMaxIntsAvx2(const int *values, int length, int *min, int *max)
+{
+	if(length < 8) {
+		minMaxIntsScalar(values, length, min, max);
+		return;
+	}
+
+	__m256i minimum = _mm256_loadu_si256((const __m256i *) values);
+	__m256i maximum = minimum;
+
+	int i = 8;
+	for(; i + 8 <= length; i += 8) {
+		__m256i chunk = _mm256_loadu_si256((const __m256i *) (values + i));
+		minimum = _mm256_min_epi32(minimum, chunk);
+		maximum = _mm256_max_epi32(maximum, chunk);
+	}
+
+	int minLanes[8];
+	int maxLanes[8];
+	_mm256_storeu_si256((__m256i *) minLanes, minimum);
+	_mm256_storeu_si256((__m256i *) maxLanes, maximum);
+
+	*min = minLanes[0];
+	*max = maxLanes[0];
+	for(int lane = 1; lane < 8; lane++) {
+		if(minLanes[lane] < *min) {
+			*min = minLanes[lane];
+		}
+		if(maxLanes[lane] > *max) {
+			*max = maxLanes[lane];
+		}
+	}
+
+	for(; i < length; i++) {
+		if(values[i] < *min) {
+			*min = values[i];
+		}
+		if(values[i] > *max) {
+			*max = values[i];
+		}
+	}
+}
+
+LIBSTORE_TARGET_AVX2 static void minMaxFloatsAvx2(const double *values, int length, double *min, double *max)
+{
+	if(length < 4) {
+		minMaxFloatsScalar(values, length, min, max);
+		return;
+	}
+
+	__m256d minimum = _mm256_loadu_pd(values);
+	__m256d maximum = minimum;
+	// the min and max instructions don't propagate NaNs consistently, so they are tracked separately
+	__m256d nans = _mm256_cmp_pd(minimum, minimum, _CMP_UNORD_Q);
+
+	int i = 4;
+	for(; i + 4 <= length; i += 4) {
+		__m256d chunk = _mm256_loadu_pd(values + i);
+		minimum = _mm256_min_pd(minimum, chunk);
+		maximum = _mm256_max_pd(maximum, chunk);
+		nans = _mm256_or_pd(nans, _mm256_cmp_pd(chunk, chunk, _CMP_UNORD_Q));
+	}
+
+	double minLanes[4];
+	double maxLanes[4];
+	_mm256_storeu_pd(minLanes, minimum);
+	_mm256_storeu_pd(maxLanes, maximum);
+
+	*min = minLanes[0];
+	*max = maxLanes[0];
+	for(int lane = 1; lane < 4; lane++) {
+		if(minLanes[lane] < *min) {
+			*min = minLanes[lane];
+		}
+		if(maxLanes[lane] > *max) {
+			*max = maxLanes[lane];
+		}
+	}
+
+	if(_mm256_movemask_pd(nans) != 0) {
+		*min = NAN;
+		*max = NAN;
+	}
+
+	for(; i < length; i++) {
+		if(values[i] < *min || isnan(values[i])) {
+			*min = values[i];
+		}
+		if(values[i] > *max || isnan(values[i])) {
+			*max = values[i];
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,166 @@
+#include <cmath>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/store.h>
+}
+
+#include "aggregate.c"
+
+TEST(Aggregate, intArray)
+{
+	// odd length to exercise the scalar tail after the vectorized loop
+	std::vector<int> values;
+	for(int i = 0; i < 1003; i++) {
+		values.push_back(i % 2 == 0 ? i : -i);
+	}
+	Store *store = storeCreateIntArrayValue(values.data(), values.size());
+
+	double min, max, mean;
+	ASSERT_EQ(storeListCount(store), 1003) << "count should be the array length";
+	ASSERT_EQ(storeListSum(store), 501) << "sum should be correct";
+	ASSERT_TRUE(storeListMin(store, &min)) << "min of a non-empty array should succeed";
+	ASSERT_EQ(min, -1001) << "min should be correct";
+	ASSERT_TRUE(storeListMax(store, &max)) << "max of a non-empty array should succeed";
+	ASSERT_EQ(max, 1002) << "max should be correct";
+	ASSERT_TRUE(storeListMean(store, &mean)) << "mean of a non-empty array should succeed";
+	ASSERT_DOUBLE_EQ(mean, 501.0 / 1003) << "mean should be correct";
+
+	storeFree(store);
+}
+
+TEST(Aggregate, floatArray)
+{
+	std::vector<double> values;
+	for(int i = 0; i < 1003; i++) {
+		values.push_back(i * 0.5 - 100);
+	}
+	Store *store = storeCreateFloatArrayValue(values.data(), values.size());
+
+	double min, max;
+	ASSERT_EQ(storeListCount(store), 1003) << "count should be the array length";
+	ASSERT_EQ(storeListSum(store), 150951.5) << "sum should be correct";
+	ASSERT_TRUE(storeListMin(store, &min)) << "min of a non-empty array should succeed";
+	ASSERT_EQ(min, -100) << "min should be correct";
+	ASSERT_TRUE(storeListMax(store, &max)) << "max of a non-empty array should succeed";
+	ASSERT_EQ(max, 401) << "max should be correct";
+
+	storeFree(store);
+}
+
+TEST(Aggregate, kernelsMatchScalar)
+{
+	std::vector<int> ints;
+	std::vector<double> floats;
+	for(int length = 0; length < 40; length++) {
+		ints.push_back((length * 7919) % 101 - 50);
+		floats.push_back(((length * 7919) % 101 - 50) * 0.25);
+
+		ASSERT_EQ(sumInts(ints.data(), ints.size()), sumIntsScalar(ints.data(), ints.size())) << "int sum kernel should match the scalar sum for length " << ints.size();
+		ASSERT_EQ(sumFloats(floats.data(), floats.size()), sumFloatsScalar(floats.data(), floats.size())) << "float sum kernel should match the scalar sum for length " << floats.size();
+
+		int min, max, scalarMin, scalarMax;
+		minMaxInts(ints.data(), ints.size(), &min, &max);
+		minMaxIntsScalar(ints.data(), ints.size(), &scalarMin, &scalarMax);
+		ASSERT_EQ(min, scalarMin) << "int min kernel should match the scalar min for length " << ints.size();
+		ASSERT_EQ(max, scalarMax) << "int max kernel should match the scalar max for length " << ints.size();
+
+		double floatMin, floatMax, scalarFloatMin, scalarFloatMax;
+		minMaxFloats(floats.data(), floats.size(), &floatMin, &floatMax);
+		minMaxFloatsScalar(floats.data(), floats.size(), &scalarFloatMin, &scalarFloatMax);
+		ASSERT_EQ(floatMin, scalarFloatMin) << "float min kernel should match the scalar min for length " << floats.size();
+		ASSERT_EQ(floatMax, scalarFloatMax) << "float max kernel should match the scalar max for length " << floats.size();
+	}
+}
+
+TEST(Aggregate, nan)
+{
+	for(int length = 1; length < 20; length++) {
+		for(int position = 0; position < length; position++) {
+			std::vector<double> floats;
+			for(int i = 0; i < length; i++) {
+				floats.push_back(i == position ? NAN : i * 0.5);
+			}
+
+			double min, max, scalarMin, scalarMax;
+			minMaxFloats(floats.data(), floats.size(), &min, &max);
+			minMaxFloatsScalar(floats.data(), floats.size(), &scalarMin, &scalarMax);
+			ASSERT_TRUE(std::isnan(min)) << "min should be NaN for a NaN at " << position << " of length " << length;
+			ASSERT_TRUE(std::isnan(max)) << "max should be NaN for a NaN at " << position << " of length " << length;
+			ASSERT_TRUE(std::isnan(scalarMin)) << "scalar min should be NaN for a NaN at " << position << " of length " << length;
+			ASSERT_TRUE(std::isnan(scalarMax)) << "scalar max should be NaN for a NaN at " << position << " of length " << length;
+		}
+	}
+
+	Store *store = storeCreateListValue();
+	g_queue_push_tail(store->content.listValue, storeCreateIntValue(4));
+	g_queue_push_tail(store->content.listValue, storeCreateFloatValue(NAN));
+	g_queue_push_tail(store->content.listValue, storeCreateFloatValue(-1.5));
+
+	double min, max;
+	ASSERT_TRUE(storeListMin(store, &min)) << "min of a list with NaN should succeed";
+	ASSERT_TRUE(std::isnan(min)) << "min of a list with NaN should be NaN";
+	ASSERT_TRUE(storeListMax(store, &max)) << "max of a list with NaN should succeed";
+	ASSERT_TRUE(std::isnan(max)) << "max of a list with NaN should be NaN";
+
+	storeFree(store);
+}
+
+TEST(Aggregate, genericList)
+{
+	Store *store = storeCreateListValue();
+	g_queue_push_tail(store->content.listValue, storeCreateIntValue(4));
+	g_queue_push_tail(store->content.listValue, storeCreateStringValue("skipped"));
+	g_queue_push_tail(store->content.listValue, storeCreateFloatValue(-1.5));
+	g_queue_push_tail(store->content.listValue, storeCreateIntValue(2));
+
+	double min, max, mean;
+	ASSERT_EQ(storeListCount(store), 3) << "count should only include numeric elements";
+	ASSERT_EQ(storeListSum(store), 4.5) << "sum should be correct";
+	ASSERT_TRUE(storeListMin(store, &min)) << "min of a numeric list should succeed";
+	ASSERT_EQ(min, -1.5) << "min should be correct";
+	ASSERT_TRUE(storeListMax(store, &max)) << "max of a numeric list should succeed";
+	ASSERT_EQ(max, 4) << "max should be correct";
+	ASSERT_TRUE(storeListMean(store, &mean)) << "mean of a numeric list should succeed";
+	ASSERT_EQ(mean, 1.5) << "mean should be correct";
+
+	storeFree(store);
+}
+
+TEST(Aggregate, empty)
+{
+	Store *store = storeCreateListValue();
+	Store *notAList = storeCreateStringValue("foo");
+
+	double value;
+	ASSERT_EQ(storeListCount(store), 0) << "count of an empty list should be zero";
+	ASSERT_EQ(storeListSum(store), 0) << "sum of an empty list should be zero";
+	ASSERT_FALSE(storeListMin(store, &value)) << "min of an empty list should fail";
+	ASSERT_FALSE(storeListMean(store, &value)) << "mean of an empty list should fail";
+	ASSERT_EQ(storeListCount(notAList), -1) << "count of a non list should be -1";
+	ASSERT_FALSE(storeListMax(notAList, &value)) << "max of a non list should fail";
+
+	storeFree(store);
+	storeFree(notAList);
+}
+
+TEST(Aggregate, histogram)
+{
+	double values[] = {-1, 0, 0.5, 1, 2.5, 3.999, 4, 9};
+	Store *store = storeCreateFloatArrayValue(values, 8);
+
+	int bins[4] = {0, 0, 0, 0};
+	ASSERT_TRUE(storeListHistogram(store, 0, 4, 4, bins)) << "histogram of a valid range should succeed";
+	ASSERT_EQ(bins[0], 2) << "first bin should count values in [0, 1)";
+	ASSERT_EQ(bins[1], 1) << "second bin should count values in [1, 2)";
+	ASSERT_EQ(bins[2], 1) << "third bin should count values in [2, 3)";
+	ASSERT_EQ(bins[3], 1) << "last bin should count values in [3, 4)";
+
+	ASSERT_FALSE(storeListHistogram(store, 4, 0, 4, bins)) << "histogram of an empty range should fail";
+	ASSERT_FALSE(storeListHistogram(store, 0, 4, 0, bins)) << "histogram without bins should fail";
+
+	storeFree(store);
+}
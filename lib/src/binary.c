@@ -0,0 +1,440 @@
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL size_t
+#include <stdint.h> // uint8_t uint32_t uint64_t
+#include <string.h> // memcmp memcpy strlen
+
+#include <glib.h>
+
+#include "store/binary.h"
+#include "store/list.h"
+#include "store/map.h"
+#include "store/memory.h"
+#include "store/table.h"
+
+/**
+ * The bytes every encoding starts with, followed by the version
+ */
+static const char magic[4] = {'S', 'T', 'B', 'N'};
+
+/**
+ * The maximum nesting depth of decoded stores, so that corrupt data can't exhaust the stack
+ */
+static const int maxDepth = 1024;
+
+typedef enum {
+	TAG_STRING,
+	TAG_INT,
+	TAG_FLOAT,
+	TAG_LIST,
+	TAG_MAP,
+	TAG_INT_ARRAY,
+	TAG_FLOAT_ARRAY,
+	TAG_TABLE
+} Tag;
+
+typedef struct {
+	const uint8_t *position;
+	const uint8_t *end;
+} Decoder;
+
+static void encodeValue(GString *string, Store *store);
+static void encodeList(GString *string, Store *store);
+static void encodeMap(GString *string, Store *store);
+static void encodeTable(GString *string, Store *store);
+static void encodeString(GString *string, const char *value, size_t length);
+static void encodeVarint(GString *string, uint64_t value);
+static void encodeDouble(GString *string, double value);
+static Store *decodeValue(Decoder *decoder, int depth);
+static Store *decodeString(Decoder *decoder);
+static Store *decodeList(Decoder *decoder, int depth);
+static Store *decodeMap(Decoder *decoder, int depth);
+static Store *decodeIntArray(Decoder *decoder);
+static Store *decodeFloatArray(Decoder *decoder);
+static bool decodeLength(Decoder *decoder, int *length);
+static bool decodeVarint(Decoder *decoder, uint64_t *value);
+static bool decodeInt(Decoder *decoder, int *value);
+static bool decodeDouble(Decoder *decoder, double *value);
+static uint64_t zigzag(int value);
+
+char *storeEncodeBinary(Store *store, size_t *length)
+{
+	GString *string = g_string_new("");
+	g_string_append_len(string, magic, sizeof(magic));
+	encodeVarint(string, STORE_BINARY_VERSION);
+	encodeValue(string, store);
+
+	*length = string->len;
+	return g_string_free(string, false);
+}
+
+Store *storeDecodeBinary(const char *data, size_t length)
+{
+	if(length < sizeof(magic) || memcmp(data, magic, sizeof(magic)) != 0) {
+		return NULL;
+	}
+
+	Decoder decoder;
+	decoder.position = (const uint8_t *) data + sizeof(magic);
+	decoder.end = (const uint8_t *) data + length;
+
+	uint64_t version;
+	if(!decodeVarint(&decoder, &version) || version != STORE_BINARY_VERSION) {
+		return NULL;
+	}
+
+	Store *store = decodeValue(&decoder, 0);
+	if(store != NULL && decoder.position != decoder.end) {
+		storeFree(store);
+		return NULL;
+	}
+
+	return store;
+}
+
+static void encodeValue(GString *string, Store *store)
+{
+	switch(store->type) {
+		case STORE_STRING:
+			g_string_append_c(string, TAG_STRING);
+			encodeString(string, store->content.stringValue, storeGetStringLength(store));
+			break;
+		case STORE_INT:
+			g_string_append_c(string, TAG_INT);
+			encodeVarint(string, zigzag(store->content.intValue));
+			break;
+		case STORE_FLOAT:
+			g_string_append_c(string, TAG_FLOAT);
+			encodeDouble(string, store->content.floatValue);
+			break;
+		case STORE_MAP:
+			encodeMap(string, store);
+			break;
+		case STORE_TABLE:
+			encodeTable(string, store);
+			break;
+		default:
+			encodeList(string, store);
+			break;
+	}
+}
+
+/**
+ * Encodes a generic list or packed array store, keeping the elements of packed arrays packed
+ */
+static void encodeList(GString *string, Store *store)
+{
+	int length = storeListGetLength(store);
+
+	if(store->type == STORE_INT_ARRAY) {
+		g_string_append_c(string, TAG_INT_ARRAY);
+		encodeVarint(string, length);
+		for(int i = 0; i < length; i++) {
+			encodeVarint(string, zigzag(store->content.arrayValue->intValues[i]));
+		}
+	} else if(store->type == STORE_FLOAT_ARRAY) {
+		g_string_append_c(string, TAG_FLOAT_ARRAY);
+		encodeVarint(string, length);
+		for(int i = 0; i < length; i++) {
+			encodeDouble(string, store->content.arrayValue->floatValues[i]);
+		}
+	} else {
+		g_string_append_c(string, TAG_LIST);
+		encodeVarint(string, length);
+		for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+			encodeValue(string, (Store *) iter->data);
+		}
+	}
+}
+
+static void encodeMap(GString *string, Store *store)
+{
+	g_string_append_c(string, TAG_MAP);
+	encodeVarint(string, storeMapGetSize(store));
+
+	StoreMapIterator iter;
+	storeMapIteratorInit(&iter, store);
+	const char *key;
+	Store *value;
+	while(storeMapIteratorNext(&iter, &key, &value)) {
+		encodeString(string, key, strlen(key));
+		encodeValue(string, value);
+	}
+}
+
+/**
+ * Encodes a table store as its rows, each being a map of the row's non-null values
+ */
+static void encodeTable(GString *string, Store *store)
+{
+	int numRows = storeTableGetNumRows(store);
+	int numColumns = storeTableGetNumColumns(store);
+
+	g_string_append_c(string, TAG_TABLE);
+	encodeVarint(string, numRows);
+	for(int row = 0; row < numRows; row++) {
+		int numValues = 0;
+		for(int column = 0; column < numColumns; column++) {
+			if(!storeTableIsNull(store, column, row)) {
+				numValues++;
+			}
+		}
+
+		g_string_append_c(string, TAG_MAP);
+		encodeVarint(string, numValues);
+		for(int column = 0; column < numColumns; column++) {
+			Store value;
+			if(storeTableGetValue(store, column, row, &value)) {
+				const char *name = storeTableGetColumnName(store, column);
+				encodeString(string, name, strlen(name));
+				encodeValue(string, &value);
+			}
+		}
+	}
+}
+
+static void encodeString(GString *string, const char *value, size_t length)
+{
+	encodeVarint(string, length);
+	g_string_append_len(string, value, length);
+}
+
+/**
+ * Encodes an unsigned number in groups of seven bits, the lowest group first, setting the high bit of every byte but
+ * the last
+ */
+static void encodeVarint(GString *string, uint64_t value)
+{
+	while(value >= 0x80) {
+		g_string_append_c(string, (char) ((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+
+	g_string_append_c(string, (char) value);
+}
+
+static void encodeDouble(GString *string, double value)
+{
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	for(int i = 0; i < 8; i++) {
+		g_string_append_c(string, (char) (bits >> (8 * i)));
+	}
+}
+
+static Store *decodeValue(Decoder *decoder, int depth)
+{
+	if(decoder->position == decoder->end || depth > maxDepth) {
+		return NULL;
+	}
+
+	Tag tag = (Tag) *decoder->position++;
+	switch(tag) {
+		case TAG_STRING:
+			return decodeString(decoder);
+		case TAG_INT:
+		{
+			int value;
+			return decodeInt(decoder, &value) ? storeCreateIntValue(value) : NULL;
+		}
+		case TAG_FLOAT:
+		{
+			double value;
+			return decodeDouble(decoder, &value) ? storeCreateFloatValue(value) : NULL;
+		}
+		case TAG_LIST:
+			return decodeList(decoder, depth);
+		case TAG_MAP:
+			return decodeMap(decoder, depth);
+		case TAG_INT_ARRAY:
+			return decodeIntArray(decoder);
+		case TAG_FLOAT_ARRAY:
+			return decodeFloatArray(decoder);
+		case TAG_TABLE:
+		{
+			Store *rows = decodeList(decoder, depth);
+			if(rows == NULL) {
+				return NULL;
+			}
+
+			Store *table = storeToColumns(rows);
+			storeFree(rows);
+			return table;
+		}
+		default:
+			return NULL;
+	}
+}
+
+static Store *decodeString(Decoder *decoder)
+{
+	int length;
+	if(!decodeLength(decoder, &length)) {
+		return NULL;
+	}
+
+	Store *store = storeCreateStringValueLength((const char *) decoder->position, length);
+	decoder->position += length;
+	return store;
+}
+
+static Store *decodeList(Decoder *decoder, int depth)
+{
+	uint64_t length;
+	if(!decodeVarint(decoder, &length)) {
+		return NULL;
+	}
+
+	Store *list = storeCreateListValue();
+	for(uint64_t i = 0; i < length; i++) {
+		Store *element = decodeValue(decoder, depth + 1);
+		if(element == NULL) {
+			storeFree(list);
+			return NULL;
+		}
+
+		storeListAppend(list, element);
+	}
+
+	return list;
+}
+
+static Store *decodeMap(Decoder *decoder, int depth)
+{
+	uint64_t size;
+	if(!decodeVarint(decoder, &size)) {
+		return NULL;
+	}
+
+	Store *map = storeCreateMapValue();
+	for(uint64_t i = 0; i < size; i++) {
+		int keyLength;
+		if(!decodeLength(decoder, &keyLength)) {
+			storeFree(map);
+			return NULL;
+		}
+
+		GString *key = g_string_new_len((const char *) decoder->position, keyLength);
+		decoder->position += keyLength;
+
+		Store *value = decodeValue(decoder, depth + 1);
+		if(value == NULL) {
+			g_string_free(key, true);
+			storeFree(map);
+			return NULL;
+		}
+
+		storeMapInsert(map, key->str, value);
+		g_string_free(key, true);
+	}
+
+	return map;
+}
+
+static Store *decodeIntArray(Decoder *decoder)
+{
+	int length;
+	// every element takes at least one byte
+	if(!decodeLength(decoder, &length)) {
+		return NULL;
+	}
+
+	int *values = (int *) storeAllocateMemory(length * sizeof(int));
+	for(int i = 0; i < length; i++) {
+		if(!decodeInt(decoder, &values[i])) {
+			storeFreeMemory(values);
+			return NULL;
+		}
+	}
+
+	Store *store = storeCreateIntArrayValue(values, length);
+	storeFreeMemory(values);
+	return store;
+}
+
+static Store *decodeFloatArray(Decoder *decoder)
+{
+	uint64_t length;
+	if(!decodeVarint(decoder, &length) || length > (uint64_t) (decoder->end - decoder->position) / 8) {
+		return NULL;
+	}
+
+	double *values = (double *) storeAllocateMemory(length * sizeof(double));
+	for(uint64_t i = 0; i < length; i++) {
+		decodeDouble(decoder, &values[i]);
+	}
+
+	Store *store = storeCreateFloatArrayValue(values, (int) length);
+	storeFreeMemory(values);
+	return store;
+}
+
+/**
+ * Decodes a length that must not exceed the number of remaining bytes
+ */
+static bool decodeLength(Decoder *decoder, int *length)
+{
+	uint64_t value;
+	if(!decodeVarint(decoder, &value) || value > (uint64_t) (decoder->end - decoder->position)) {
+		return false;
+	}
+
+	*length = (int) value;
+	return true;
+}
+
+static bool decodeVarint(Decoder *decoder, uint64_t *value)
+{
+	*value = 0;
+	for(int shift = 0; shift < 64; shift += 7) {
+		if(decoder->position == decoder->end) {
+			return false;
+		}
+
+		uint8_t byte = *decoder->position++;
+		*value |= (uint64_t) (byte & 0x7f) << shift;
+		if((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Decodes a zigzag encoded int, see zigzag
+ */
+static bool decodeInt(Decoder *decoder, int *value)
+{
+	uint64_t encoded;
+	if(!decodeVarint(decoder, &encoded) || encoded > UINT32_MAX) {
+		return false;
+	}
+
+	*value = (int) (uint32_t) ((encoded >> 1) ^ -(encoded & 1));
+	return true;
+}
+
+static bool decodeDouble(Decoder *decoder, double *value)
+{
+	if(decoder->end - decoder->position < 8) {
+		return false;
+	}
+
+	uint64_t bits = 0;
+	for(int i = 0; i < 8; i++) {
+		bits |= (uint64_t) decoder->position[i] << (8 * i);
+	}
+	decoder->position += 8;
+
+	memcpy(value, &bits, sizeof(bits));
+	return true;
+}
+
+/**
+ * Maps an int to an unsigned number so that values of small magnitude have short varints regardless of their sign
+ */
+static uint64_t zigzag(int value)
+{
+	return (uint32_t) (((uint32_t) value << 1) ^ (uint32_t) (value >> 31));
+}
@@ -0,0 +1,106 @@
+#include <cstring>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/compare.h>
+	#include <store/list.h>
+	#include <store/parser.h>
+	#include <store/store.h>
+	#include <store/table.h>
+}
+
+#include "binary.c"
+
+static void expectRoundTrip(const char *input, int flags = 0)
+{
+	StoreParser *parser = storeCreateParser();
+	storeSetParserFlags(parser, flags);
+	Store *store = storeParse(parser, input);
+	ASSERT_TRUE(store != NULL) << "test store '" << input << "' should parse successfully";
+
+	size_t length;
+	char *encoded = storeEncodeBinary(store, &length);
+	Store *decoded = storeDecodeBinary(encoded, length);
+	ASSERT_TRUE(decoded != NULL) << "encoded store '" << input << "' should be decoded";
+	ASSERT_EQ(decoded->type, store->type) << "decoded store '" << input << "' should have the encoded type";
+	ASSERT_TRUE(storeEquals(decoded, store)) << "decoded store '" << input << "' should equal the encoded one";
+
+	free(encoded);
+	storeFree(decoded);
+	storeFree(store);
+	storeFreeParser(parser);
+}
+
+TEST(Binary, roundTrip)
+{
+	expectRoundTrip("a = 1; b = -2.5; c = hello; d = \"with \\\"quotes\\\" and\\nnewlines\"");
+	expectRoundTrip("a = {b = [1 2 3], c = {}}; d = []; e = \"\"");
+	expectRoundTrip("[2147483647 -2147483648 0 -1 1e308 -0.0 1.5e-300]");
+	expectRoundTrip("ints = [1 -2 300000]; floats = [0.5 1e10]; mixed = [1 a]", STORE_PARSE_PACK_LISTS);
+	expectRoundTrip("x = {y = [1 2]}; z = {y = [1 2]}", STORE_PARSE_DEDUPLICATE);
+}
+
+TEST(Binary, packedAndTables)
+{
+	StoreParser *parser = storeCreateParser();
+	storeSetParserFlags(parser, STORE_PARSE_PACK_LISTS);
+	Store *store = storeParse(parser, "[{a = 1, b = x} {a = 2.5} {b = y}]");
+	ASSERT_TRUE(store != NULL) << "test store should parse successfully";
+	Store *table = storeToColumns(store);
+	ASSERT_TRUE(table != NULL) << "test store should be converted to a table";
+
+	size_t length;
+	char *encoded = storeEncodeBinary(table, &length);
+	Store *decoded = storeDecodeBinary(encoded, length);
+	ASSERT_TRUE(decoded != NULL) << "encoded table should be decoded";
+	ASSERT_EQ(decoded->type, STORE_TABLE) << "decoded table should be a table again";
+	ASSERT_EQ(storeTableGetNumRows(decoded), 3) << "decoded table should have all rows";
+	ASSERT_TRUE(storeTableIsNull(decoded, storeTableFindColumn(decoded, "a"), 2)) << "null should be preserved";
+	ASSERT_TRUE(storeEquals(decoded, table)) << "decoded table should equal the encoded one";
+	free(encoded);
+	storeFree(decoded);
+	storeFree(table);
+	storeFree(store);
+
+	store = storeParse(parser, "[1 2 3]");
+	encoded = storeEncodeBinary(store, &length);
+	decoded = storeDecodeBinary(encoded, length);
+	ASSERT_EQ(decoded->type, STORE_INT_ARRAY) << "packed array should stay packed";
+	free(encoded);
+	storeFree(decoded);
+	storeFree(store);
+
+	storeFreeParser(parser);
+}
+
+TEST(Binary, malformed)
+{
+	StoreParser *parser = storeCreateParser();
+	Store *store = storeParse(parser, "a = {b = [1 2.5 \"three\"]}; c = [4 5]");
+	ASSERT_TRUE(store != NULL) << "test store should parse successfully";
+
+	size_t length;
+	char *encoded = storeEncodeBinary(store, &length);
+	for(size_t truncated = 0; truncated < length; truncated++) {
+		Store *decoded = storeDecodeBinary(encoded, truncated);
+		ASSERT_TRUE(decoded == NULL) << "data truncated to " << truncated << " bytes should be rejected";
+	}
+
+	char *extended = (char *) malloc(length + 1);
+	memcpy(extended, encoded, length);
+	extended[length] = TAG_INT;
+	ASSERT_TRUE(storeDecodeBinary(extended, length + 1) == NULL) << "trailing data should be rejected";
+	free(extended);
+
+	encoded[sizeof(magic)]++;
+	ASSERT_TRUE(storeDecodeBinary(encoded, length) == NULL) << "different version should be rejected";
+	encoded[sizeof(magic)]--;
+	encoded[0] = 'X';
+	ASSERT_TRUE(storeDecodeBinary(encoded, length) == NULL) << "wrong magic number should be rejected";
+
+	free(encoded);
+	storeFree(store);
+	storeFreeParser(parser);
+}
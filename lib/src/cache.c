@@ -0,0 +1,252 @@
+#include <pthread.h>
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL size_t
+#include <stdlib.h> // free
+#include <string.h> // strlen
+
+#include <glib.h>
+
+#include "store/cache.h"
+#include "store/digest.h"
+#include "store/memory.h"
+#include "store/parser.h"
+
+typedef struct {
+	/** The key of the entry, prefixed by the namespace of digest or caller keys */
+	char *key;
+	/** The cache's reference to the frozen store */
+	Store *store;
+	/** The size of the store in bytes */
+	size_t size;
+	/** The link of the entry in the cache's recency list */
+	GList *link;
+} CacheEntry;
+
+struct StoreCacheStruct {
+	size_t budget;
+	int parseFlags;
+	/** Lock protecting all of the following fields */
+	pthread_mutex_t lock;
+	/** table of (char *) keys to (CacheEntry *) entries */
+	GHashTable *entries;
+	/** queue of (CacheEntry *) entries from the most to the least recently used */
+	GQueue *recency;
+	size_t size;
+	unsigned long long hits;
+	unsigned long long misses;
+	unsigned long long evictions;
+};
+
+static Store *lookupEntry(StoreCache *cache, const char *key);
+static Store *insertEntry(StoreCache *cache, char *key, Store *store, size_t size, bool replace);
+static void removeEntry(StoreCache *cache, CacheEntry *entry);
+static char *createDigestKey(const char *input);
+static char *createCallerKey(const char *key);
+
+StoreCache *storeCreateCache(size_t budget, int parseFlags)
+{
+	StoreCache *cache = storeAllocateMemoryType(StoreCache);
+	cache->budget = budget;
+	cache->parseFlags = parseFlags & ~STORE_PARSE_SPANS;
+	pthread_mutex_init(&cache->lock, NULL);
+	cache->entries = g_hash_table_new(g_str_hash, g_str_equal);
+	cache->recency = g_queue_new();
+	cache->size = 0;
+	cache->hits = 0;
+	cache->misses = 0;
+	cache->evictions = 0;
+	return cache;
+}
+
+void storeFreeCache(StoreCache *cache)
+{
+	storeCacheClear(cache);
+	g_queue_free(cache->recency);
+	g_hash_table_destroy(cache->entries);
+	pthread_mutex_destroy(&cache->lock);
+	storeFreeMemory(cache);
+}
+
+Store *storeCacheParse(StoreCache *cache, const char *input)
+{
+	char *key = createDigestKey(input);
+
+	pthread_mutex_lock(&cache->lock);
+	Store *store = lookupEntry(cache, key);
+	pthread_mutex_unlock(&cache->lock);
+
+	if(store != NULL) {
+		free(key);
+		return store;
+	}
+
+	StoreParser *parser = storeCreateParser();
+	storeSetParserFlags(parser, cache->parseFlags);
+	store = storeParse(parser, input);
+	storeFreeParser(parser);
+
+	if(store == NULL) {
+		free(key);
+		return NULL;
+	}
+
+	// freezing and measuring walk the whole store, so do it before serializing on the lock
+	storeFreeze(store);
+	size_t size = storeGetMemorySize(store);
+
+	// another thread may have cached the same text while this one was parsing, in which case its store is kept
+	pthread_mutex_lock(&cache->lock);
+	store = insertEntry(cache, key, store, size, false);
+	pthread_mutex_unlock(&cache->lock);
+	return store;
+}
+
+Store *storeCacheLookup(StoreCache *cache, const char *key)
+{
+	char *callerKey = createCallerKey(key);
+
+	pthread_mutex_lock(&cache->lock);
+	Store *store = lookupEntry(cache, callerKey);
+	pthread_mutex_unlock(&cache->lock);
+
+	free(callerKey);
+	return store;
+}
+
+Store *storeCacheInsert(StoreCache *cache, const char *key, Store *store)
+{
+	storeFreeze(store);
+	size_t size = storeGetMemorySize(store);
+
+	pthread_mutex_lock(&cache->lock);
+	store = insertEntry(cache, createCallerKey(key), store, size, true);
+	pthread_mutex_unlock(&cache->lock);
+	return store;
+}
+
+void storeCacheClear(StoreCache *cache)
+{
+	pthread_mutex_lock(&cache->lock);
+	while(!g_queue_is_empty(cache->recency)) {
+		removeEntry(cache, (CacheEntry *) g_queue_peek_tail(cache->recency));
+	}
+	pthread_mutex_unlock(&cache->lock);
+}
+
+void storeCacheGetStatistics(StoreCache *cache, StoreCacheStatistics *statistics)
+{
+	pthread_mutex_lock(&cache->lock);
+	statistics->hits = cache->hits;
+	statistics->misses = cache->misses;
+	statistics->evictions = cache->evictions;
+	statistics->numEntries = g_queue_get_length(cache->recency);
+	statistics->size = cache->size;
+	statistics->budget = cache->budget;
+	pthread_mutex_unlock(&cache->lock);
+}
+
+/**
+ * Looks up an entry and marks it as the most recently used, must be called with the cache's lock held
+ *
+ * @param cache			the cache to query
+ * @param key			the namespaced key of the entry
+ * @result				a new reference to the entry's store, or NULL on a miss
+ */
+static Store *lookupEntry(StoreCache *cache, const char *key)
+{
+	CacheEntry *entry = (CacheEntry *) g_hash_table_lookup(cache->entries, key);
+	if(entry == NULL) {
+		cache->misses++;
+		return NULL;
+	}
+
+	cache->hits++;
+	g_queue_unlink(cache->recency, entry->link);
+	g_queue_push_head_link(cache->recency, entry->link);
+	return storeRetain(entry->store);
+}
+
+/**
+ * Caches a store as the most recently used entry and evicts the least recently used entries exceeding the budget, must
+ * be called with the cache's lock held
+ *
+ * @param cache			the cache to insert into
+ * @param key			the namespaced key of the entry, ownership is transferred to the cache
+ * @param store			the frozen store to cache, ownership is transferred to the cache
+ * @param size			the size of the store in bytes
+ * @param replace		whether to replace an existing entry for the key, or to keep it and free the store instead
+ * @result				a new reference to the cached store
+ */
+static Store *insertEntry(StoreCache *cache, char *key, Store *store, size_t size, bool replace)
+{
+	CacheEntry *existing = (CacheEntry *) g_hash_table_lookup(cache->entries, key);
+	if(existing != NULL) {
+		if(!replace) {
+			free(key);
+			storeFree(store);
+			g_queue_unlink(cache->recency, existing->link);
+			g_queue_push_head_link(cache->recency, existing->link);
+			return storeRetain(existing->store);
+		}
+
+		removeEntry(cache, existing);
+	}
+
+	if(size > cache->budget) {
+		free(key);
+		return store;
+	}
+
+	CacheEntry *entry = storeAllocateMemoryType(CacheEntry);
+	entry->key = key;
+	entry->store = store;
+	entry->size = size;
+	g_queue_push_head(cache->recency, entry);
+	entry->link = g_queue_peek_head_link(cache->recency);
+	g_hash_table_insert(cache->entries, entry->key, entry);
+	cache->size += size;
+
+	while(cache->size > cache->budget) {
+		removeEntry(cache, (CacheEntry *) g_queue_peek_tail(cache->recency));
+		cache->evictions++;
+	}
+
+	return storeRetain(store);
+}
+
+/**
+ * Removes an entry and releases the cache's reference to its store, must be called with the cache's lock held
+ */
+static void removeEntry(StoreCache *cache, CacheEntry *entry)
+{
+	g_hash_table_remove(cache->entries, entry->key);
+	g_queue_delete_link(cache->recency, entry->link);
+	cache->size -= entry->size;
+
+	storeFree(entry->store);
+	free(entry->key);
+	storeFreeMemory(entry);
+}
+
+/**
+ * Creates the key of a parsed text from its digest, in a namespace separate from the caller keys
+ */
+static char *createDigestKey(const char *input)
+{
+	char digest[STORE_DIGEST_STRING_LENGTH + 1];
+	storeFormatDigest(storeDigest(input, strlen(input)), digest);
+
+	GString *key = g_string_new("#");
+	g_string_append(key, digest);
+	return g_string_free(key, false);
+}
+
+/**
+ * Creates the namespaced key of a caller's key
+ */
+static char *createCallerKey(const char *key)
+{
+	GString *callerKey = g_string_new("$");
+	g_string_append(callerKey, key);
+	return g_string_free(callerKey, false);
+}
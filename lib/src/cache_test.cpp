@@ -0,0 +1,184 @@
+#include <string>
+
+#include <pthread.h>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/dedup.h>
+	#include <store/map.h>
+	#include <store/parser.h>
+	#include <store/store.h>
+	#include <store/table.h>
+}
+
+#include "cache.c"
+
+static const int numThreads = 8;
+static const int numIterations = 200;
+
+static void *parseRepeatedly(void *cachePointer)
+{
+	StoreCache *cache = (StoreCache *) cachePointer;
+	for(int i = 0; i < numIterations; i++) {
+		std::string input = "route = " + std::to_string(i % 10) + "; upstream = {host = example, port = 80}";
+		Store *store = storeCacheParse(cache, input.c_str());
+		if(store == NULL || storeMapLookup(store, "route")->content.intValue != i % 10) {
+			return (void *) 1;
+		}
+
+		storeFree(store);
+	}
+
+	return NULL;
+}
+
+TEST(Cache, memorySize)
+{
+	StoreParser *parser = storeCreateParser();
+	Store *store = storeParse(parser, "a = {x = [1 2 \"three\"]}; b = {x = [1 2 \"three\"]}; c = 4.5");
+	ASSERT_TRUE(store != NULL) << "test store should parse successfully";
+
+	size_t size = storeGetMemorySize(store);
+	ASSERT_GT(size, sizeof(Store) * 12) << "size should cover every node";
+	size_t saved = storeDeduplicate(store);
+	ASSERT_GT(saved, 0u) << "test store should contain duplicates";
+	ASSERT_EQ(storeGetMemorySize(store), size - saved) << "shared subtrees should be counted once";
+	storeFree(store);
+
+	store = storeParse(parser, "[{a = 1, b = x} {a = 2, b = yy}]");
+	Store *table = storeToColumns(store);
+	ASSERT_GT(storeGetMemorySize(table), sizeof(Store) + 2 * (2 * sizeof(int) + 3)) << "size should cover the table's columns";
+	storeFree(table);
+	storeFree(store);
+
+	storeFreeParser(parser);
+}
+
+TEST(Cache, parse)
+{
+	StoreCache *cache = storeCreateCache(1 << 20, STORE_PARSE_PACK_LISTS);
+
+	Store *first = storeCacheParse(cache, "a = [1 2 3]");
+	ASSERT_TRUE(first != NULL) << "text should be parsed on a miss";
+	ASSERT_EQ(storeMapLookup(first, "a")->type, STORE_INT_ARRAY) << "parse flags should be applied";
+	ASSERT_TRUE(storeMapIsFrozen(first)) << "cached store should be frozen";
+
+	Store *second = storeCacheParse(cache, "a = [1 2 3]");
+	ASSERT_EQ(second, first) << "same text should return the cached store";
+	ASSERT_GE(first->references, 3u) << "cache and both users should share the store";
+	ASSERT_TRUE(storeCacheParse(cache, "a = [") == NULL) << "unparsable text should fail";
+
+	StoreCacheStatistics statistics;
+	storeCacheGetStatistics(cache, &statistics);
+	ASSERT_EQ(statistics.hits, 1u) << "second parse should hit";
+	ASSERT_EQ(statistics.misses, 2u) << "first parse and failed parse should miss";
+	ASSERT_EQ(statistics.numEntries, 1) << "only the parsed store should be cached";
+	ASSERT_EQ(statistics.size, storeGetMemorySize(first)) << "cache size should be the size of the cached store";
+
+	storeCacheClear(cache);
+	storeCacheGetStatistics(cache, &statistics);
+	ASSERT_EQ(statistics.numEntries, 0) << "cleared cache should be empty";
+	ASSERT_EQ(statistics.size, 0u) << "cleared cache should have no size";
+	ASSERT_EQ(storeMapGetSize(first), 1) << "store should remain valid for its users after being removed";
+
+	storeFree(second);
+	storeFree(first);
+	storeFreeCache(cache);
+}
+
+TEST(Cache, callerKeys)
+{
+	StoreCache *cache = storeCreateCache(1 << 20, 0);
+	ASSERT_TRUE(storeCacheLookup(cache, "route") == NULL) << "missing key should miss";
+
+	Store *store = storeCreateMapValue();
+	storeMapInsert(store, "port", storeCreateIntValue(80));
+	Store *inserted = storeCacheInsert(cache, "route", store);
+	ASSERT_EQ(inserted, store) << "insertion should return the cached store";
+	Store *found = storeCacheLookup(cache, "route");
+	ASSERT_EQ(found, store) << "inserted key should be found";
+	storeFree(found);
+	storeFree(inserted);
+
+	Store *replacement = storeCreateIntValue(1);
+	storeFree(storeCacheInsert(cache, "route", replacement));
+	found = storeCacheLookup(cache, "route");
+	ASSERT_EQ(found, replacement) << "inserting a key again should replace its store";
+	storeFree(found);
+
+	Store *parsed = storeCacheParse(cache, "route");
+	ASSERT_NE(parsed, replacement) << "caller keys should not collide with parsed texts";
+	storeFree(parsed);
+
+	storeFreeCache(cache);
+}
+
+TEST(Cache, eviction)
+{
+	Store *sample = storeCreateStringValue("value 0");
+	storeFreeze(sample);
+	size_t entrySize = storeGetMemorySize(sample);
+	storeFree(sample);
+
+	StoreCache *cache = storeCreateCache(3 * entrySize, 0);
+	Store *stores[4];
+	for(int i = 0; i < 3; i++) {
+		std::string key = "key" + std::to_string(i);
+		stores[i] = storeCacheInsert(cache, key.c_str(), storeCreateStringValue(("value " + std::to_string(i)).c_str()));
+	}
+
+	Store *touched = storeCacheLookup(cache, "key0"); // key1 becomes the least recently used
+	storeFree(touched);
+	stores[3] = storeCacheInsert(cache, "key3", storeCreateStringValue("value 3"));
+
+	StoreCacheStatistics statistics;
+	storeCacheGetStatistics(cache, &statistics);
+	ASSERT_EQ(statistics.evictions, 1u) << "exceeding the budget should evict one store";
+	ASSERT_EQ(statistics.numEntries, 3) << "budget should hold three stores";
+	ASSERT_LE(statistics.size, statistics.budget) << "cache should stay within its budget";
+
+	Store *evicted = storeCacheLookup(cache, "key1");
+	ASSERT_TRUE(evicted == NULL) << "least recently used store should be evicted";
+	ASSERT_STREQ(stores[1]->content.stringValue, "value 1") << "evicted store should remain valid for its users";
+	Store *kept = storeCacheLookup(cache, "key0");
+	ASSERT_TRUE(kept != NULL) << "recently used store should be kept";
+	storeFree(kept);
+
+	Store *large = storeCreateStringValue(std::string(4 * entrySize, 'x').c_str());
+	Store *uncached = storeCacheInsert(cache, "large", large);
+	ASSERT_EQ(uncached, large) << "store larger than the budget should still be returned";
+	storeFree(uncached);
+	storeCacheGetStatistics(cache, &statistics);
+	ASSERT_EQ(statistics.numEntries, 3) << "store larger than the budget should not be cached";
+
+	for(int i = 0; i < 4; i++) {
+		storeFree(stores[i]);
+	}
+	storeFreeCache(cache);
+}
+
+TEST(Cache, threads)
+{
+	StoreCache *cache = storeCreateCache(1 << 20, 0);
+
+	pthread_t threads[numThreads];
+	for(int i = 0; i < numThreads; i++) {
+		pthread_create(&threads[i], NULL, parseRepeatedly, cache);
+	}
+
+	for(int i = 0; i < numThreads; i++) {
+		void *result;
+		pthread_join(threads[i], &result);
+		ASSERT_TRUE(result == NULL) << "every thread should see the stores it parsed";
+	}
+
+	StoreCacheStatistics statistics;
+	storeCacheGetStatistics(cache, &statistics);
+	ASSERT_EQ(statistics.hits + statistics.misses, (unsigned long long) numThreads * numIterations) << "every lookup should be counted";
+	ASSERT_EQ(statistics.numEntries, 10) << "each distinct text should be cached once";
+	ASSERT_GE(statistics.misses, 10u) << "each distinct text should miss at least once";
+
+	storeFreeCache(cache);
+}
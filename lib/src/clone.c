@@ -0,0 +1,227 @@
+#include <pthread.h>
+#include <stdbool.h> // true
+#include <stddef.h> // NULL
+#include <unistd.h> // sysconf
+
+#include <glib.h>
+
+#include "store/clone.h"
+#include "store/list.h"
+#include "store/map.h"
+#include "store/memory.h"
+
+/**
+ * Children of the root with at least this many descendants are cloned by worker threads in parallel mode
+ */
+static const int parallelThreshold = 4096;
+
+typedef struct {
+	/** The position of the subtree among the children of the root */
+	int position;
+	Store *source;
+	Store *clone;
+} CloneTask;
+
+typedef struct {
+	/** The subtrees to clone on worker threads, in the order of their positions */
+	CloneTask *tasks;
+	int numTasks;
+	/** The index of the next task to be picked up by a worker */
+	int nextTask;
+	/** The position of the next child copied while copying the root */
+	int position;
+	/** The index of the first task whose position wasn't reached yet while copying the root */
+	int taskIndex;
+} ParallelClone;
+
+static Store *cloneStore(Store *store, void *userData);
+static Store *cloneParallel(Store *store);
+static Store *cloneRootChild(Store *store, void *userData);
+static void *runCloneWorker(void *userData);
+static int countStores(Store *store, int limit);
+
+Store *storeClone(Store *store, int flags)
+{
+	if((flags & STORE_CLONE_PARALLEL) && (store->type == STORE_LIST || store->type == STORE_MAP)) {
+		return cloneParallel(store);
+	}
+
+	return cloneStore(store, NULL);
+}
+
+static Store *cloneStore(Store *store, void *userData)
+{
+	(void) userData;
+
+	if(store->type == STORE_TABLE) {
+		return storeRetain(store);
+	}
+
+	return storeCopyNode(store, cloneStore, NULL);
+}
+
+/**
+ * Clones a list or map store, handing its large children to worker threads while the calling thread copies the rest
+ */
+static Store *cloneParallel(Store *store)
+{
+	int numChildren = store->type == STORE_LIST ? storeListGetLength(store) : storeMapGetSize(store);
+	if(numChildren == 0) {
+		return cloneStore(store, NULL);
+	}
+
+	ParallelClone parallel;
+	parallel.tasks = (CloneTask *) storeAllocateMemory(numChildren * sizeof(CloneTask));
+	parallel.numTasks = 0;
+	parallel.nextTask = 0;
+	parallel.position = 0;
+	parallel.taskIndex = 0;
+
+	StoreMapIterator iterator;
+	storeMapIteratorInit(&iterator, store);
+	GList *link = store->type == STORE_LIST ? store->content.listValue->head : NULL;
+	for(int position = 0; position < numChildren; position++) {
+		Store *child;
+		if(store->type == STORE_LIST) {
+			child = (Store *) link->data;
+			link = link->next;
+		} else {
+			storeMapIteratorNext(&iterator, NULL, &child);
+		}
+
+		if(countStores(child, parallelThreshold) >= parallelThreshold) {
+			CloneTask *task = &parallel.tasks[parallel.numTasks];
+			task->position = position;
+			task->source = child;
+			task->clone = NULL;
+			parallel.numTasks++;
+		}
+	}
+
+	if(parallel.numTasks == 0) {
+		storeFreeMemory(parallel.tasks);
+		return cloneStore(store, NULL);
+	}
+
+	// the calling thread joins the workers once it copied everything else
+	long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+	int numWorkers = numProcessors < parallel.numTasks ? (int) numProcessors - 1 : parallel.numTasks - 1;
+	if(numWorkers < 0) {
+		numWorkers = 0;
+	}
+
+	pthread_t *workers = (pthread_t *) storeAllocateMemory((numWorkers + 1) * sizeof(pthread_t));
+	int numStarted = 0;
+	for(int i = 0; i < numWorkers; i++) {
+		if(pthread_create(&workers[numStarted], NULL, runCloneWorker, &parallel) == 0) {
+			numStarted++;
+		}
+	}
+
+	Store *clone = storeCopyNode(store, cloneRootChild, &parallel);
+	runCloneWorker(&parallel);
+
+	for(int i = 0; i < numStarted; i++) {
+		pthread_join(workers[i], NULL);
+	}
+
+	// replace the placeholders left for the children cloned by the workers
+	int taskIndex = 0;
+	storeMapIteratorInit(&iterator, clone);
+	link = clone->type == STORE_LIST ? clone->content.listValue->head : NULL;
+	for(int position = 0; taskIndex < parallel.numTasks; position++) {
+		if(clone->type == STORE_MAP) {
+			storeMapIteratorNext(&iterator, NULL, NULL);
+		}
+
+		if(position == parallel.tasks[taskIndex].position) {
+			if(clone->type == STORE_LIST) {
+				link->data = parallel.tasks[taskIndex].clone;
+			} else {
+				storeMapIteratorReplace(&iterator, parallel.tasks[taskIndex].clone);
+			}
+
+			taskIndex++;
+		}
+
+		if(clone->type == STORE_LIST) {
+			link = link->next;
+		}
+	}
+
+	storeFreeMemory(workers);
+	storeFreeMemory(parallel.tasks);
+	return clone;
+}
+
+/**
+ * Clones a child of the root in parallel mode, or leaves a NULL placeholder if a worker clones it
+ */
+static Store *cloneRootChild(Store *store, void *userData)
+{
+	ParallelClone *parallel = (ParallelClone *) userData;
+	int position = parallel->position;
+	parallel->position++;
+
+	if(parallel->taskIndex < parallel->numTasks && parallel->tasks[parallel->taskIndex].position == position) {
+		parallel->taskIndex++;
+		return NULL;
+	}
+
+	return cloneStore(store, NULL);
+}
+
+/**
+ * Clones subtrees for a parallel clone until no tasks are left
+ */
+static void *runCloneWorker(void *userData)
+{
+	ParallelClone *parallel = (ParallelClone *) userData;
+
+	while(true) {
+		int taskIndex = __atomic_fetch_add(&parallel->nextTask, 1, __ATOMIC_RELAXED);
+		if(taskIndex >= parallel->numTasks) {
+			return NULL;
+		}
+
+		CloneTask *task = &parallel->tasks[taskIndex];
+		task->clone = cloneStore(task->source, NULL);
+	}
+}
+
+/**
+ * Counts the stores in a subtree, with each element of a packed array counting as one store
+ *
+ * @param store			the root of the subtree to count
+ * @param limit			the count at which to stop counting
+ * @result				the number of stores in the subtree, or a number of at least the limit
+ */
+static int countStores(Store *store, int limit)
+{
+	int count = 1;
+	switch(store->type) {
+		case STORE_LIST:
+			for(GList *iter = store->content.listValue->head; iter != NULL && count < limit; iter = iter->next) {
+				count += countStores((Store *) iter->data, limit - count);
+			}
+		break;
+		case STORE_MAP:
+		{
+			StoreMapIterator iterator;
+			Store *value;
+			storeMapIteratorInit(&iterator, store);
+			while(count < limit && storeMapIteratorNext(&iterator, NULL, &value)) {
+				count += countStores(value, limit - count);
+			}
+		}
+		break;
+		case STORE_INT_ARRAY:
+		case STORE_FLOAT_ARRAY:
+			count += store->content.arrayValue->length;
+		break;
+		default:
+		break;
+	}
+
+	return count;
+}
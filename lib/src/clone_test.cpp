@@ -0,0 +1,66 @@
+#include <string>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "clone.c"
+
+TEST(Clone, deepCopy)
+{
+	StoreParser *parser = storeCreateParser();
+	Store *store = storeParse(parser, "servers = [{name = alpha, ports = [80 443]} {name = beta}]; timeout = 1.5");
+	ASSERT_TRUE(store != NULL) << "test store should parse successfully";
+	storeFreeze(store);
+
+	Store *clone = storeClone(store, 0);
+	ASSERT_NE(clone, store) << "clone should be a new store";
+	ASSERT_FALSE(storeMapIsFrozen(clone)) << "clone of a frozen map should be modifiable";
+	ASSERT_EQ(storeMapGetSize(clone), 2) << "clone should have the same entries";
+	ASSERT_EQ(storeMapLookup(clone, "timeout")->content.floatValue, 1.5) << "cloned float should be equal";
+
+	Store *servers = storeMapLookup(clone, "servers");
+	ASSERT_NE(servers, storeMapLookup(store, "servers")) << "nested stores should be copied";
+	ASSERT_EQ(storeListGetLength(servers), 2) << "cloned list should have the same length";
+	Store *alpha = storeListGet(servers, 0);
+	ASSERT_STREQ(storeMapLookup(alpha, "name")->content.stringValue, "alpha") << "cloned string should be equal";
+	ASSERT_EQ(storeListGetLength(storeMapLookup(alpha, "ports")), 2) << "cloned nested list should have the same length";
+
+	ASSERT_TRUE(storeMapInsert(alpha, "tls", storeCreateIntValue(1))) << "clone should be modifiable";
+	ASSERT_EQ(storeMapGetSize(storeListGet(storeMapLookup(store, "servers"), 0)), 2) << "modifying the clone should not modify the store";
+
+	storeFree(clone);
+	storeFree(store);
+	storeFreeParser(parser);
+}
+
+TEST(Clone, parallel)
+{
+	// two large subtrees are cloned by workers, the small ones in between by the calling thread
+	Store *store = storeCreateListValue();
+	for(int i = 0; i < 4; i++) {
+		Store *child = storeCreateMapValue();
+		int numEntries = i % 2 == 0 ? 5000 : 3;
+		for(int j = 0; j < numEntries; j++) {
+			storeMapInsert(child, std::to_string(j).c_str(), storeCreateIntValue(i * j));
+		}
+		storeListAppend(store, child);
+	}
+
+	Store *clone = storeClone(store, STORE_CLONE_PARALLEL);
+	ASSERT_EQ(storeListGetLength(clone), 4) << "parallel clone should have the same length";
+	for(int i = 0; i < 4; i++) {
+		Store *child = storeListGet(clone, i);
+		ASSERT_TRUE(child != NULL) << "every child should be cloned";
+		ASSERT_NE(child, storeListGet(store, i)) << "every child should be copied";
+		ASSERT_EQ(storeMapGetSize(child), i % 2 == 0 ? 5000 : 3) << "cloned children should have the same size";
+		ASSERT_EQ(storeMapLookup(child, "2")->content.intValue, 2 * i) << "cloned values should be equal";
+	}
+
+	storeFree(clone);
+	storeFree(store);
+}
@@ -0,0 +1,468 @@
+#include <stdlib.h> // qsort
+#include <string.h> // strcmp memcpy
+
+#include <glib.h>
+
+#include "store/compact.h"
+#include "store/list.h"
+#include "store/map.h"
+#include "store/memory.h"
+
+/**
+ * Bits set in every boxed value, which makes it a negative quiet NaN. Plain doubles never have them all set, since
+ * NaNs are stored as the positive canonical NaN.
+ */
+static const uint64_t boxBits = 0xFFF8000000000000ull;
+static const uint64_t tagBits = 0x0007000000000000ull;
+static const uint64_t payloadBits = 0x0000FFFFFFFFFFFFull;
+static const int tagShift = 48;
+static const uint64_t canonicalNaN = 0x7FF8000000000000ull;
+
+/**
+ * Tags of the boxed values, zero is reserved for the negative canonical NaN
+ */
+static const int intTag = 1;
+static const int stringTag = 2;
+static const int listTag = 3;
+static const int mapTag = 4;
+static const int missingTag = 5;
+
+/**
+ * The size of the arena chunks that nodes are allocated from
+ */
+static const size_t chunkSize = 64 * 1024;
+
+/**
+ * Maps with up to this many entries are searched linearly and don't allocate sorted hash slots
+ */
+static const int smallCompactMapThreshold = 8;
+
+typedef struct ArenaChunkStruct {
+	struct ArenaChunkStruct *next;
+	/** The number of usable bytes after the chunk header */
+	size_t capacity;
+	/** The number of bytes already allocated from the chunk */
+	size_t used;
+} ArenaChunk;
+
+typedef struct {
+	int length;
+	StoreValue *values;
+} CompactList;
+
+typedef struct {
+	const char *key;
+	StoreValue value;
+} CompactEntry;
+
+typedef struct {
+	unsigned int hash;
+	/** The position of the entry with this hash */
+	int position;
+} CompactSlot;
+
+typedef struct {
+	int size;
+	/** The entries in insertion order */
+	CompactEntry *entries;
+	/** The entry positions sorted by key hash for binary search, NULL for small maps */
+	CompactSlot *slots;
+} CompactMap;
+
+struct StoreCompactStruct {
+	StoreValue root;
+	/** The arena chunks, the most recent one first */
+	ArenaChunk *chunks;
+	/** The total number of bytes allocated for the arena */
+	size_t size;
+};
+
+static bool compactStore(StoreCompact *compact, Store *store, StoreValue *value);
+static StoreValue compactString(StoreCompact *compact, const char *string, int length);
+static bool compactList(StoreCompact *compact, Store *store, StoreValue *value);
+static bool compactMap(StoreCompact *compact, Store *store, StoreValue *value);
+static void *allocateNode(StoreCompact *compact, size_t bytes);
+static StoreValue boxValue(int tag, uint64_t payload);
+static StoreValue boxPointer(int tag, void *pointer);
+static int getTag(StoreValue value);
+static void *unboxPointer(StoreValue value);
+static StoreValue encodeFloat(double floatValue);
+static double decodeFloat(StoreValue value);
+static int compareSlots(const void *first, const void *second);
+
+StoreCompact *storeCreateCompact(Store *store)
+{
+	StoreCompact *compact = storeAllocateMemoryType(StoreCompact);
+	compact->chunks = NULL;
+	compact->size = 0;
+
+	if(!compactStore(compact, store, &compact->root)) {
+		storeFreeCompact(compact);
+		return NULL;
+	}
+
+	return compact;
+}
+
+void storeFreeCompact(StoreCompact *compact)
+{
+	ArenaChunk *chunk = compact->chunks;
+	while(chunk != NULL) {
+		ArenaChunk *next = chunk->next;
+		storeFreeMemory(chunk);
+		chunk = next;
+	}
+
+	storeFreeMemory(compact);
+}
+
+StoreValue storeCompactGetRoot(StoreCompact *compact)
+{
+	return compact->root;
+}
+
+size_t storeCompactGetSize(StoreCompact *compact)
+{
+	return compact->size;
+}
+
+bool storeValueGetType(StoreValue value, StoreType *type)
+{
+	int tag = getTag(value);
+	if(tag == missingTag) {
+		return false;
+	} else if(tag == intTag) {
+		*type = STORE_INT;
+	} else if(tag == stringTag) {
+		*type = STORE_STRING;
+	} else if(tag == listTag) {
+		*type = STORE_LIST;
+	} else if(tag == mapTag) {
+		*type = STORE_MAP;
+	} else {
+		// every other value is an unboxed double
+		*type = STORE_FLOAT;
+	}
+
+	return true;
+}
+
+bool storeValueIsMissing(StoreValue value)
+{
+	return getTag(value) == missingTag;
+}
+
+int storeValueGetInt(StoreValue value, int defaultValue)
+{
+	if(getTag(value) != intTag) {
+		return defaultValue;
+	}
+
+	return (int) (uint32_t) (value & payloadBits);
+}
+
+double storeValueGetFloat(StoreValue value, double defaultValue)
+{
+	int tag = getTag(value);
+	if(tag == intTag) {
+		return storeValueGetInt(value, 0);
+	} else if(tag != 0) {
+		return defaultValue;
+	}
+
+	return decodeFloat(value);
+}
+
+const char *storeValueGetString(StoreValue value)
+{
+	if(getTag(value) != stringTag) {
+		return NULL;
+	}
+
+	return (const char *) unboxPointer(value);
+}
+
+int storeValueGetLength(StoreValue value)
+{
+	int tag = getTag(value);
+	if(tag == listTag) {
+		return ((CompactList *) unboxPointer(value))->length;
+	} else if(tag == mapTag) {
+		return ((CompactMap *) unboxPointer(value))->size;
+	}
+
+	return -1;
+}
+
+StoreValue storeValueGetElement(StoreValue value, int index)
+{
+	if(getTag(value) != listTag) {
+		return boxValue(missingTag, 0);
+	}
+
+	CompactList *list = (CompactList *) unboxPointer(value);
+	if(index < 0 || index >= list->length) {
+		return boxValue(missingTag, 0);
+	}
+
+	return list->values[index];
+}
+
+StoreValue storeValueLookup(StoreValue value, const char *key)
+{
+	if(getTag(value) != mapTag) {
+		return boxValue(missingTag, 0);
+	}
+
+	CompactMap *map = (CompactMap *) unboxPointer(value);
+	if(map->slots == NULL) {
+		for(int i = 0; i < map->size; i++) {
+			if(strcmp(map->entries[i].key, key) == 0) {
+				return map->entries[i].value;
+			}
+		}
+
+		return boxValue(missingTag, 0);
+	}
+
+	unsigned int hash = storeHashString(key);
+
+	// find the first slot with the hash, then check all slots sharing it
+	int low = 0;
+	int high = map->size;
+	while(low < high) {
+		int middle = low + (high - low) / 2;
+		if(map->slots[middle].hash < hash) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	for(int i = low; i < map->size && map->slots[i].hash == hash; i++) {
+		CompactEntry *entry = &map->entries[map->slots[i].position];
+		if(strcmp(entry->key, key) == 0) {
+			return entry->value;
+		}
+	}
+
+	return boxValue(missingTag, 0);
+}
+
+bool storeValueGetEntry(StoreValue value, int index, const char **key, StoreValue *entryValue)
+{
+	if(getTag(value) != mapTag) {
+		return false;
+	}
+
+	CompactMap *map = (CompactMap *) unboxPointer(value);
+	if(index < 0 || index >= map->size) {
+		return false;
+	}
+
+	if(key != NULL) {
+		*key = map->entries[index].key;
+	}
+	if(entryValue != NULL) {
+		*entryValue = map->entries[index].value;
+	}
+
+	return true;
+}
+
+/**
+ * Recursively copies a store into a compact value
+ *
+ * @param compact		the compact copy to allocate nodes from
+ * @param store			the store to copy
+ * @param value			pointer to be set to the compact value
+ * @result				true if the store was copied, false if it contains a table
+ */
+static bool compactStore(StoreCompact *compact, Store *store, StoreValue *value)
+{
+	switch(store->type) {
+		case STORE_STRING:
+			*value = compactString(compact, store->content.stringValue, storeGetStringLength(store));
+			return true;
+		case STORE_INT:
+			*value = boxValue(intTag, (uint32_t) store->content.intValue);
+			return true;
+		case STORE_FLOAT:
+			*value = encodeFloat(store->content.floatValue);
+			return true;
+		case STORE_LIST:
+		case STORE_INT_ARRAY:
+		case STORE_FLOAT_ARRAY:
+			return compactList(compact, store, value);
+		case STORE_MAP:
+			return compactMap(compact, store, value);
+		default:
+			return false;
+	}
+}
+
+static StoreValue compactString(StoreCompact *compact, const char *string, int length)
+{
+	char *copy = (char *) allocateNode(compact, length + 1);
+	memcpy(copy, string, length + 1);
+	return boxPointer(stringTag, copy);
+}
+
+static bool compactList(StoreCompact *compact, Store *store, StoreValue *value)
+{
+	int length = storeListGetLength(store);
+	CompactList *list = (CompactList *) allocateNode(compact, sizeof(CompactList));
+	list->length = length;
+	list->values = (StoreValue *) allocateNode(compact, length * sizeof(StoreValue));
+
+	if(store->type == STORE_INT_ARRAY) {
+		for(int i = 0; i < length; i++) {
+			list->values[i] = boxValue(intTag, (uint32_t) store->content.arrayValue->intValues[i]);
+		}
+	} else if(store->type == STORE_FLOAT_ARRAY) {
+		for(int i = 0; i < length; i++) {
+			list->values[i] = encodeFloat(store->content.arrayValue->floatValues[i]);
+		}
+	} else {
+		int i = 0;
+		for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+			if(!compactStore(compact, (Store *) iter->data, &list->values[i])) {
+				return false;
+			}
+			i++;
+		}
+	}
+
+	*value = boxPointer(listTag, list);
+	return true;
+}
+
+static bool compactMap(StoreCompact *compact, Store *store, StoreValue *value)
+{
+	int size = storeMapGetSize(store);
+	CompactMap *map = (CompactMap *) allocateNode(compact, sizeof(CompactMap));
+	map->size = size;
+	map->entries = (CompactEntry *) allocateNode(compact, size * sizeof(CompactEntry));
+	map->slots = NULL;
+
+	int i = 0;
+	const char *key;
+	Store *entryValue;
+	StoreMapIterator iterator;
+	storeMapIteratorInit(&iterator, store);
+	while(storeMapIteratorNext(&iterator, &key, &entryValue)) {
+		map->entries[i].key = storeValueGetString(compactString(compact, key, strlen(key)));
+		if(!compactStore(compact, entryValue, &map->entries[i].value)) {
+			return false;
+		}
+		i++;
+	}
+
+	if(size > smallCompactMapThreshold) {
+		map->slots = (CompactSlot *) allocateNode(compact, size * sizeof(CompactSlot));
+		for(int j = 0; j < size; j++) {
+			map->slots[j].hash = storeHashString(map->entries[j].key);
+			map->slots[j].position = j;
+		}
+
+		qsort(map->slots, size, sizeof(CompactSlot), compareSlots);
+	}
+
+	*value = boxPointer(mapTag, map);
+	return true;
+}
+
+/**
+ * Allocates memory for a node from the arena of a compact copy
+ *
+ * @param compact		the compact copy to allocate from
+ * @param bytes			the number of bytes to allocate
+ * @result				the allocated memory, aligned to 8 bytes
+ */
+static void *allocateNode(StoreCompact *compact, size_t bytes)
+{
+	bytes = (bytes + 7) & ~((size_t) 7);
+
+	ArenaChunk *chunk = compact->chunks;
+	if(chunk == NULL || chunk->used + bytes > chunk->capacity) {
+		// large nodes get a chunk of their own so that the current chunk can still be filled up
+		size_t capacity = bytes > chunkSize / 4 ? bytes : chunkSize;
+		ArenaChunk *newChunk = (ArenaChunk *) storeAllocateMemory(sizeof(ArenaChunk) + capacity);
+		newChunk->capacity = capacity;
+		newChunk->used = 0;
+		compact->size += sizeof(ArenaChunk) + capacity;
+
+		if(chunk != NULL && capacity != chunkSize) {
+			newChunk->next = chunk->next;
+			chunk->next = newChunk;
+		} else {
+			newChunk->next = chunk;
+			compact->chunks = newChunk;
+		}
+
+		chunk = newChunk;
+	}
+
+	void *memory = (char *) (chunk + 1) + chunk->used;
+	chunk->used += bytes;
+	return memory;
+}
+
+static StoreValue boxValue(int tag, uint64_t payload)
+{
+	return boxBits | ((uint64_t) tag << tagShift) | (payload & payloadBits);
+}
+
+/**
+ * Boxes a pointer, which must fit into the 48 payload bits as user space pointers do on all common 64-bit platforms
+ */
+static StoreValue boxPointer(int tag, void *pointer)
+{
+	return boxValue(tag, (uint64_t) (uintptr_t) pointer);
+}
+
+/**
+ * Returns the tag of a value, or zero for floats
+ */
+static int getTag(StoreValue value)
+{
+	if((value & boxBits) != boxBits) {
+		return 0;
+	}
+
+	return (int) ((value & tagBits) >> tagShift);
+}
+
+static void *unboxPointer(StoreValue value)
+{
+	return (void *) (uintptr_t) (value & payloadBits);
+}
+
+static StoreValue encodeFloat(double floatValue)
+{
+	if(floatValue != floatValue) {
+		return canonicalNaN;
+	}
+
+	StoreValue value;
+	memcpy(&value, &floatValue, sizeof(double));
+	return value;
+}
+
+static double decodeFloat(StoreValue value)
+{
+	double floatValue;
+	memcpy(&floatValue, &value, sizeof(double));
+	return floatValue;
+}
+
+static int compareSlots(const void *first, const void *second)
+{
+	const CompactSlot *firstSlot = (const CompactSlot *) first;
+	const CompactSlot *secondSlot = (const CompactSlot *) second;
+	if(firstSlot->hash != secondSlot->hash) {
+		return firstSlot->hash < secondSlot->hash ? -1 : 1;
+	}
+
+	return firstSlot->position - secondSlot->position;
+}
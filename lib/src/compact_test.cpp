@@ -0,0 +1,103 @@
+#include <cmath>
+#include <string>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "compact.c"
+
+static StoreType getValueType(StoreValue value)
+{
+	StoreType type = STORE_STRING;
+	EXPECT_TRUE(storeValueGetType(value, &type)) << "value should have a type";
+	return type;
+}
+
+TEST(Compact, scalars)
+{
+	Store *store = storeCreateListValue();
+	storeListAppend(store, storeCreateIntValue(-42));
+	storeListAppend(store, storeCreateFloatValue(-1.5));
+	storeListAppend(store, storeCreateFloatValue(NAN));
+	storeListAppend(store, storeCreateFloatValue(-INFINITY));
+	storeListAppend(store, storeCreateStringValue("foo"));
+
+	StoreCompact *compact = storeCreateCompact(store);
+	ASSERT_TRUE(compact != NULL) << "list of scalars should be compacted";
+
+	StoreValue root = storeCompactGetRoot(compact);
+	ASSERT_EQ(getValueType(root), STORE_LIST) << "compacted list should be a list";
+	ASSERT_EQ(storeValueGetLength(root), 5) << "compacted list should keep its length";
+
+	ASSERT_EQ(getValueType(storeValueGetElement(root, 0)), STORE_INT) << "int should be boxed as an int";
+	ASSERT_EQ(storeValueGetInt(storeValueGetElement(root, 0), 0), -42) << "negative int should survive boxing";
+	ASSERT_EQ(storeValueGetFloat(storeValueGetElement(root, 0), 0), -42) << "int should be converted to float";
+	ASSERT_EQ(getValueType(storeValueGetElement(root, 1)), STORE_FLOAT) << "float should be stored as a float";
+	ASSERT_EQ(storeValueGetFloat(storeValueGetElement(root, 1), 0), -1.5) << "float should be stored unchanged";
+	ASSERT_EQ(getValueType(storeValueGetElement(root, 2)), STORE_FLOAT) << "NaN should not be mistaken for a boxed value";
+	ASSERT_TRUE(std::isnan(storeValueGetFloat(storeValueGetElement(root, 2), 0))) << "NaN should be stored as NaN";
+	ASSERT_EQ(storeValueGetFloat(storeValueGetElement(root, 3), 0), -INFINITY) << "infinity should be stored unchanged";
+	ASSERT_STREQ(storeValueGetString(storeValueGetElement(root, 4)), "foo") << "string should be copied";
+	ASSERT_EQ(storeValueGetInt(storeValueGetElement(root, 4), 7), 7) << "string should not be returned as int";
+	ASSERT_TRUE(storeValueIsMissing(storeValueGetElement(root, 5))) << "out of bounds element should be missing";
+	StoreType type;
+	ASSERT_FALSE(storeValueGetType(storeValueGetElement(root, 5), &type)) << "missing value should not have a type";
+
+	storeFreeCompact(compact);
+	storeFree(store);
+}
+
+TEST(Compact, nested)
+{
+	StoreParser *parser = storeCreateParser();
+	storeSetParserFlags(parser, STORE_PARSE_PACK_LISTS);
+	Store *store = storeParse(parser, "servers = [{name = alpha, ports = [80 443]} {name = beta, weights = [0.5 1.5]}]; \"empty\" = {}");
+	ASSERT_TRUE(store != NULL) << "test store should parse successfully";
+
+	StoreCompact *compact = storeCreateCompact(store);
+	ASSERT_TRUE(compact != NULL) << "nested store should be compacted";
+
+	StoreValue root = storeCompactGetRoot(compact);
+	StoreValue servers = storeValueLookup(root, "servers");
+	ASSERT_EQ(getValueType(servers), STORE_LIST) << "nested list should be found";
+	StoreValue beta = storeValueGetElement(servers, 1);
+	ASSERT_STREQ(storeValueGetString(storeValueLookup(beta, "name")), "beta") << "nested string should be found";
+	ASSERT_EQ(storeValueGetFloat(storeValueGetElement(storeValueLookup(beta, "weights"), 1), 0), 1.5) << "packed float array should be compacted";
+	ASSERT_EQ(storeValueGetInt(storeValueGetElement(storeValueLookup(storeValueGetElement(servers, 0), "ports"), 1), 0), 443) << "packed int array should be compacted";
+	ASSERT_EQ(storeValueGetLength(storeValueLookup(root, "empty")), 0) << "empty map should be compacted";
+	ASSERT_TRUE(storeValueIsMissing(storeValueLookup(beta, "ports"))) << "missing key should be missing";
+
+	const char *key;
+	StoreValue value;
+	ASSERT_TRUE(storeValueGetEntry(root, 1, &key, &value)) << "map entry should be readable";
+	ASSERT_STREQ(key, "empty") << "map entries should keep insertion order";
+
+	storeFreeCompact(compact);
+	storeFree(store);
+	storeFreeParser(parser);
+}
+
+TEST(Compact, largeMap)
+{
+	Store *store = storeCreateMapValue();
+	for(int i = 0; i < 1000; i++) {
+		std::string key = "key" + std::to_string(i);
+		storeMapInsert(store, key.c_str(), storeCreateIntValue(i));
+	}
+
+	StoreCompact *compact = storeCreateCompact(store);
+	StoreValue root = storeCompactGetRoot(compact);
+	for(int i = 0; i < 1000; i++) {
+		std::string key = "key" + std::to_string(i);
+		ASSERT_EQ(storeValueGetInt(storeValueLookup(root, key.c_str()), -1), i) << "key " << key << " should be found in a large map";
+	}
+	ASSERT_TRUE(storeValueIsMissing(storeValueLookup(root, "key1000"))) << "missing key should be missing";
+
+	storeFreeCompact(compact);
+	storeFree(store);
+}
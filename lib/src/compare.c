@@ -0,0 +1,349 @@
+#include <stdbool.h> // bool true false
+#include <string.h> // memcmp memcpy strlen
+
+#include <glib.h>
+
+#include "store/compare.h"
+#include "store/list.h"
+#include "store/map.h"
+#include "store/table.h"
+
+/**
+ * Seeds distinguishing the hashes of the different kinds of stores
+ */
+static const uint64_t intSeed = 0x9e3779b97f4a7c15ull;
+static const uint64_t floatSeed = 0xc2b2ae3d27d4eb4full;
+static const uint64_t stringSeed = 0x165667b19e3779f9ull;
+static const uint64_t listSeed = 0x27d4eb2f165667c5ull;
+static const uint64_t mapSeed = 0x85ebca77c2b2ae63ull;
+static const uint64_t tableSeed = 0xff51afd7ed558ccdull;
+static const uint64_t nullSeed = 0xc4ceb9fe1a85ec53ull;
+
+static bool isList(Store *store);
+static bool equalLists(Store *first, Store *second);
+static bool equalMaps(Store *first, Store *second);
+static bool equalTables(Store *first, Store *second);
+static bool equalFloats(double first, double second);
+static uint64_t getCachedHash(Store *store);
+static uint64_t hashList(Store *store);
+static uint64_t hashMap(Store *store);
+static uint64_t hashTable(Store *store);
+static uint64_t hashInt(int value);
+static uint64_t hashFloat(double value);
+static uint64_t hashBytes(uint64_t hash, const void *data, size_t size);
+static uint64_t mix(uint64_t hash);
+
+bool storeEquals(Store *first, Store *second)
+{
+	if(first == second) {
+		return true;
+	}
+
+	if(first->type != second->type && !(isList(first) && isList(second))) {
+		return false;
+	}
+
+	uint64_t firstHash = getCachedHash(first);
+	uint64_t secondHash = getCachedHash(second);
+	if(firstHash != 0 && secondHash != 0 && firstHash != secondHash) {
+		return false;
+	}
+
+	switch(first->type) {
+		case STORE_STRING:
+		{
+			int length = storeGetStringLength(first);
+			return length == storeGetStringLength(second) && memcmp(first->content.stringValue, second->content.stringValue, length) == 0;
+		}
+		case STORE_INT:
+			return first->content.intValue == second->content.intValue;
+		case STORE_FLOAT:
+			return equalFloats(first->content.floatValue, second->content.floatValue);
+		case STORE_MAP:
+			return equalMaps(first, second);
+		case STORE_TABLE:
+			return equalTables(first, second);
+		default:
+			return equalLists(first, second);
+	}
+}
+
+uint64_t storeHash(Store *store)
+{
+	switch(store->type) {
+		case STORE_STRING:
+			return mix(hashBytes(stringSeed, store->content.stringValue, storeGetStringLength(store)));
+		case STORE_INT:
+			return hashInt(store->content.intValue);
+		case STORE_FLOAT:
+			return hashFloat(store->content.floatValue);
+		case STORE_MAP:
+			return hashMap(store);
+		case STORE_TABLE:
+			return hashTable(store);
+		default:
+			return hashList(store);
+	}
+}
+
+/**
+ * Returns whether a store is a generic list or a packed array
+ */
+static bool isList(Store *store)
+{
+	return store->type == STORE_LIST || store->type == STORE_INT_ARRAY || store->type == STORE_FLOAT_ARRAY;
+}
+
+/**
+ * Compares two list stores element by element, each of which may be a generic list or a packed array
+ */
+static bool equalLists(Store *first, Store *second)
+{
+	int length = storeListGetLength(first);
+	if(length != storeListGetLength(second)) {
+		return false;
+	}
+
+	// walk generic lists link by link, since looking up their elements by index takes linear time
+	GList *firstLink = first->type == STORE_LIST ? first->content.listValue->head : NULL;
+	GList *secondLink = second->type == STORE_LIST ? second->content.listValue->head : NULL;
+	for(int i = 0; i < length; i++) {
+		Store firstBuffer;
+		Store secondBuffer;
+		Store *firstElement = &firstBuffer;
+		Store *secondElement = &secondBuffer;
+
+		if(firstLink != NULL) {
+			firstElement = (Store *) firstLink->data;
+			firstLink = firstLink->next;
+		} else {
+			storeListGetElement(first, i, &firstBuffer);
+		}
+
+		if(secondLink != NULL) {
+			secondElement = (Store *) secondLink->data;
+			secondLink = secondLink->next;
+		} else {
+			storeListGetElement(second, i, &secondBuffer);
+		}
+
+		if(!storeEquals(firstElement, secondElement)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Compares two map stores regardless of the order of their entries
+ */
+static bool equalMaps(Store *first, Store *second)
+{
+	if(storeMapGetSize(first) != storeMapGetSize(second)) {
+		return false;
+	}
+
+	StoreMapIterator iterator;
+	const char *key;
+	Store *value;
+	storeMapIteratorInit(&iterator, first);
+	while(storeMapIteratorNext(&iterator, &key, &value)) {
+		Store *otherValue = storeMapLookup(second, key);
+		if(otherValue == NULL || !storeEquals(value, otherValue)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Compares two table stores cell by cell regardless of the order of their columns
+ */
+static bool equalTables(Store *first, Store *second)
+{
+	int numRows = storeTableGetNumRows(first);
+	int numColumns = storeTableGetNumColumns(first);
+	if(numRows != storeTableGetNumRows(second) || numColumns != storeTableGetNumColumns(second)) {
+		return false;
+	}
+
+	for(int column = 0; column < numColumns; column++) {
+		int otherColumn = storeTableFindColumn(second, storeTableGetColumnName(first, column));
+		if(otherColumn < 0) {
+			return false;
+		}
+
+		for(int row = 0; row < numRows; row++) {
+			Store value;
+			Store otherValue;
+			bool present = storeTableGetValue(first, column, row, &value);
+			if(present != storeTableGetValue(second, otherColumn, row, &otherValue)) {
+				return false;
+			}
+
+			if(present && !storeEquals(&value, &otherValue)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool equalFloats(double first, double second)
+{
+	return first == second || (first != first && second != second);
+}
+
+/**
+ * Returns the hash cached in a frozen map or list, or zero if none was cached
+ */
+static uint64_t getCachedHash(Store *store)
+{
+	switch(store->type) {
+		case STORE_LIST:
+			return storeListGetCachedHash(store->content.listValue);
+		case STORE_MAP:
+			return storeMapGetCachedHash(store->content.mapValue);
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Hashes a list store in element order, such that generic lists and packed arrays with equal elements hash equally
+ */
+static uint64_t hashList(Store *store)
+{
+	uint64_t hash = getCachedHash(store);
+	if(hash != 0) {
+		return hash;
+	}
+
+	hash = listSeed;
+	switch(store->type) {
+		case STORE_LIST:
+			for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+				hash = mix(hash + storeHash((Store *) iter->data));
+			}
+		break;
+		case STORE_INT_ARRAY:
+			for(int i = 0; i < store->content.arrayValue->length; i++) {
+				hash = mix(hash + hashInt(store->content.arrayValue->intValues[i]));
+			}
+		break;
+		case STORE_FLOAT_ARRAY:
+			for(int i = 0; i < store->content.arrayValue->length; i++) {
+				hash = mix(hash + hashFloat(store->content.arrayValue->floatValues[i]));
+			}
+		break;
+		default:
+		break;
+	}
+
+	hash = mix(hash ^ (uint64_t) storeListGetLength(store));
+
+	if(store->type == STORE_LIST) {
+		storeListCacheHash(store->content.listValue, hash);
+	}
+
+	return hash;
+}
+
+/**
+ * Hashes a map store by summing up the hashes of its entries, which doesn't depend on their order
+ */
+static uint64_t hashMap(Store *store)
+{
+	uint64_t hash = getCachedHash(store);
+	if(hash != 0) {
+		return hash;
+	}
+
+	uint64_t sum = 0;
+	StoreMapIterator iterator;
+	const char *key;
+	Store *value;
+	storeMapIteratorInit(&iterator, store);
+	while(storeMapIteratorNext(&iterator, &key, &value)) {
+		uint64_t keyHash = hashBytes(stringSeed, key, strlen(key));
+		sum += mix(keyHash ^ mix(storeHash(value) + mapSeed));
+	}
+
+	hash = mix(mapSeed ^ sum ^ (uint64_t) storeMapGetSize(store));
+	storeMapCacheHash(store->content.mapValue, hash);
+	return hash;
+}
+
+/**
+ * Hashes a table store column by column, summing up the column hashes so that they don't depend on the column order
+ */
+static uint64_t hashTable(Store *store)
+{
+	int numRows = storeTableGetNumRows(store);
+	int numColumns = storeTableGetNumColumns(store);
+
+	uint64_t sum = 0;
+	for(int column = 0; column < numColumns; column++) {
+		const char *name = storeTableGetColumnName(store, column);
+		uint64_t hash = hashBytes(stringSeed, name, strlen(name));
+		for(int row = 0; row < numRows; row++) {
+			Store value;
+			hash = mix(hash + (storeTableGetValue(store, column, row, &value) ? storeHash(&value) : nullSeed));
+		}
+
+		sum += mix(hash);
+	}
+
+	return mix(tableSeed ^ sum ^ (uint64_t) numRows);
+}
+
+static uint64_t hashInt(int value)
+{
+	return mix(intSeed ^ (uint64_t) (int64_t) value);
+}
+
+/**
+ * Hashes a float such that all zeros and all NaNs, which are equal according to storeEquals, hash equally
+ */
+static uint64_t hashFloat(double value)
+{
+	if(value == 0) {
+		value = 0;
+	} else if(value != value) {
+		return mix(floatSeed ^ nullSeed);
+	}
+
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(double));
+	return mix(floatSeed ^ bits);
+}
+
+/**
+ * Continues a 64-bit FNV-1a hash over a block of bytes
+ */
+static uint64_t hashBytes(uint64_t hash, const void *data, size_t size)
+{
+	const unsigned char *bytes = (const unsigned char *) data;
+	for(size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+
+	return hash;
+}
+
+/**
+ * Mixes the bits of a hash using the 64-bit MurmurHash3 finalizer
+ */
+static uint64_t mix(uint64_t hash)
+{
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ull;
+	hash ^= hash >> 33;
+	return hash;
+}
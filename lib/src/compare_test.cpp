@@ -0,0 +1,104 @@
+#include <cmath>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "compare.c"
+
+class Compare: public ::testing::Test {
+public:
+	virtual void SetUp() {
+		parser = storeCreateParser();
+	}
+
+	virtual void TearDown() {
+		storeFreeParser(parser);
+	}
+
+protected:
+	Store *parse(const char *input, int flags = 0) {
+		storeSetParserFlags(parser, flags);
+		Store *store = storeParse(parser, input);
+		EXPECT_TRUE(store != NULL) << "test store '" << input << "' should parse successfully";
+		return store;
+	}
+
+	void expectEqual(const char *first, const char *second, bool equal, int secondFlags = 0) {
+		Store *firstStore = parse(first);
+		Store *secondStore = parse(second, secondFlags);
+		EXPECT_EQ(storeEquals(firstStore, secondStore), equal) << "comparing '" << first << "' with '" << second << "' should be " << equal;
+		EXPECT_EQ(storeEquals(secondStore, firstStore), equal) << "comparing '" << second << "' with '" << first << "' should be " << equal;
+		if(equal) {
+			EXPECT_EQ(storeHash(firstStore), storeHash(secondStore)) << "equal stores '" << first << "' and '" << second << "' should hash equally";
+		} else {
+			EXPECT_NE(storeHash(firstStore), storeHash(secondStore)) << "different stores '" << first << "' and '" << second << "' should hash differently";
+		}
+		storeFree(firstStore);
+		storeFree(secondStore);
+	}
+
+	StoreParser *parser;
+};
+
+TEST_F(Compare, equals)
+{
+	expectEqual("a = 1; b = [x y]", "b = [x y]; a = 1", true);
+	expectEqual("a = 1; b = [x y]", "a = 1; b = [y x]", false);
+	expectEqual("a = 1", "a = 1; b = 2", false);
+	expectEqual("a = 1", "b = 1", false);
+	expectEqual("[1 2 3]", "[1 2 3]", true, STORE_PARSE_PACK_LISTS);
+	expectEqual("[1.5 2.5]", "[1.5 2.5]", true, STORE_PARSE_PACK_LISTS);
+	expectEqual("[1 2 3]", "[1 2 4]", false, STORE_PARSE_PACK_LISTS);
+	expectEqual("[1 2]", "[1.0 2.0]", false);
+	expectEqual("a = \"1\"", "a = 1", false);
+	expectEqual("a = {b = {c = [1 {d = e}]}}", "a = {b = {c = [1 {d = e}]}}", true);
+	expectEqual("a = {b = {c = [1 {d = e}]}}", "a = {b = {c = [1 {d = f}]}}", false);
+}
+
+TEST_F(Compare, floats)
+{
+	Store *zero = storeCreateFloatValue(0.0);
+	Store *negativeZero = storeCreateFloatValue(-0.0);
+	Store *nan = storeCreateFloatValue(NAN);
+	Store *otherNan = storeCreateFloatValue(-NAN);
+
+	ASSERT_TRUE(storeEquals(zero, negativeZero)) << "zeros of different signs should be equal";
+	ASSERT_EQ(storeHash(zero), storeHash(negativeZero)) << "zeros of different signs should hash equally";
+	ASSERT_TRUE(storeEquals(nan, otherNan)) << "NaNs should be equal to each other";
+	ASSERT_EQ(storeHash(nan), storeHash(otherNan)) << "NaNs should hash equally";
+	ASSERT_FALSE(storeEquals(zero, nan)) << "NaN should not be equal to a number";
+
+	storeFree(zero);
+	storeFree(negativeZero);
+	storeFree(nan);
+	storeFree(otherNan);
+}
+
+TEST_F(Compare, cachedHash)
+{
+	Store *store = parse("servers = [{name = alpha} {name = beta}]; timeout = 3");
+	uint64_t hash = storeHash(store);
+	ASSERT_EQ(storeMapGetCachedHash(store->content.mapValue), 0u) << "hash of an unfrozen map should not be cached";
+
+	storeFreeze(store);
+	ASSERT_EQ(storeHash(store), hash) << "freezing should not change the hash";
+	ASSERT_EQ(storeMapGetCachedHash(store->content.mapValue), hash) << "hash of a frozen map should be cached";
+	Store *servers = storeMapLookup(store, "servers");
+	ASSERT_EQ(storeListGetCachedHash(servers->content.listValue), storeHash(servers)) << "hash of a frozen list should be cached";
+	Store *rejected = storeCreateIntValue(1);
+	ASSERT_FALSE(storeListAppend(servers, rejected)) << "frozen list should reject modifications";
+	storeFree(rejected);
+
+	Store *other = parse("timeout = 3; servers = [{name = alpha} {name = gamma}]");
+	storeFreeze(other);
+	storeHash(other);
+	ASSERT_FALSE(storeEquals(store, other)) << "stores with different cached hashes should not be equal";
+
+	storeFree(store);
+	storeFree(other);
+}
@@ -0,0 +1,239 @@
+#include <stdbool.h> // bool true false
+#include <string.h> // memcmp strcmp strlen
+
+#include <glib.h>
+
+#include "store/dedup.h"
+#include "store/list.h"
+#include "store/map.h"
+
+typedef struct {
+	/**
+	 * set of (Store *) canonical stores, whose children are canonical themselves and therefore compared by identity,
+	 * except for those of shared or frozen stores, which are left as they are
+	 */
+	GHashTable *stores;
+	/** The number of bytes freed by replacing duplicates so far */
+	size_t savedBytes;
+} Deduplication;
+
+static Store *deduplicateStore(Deduplication *deduplication, Store *store);
+static void deduplicateChildren(Deduplication *deduplication, Store *store);
+static guint hashStore(gconstpointer pointer);
+static gboolean equalStores(gconstpointer a, gconstpointer b);
+static guint hashBytes(guint hash, const void *data, size_t size);
+
+size_t storeDeduplicate(Store *store)
+{
+	Deduplication deduplication;
+	deduplication.stores = g_hash_table_new(hashStore, equalStores);
+	deduplication.savedBytes = 0;
+
+	// the root is owned by the caller, so only its descendants can be replaced
+	deduplicateChildren(&deduplication, store);
+
+	g_hash_table_destroy(deduplication.stores);
+	return deduplication.savedBytes;
+}
+
+/**
+ * Deduplicates a store after deduplicating its children
+ *
+ * @param deduplication	the state of the deduplication pass
+ * @param store			the store to deduplicate, ownership is transferred
+ * @result				the canonical store identical to the given one, with ownership transferred to the caller
+ */
+static Store *deduplicateStore(Deduplication *deduplication, Store *store)
+{
+	deduplicateChildren(deduplication, store);
+
+	if(store->type == STORE_TABLE || storeListHasIndexes(store)) {
+		return store;
+	}
+
+	Store *canonical = (Store *) g_hash_table_lookup(deduplication->stores, store);
+	if(canonical == NULL) {
+		g_hash_table_add(deduplication->stores, store);
+		return store;
+	} else if(canonical == store) {
+		// reached again through a store that was already shared
+		return store;
+	}
+
+	// the children of the duplicate are the canonical ones, so only the duplicate's own node is freed
+	if(store->references == 1) {
+		deduplication->savedBytes += storeGetNodeMemorySize(store);
+	}
+
+	storeFree(store);
+	return storeRetain(canonical);
+}
+
+/**
+ * Replaces the children of a store with their canonical stores
+ *
+ * @param deduplication	the state of the deduplication pass
+ * @param store			the store whose children to deduplicate
+ */
+static void deduplicateChildren(Deduplication *deduplication, Store *store)
+{
+	// the children of shared or frozen stores belong to other owners as well, which may be reading them concurrently
+	if(store->references > 1 || storeMapIsFrozen(store) || storeListIsFrozen(store)) {
+		return;
+	}
+
+	if(store->type == STORE_LIST) {
+		// the indexes of a list reference its elements, so those must not be replaced
+		bool keepElements = storeListHasIndexes(store);
+
+		for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+			if(keepElements) {
+				deduplicateChildren(deduplication, (Store *) iter->data);
+			} else {
+				iter->data = deduplicateStore(deduplication, (Store *) iter->data);
+			}
+		}
+	} else if(store->type == STORE_MAP) {
+		StoreMapIterator iterator;
+		Store *value;
+		storeMapIteratorInit(&iterator, store);
+		while(storeMapIteratorNext(&iterator, NULL, &value)) {
+			storeMapIteratorReplace(&iterator, deduplicateStore(deduplication, value));
+		}
+	}
+}
+
+/**
+ * Hashes a store whose children are canonical by its type, its scalar content and the identities of its children
+ */
+static guint hashStore(gconstpointer pointer)
+{
+	Store *store = (Store *) pointer;
+	guint hash = hashBytes(2166136261u, &store->type, sizeof(StoreType));
+
+	switch(store->type) {
+		case STORE_STRING:
+			return hashBytes(hash, store->content.stringValue, storeGetStringLength(store));
+		case STORE_INT:
+			return hashBytes(hash, &store->content.intValue, sizeof(int));
+		case STORE_FLOAT:
+			return hashBytes(hash, &store->content.floatValue, sizeof(double));
+		case STORE_LIST:
+			for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+				hash = hashBytes(hash, &iter->data, sizeof(Store *));
+			}
+			return hash;
+		case STORE_MAP:
+		{
+			StoreMapIterator iterator;
+			const char *key;
+			Store *value;
+			storeMapIteratorInit(&iterator, store);
+			while(storeMapIteratorNext(&iterator, &key, &value)) {
+				hash = hashBytes(hash, key, strlen(key) + 1);
+				hash = hashBytes(hash, &value, sizeof(Store *));
+			}
+			return hash;
+		}
+		case STORE_INT_ARRAY:
+			return hashBytes(hash, store->content.arrayValue->intValues, store->content.arrayValue->length * sizeof(int));
+		case STORE_FLOAT_ARRAY:
+			return hashBytes(hash, store->content.arrayValue->floatValues, store->content.arrayValue->length * sizeof(double));
+		default:
+			return hash;
+	}
+}
+
+/**
+ * Compares two stores whose children are canonical, so that their children only need to be compared by identity
+ */
+static gboolean equalStores(gconstpointer a, gconstpointer b)
+{
+	Store *first = (Store *) a;
+	Store *second = (Store *) b;
+	if(first->type != second->type) {
+		return false;
+	}
+
+	switch(first->type) {
+		case STORE_STRING:
+		{
+			int length = storeGetStringLength(first);
+			return length == storeGetStringLength(second) && memcmp(first->content.stringValue, second->content.stringValue, length) == 0;
+		}
+		case STORE_INT:
+			return first->content.intValue == second->content.intValue;
+		case STORE_FLOAT:
+			// compare the representations so that NaNs can be shared but zeros of different signs are kept apart
+			return memcmp(&first->content.floatValue, &second->content.floatValue, sizeof(double)) == 0;
+		case STORE_LIST:
+		{
+			GList *firstIter = first->content.listValue->head;
+			GList *secondIter = second->content.listValue->head;
+			while(firstIter != NULL && secondIter != NULL) {
+				if(firstIter->data != secondIter->data) {
+					return false;
+				}
+
+				firstIter = firstIter->next;
+				secondIter = secondIter->next;
+			}
+
+			return firstIter == NULL && secondIter == NULL;
+		}
+		case STORE_MAP:
+		{
+			if(storeMapGetSize(first) != storeMapGetSize(second)) {
+				return false;
+			}
+
+			StoreMapIterator firstIterator;
+			StoreMapIterator secondIterator;
+			const char *firstKey;
+			const char *secondKey;
+			Store *firstValue;
+			Store *secondValue;
+			storeMapIteratorInit(&firstIterator, first);
+			storeMapIteratorInit(&secondIterator, second);
+			while(storeMapIteratorNext(&firstIterator, &firstKey, &firstValue)) {
+				storeMapIteratorNext(&secondIterator, &secondKey, &secondValue);
+				if(firstValue != secondValue || strcmp(firstKey, secondKey) != 0) {
+					return false;
+				}
+			}
+
+			return true;
+		}
+		case STORE_INT_ARRAY:
+		case STORE_FLOAT_ARRAY:
+		{
+			StoreArray *firstArray = first->content.arrayValue;
+			StoreArray *secondArray = second->content.arrayValue;
+			if(firstArray->length != secondArray->length) {
+				return false;
+			}
+
+			if(first->type == STORE_INT_ARRAY) {
+				return memcmp(firstArray->intValues, secondArray->intValues, firstArray->length * sizeof(int)) == 0;
+			}
+
+			return memcmp(firstArray->floatValues, secondArray->floatValues, firstArray->length * sizeof(double)) == 0;
+		}
+		default:
+			return false;
+	}
+}
+
+/**
+ * Continues a 32-bit FNV-1a hash over a block of bytes
+ */
+static guint hashBytes(guint hash, const void *data, size_t size)
+{
+	const unsigned char *bytes = (const unsigned char *) data;
+	for(size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
@@ -0,0 +1,104 @@
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "dedup.c"
+
+TEST(Dedup, sharesIdenticalSubtrees)
+{
+	StoreParser *parser = storeCreateParser();
+	Store *store = storeParse(parser, "a = {host = alpha, ports = [80 443]}; b = {host = alpha, ports = [80 443]}; c = {host = beta, ports = [80 443]}");
+	ASSERT_TRUE(store != NULL) << "test store should parse successfully";
+
+	size_t saved = storeDeduplicate(store);
+	ASSERT_GT(saved, 0u) << "deduplicating identical subtrees should free memory";
+
+	Store *a = storeMapLookup(store, "a");
+	Store *b = storeMapLookup(store, "b");
+	Store *c = storeMapLookup(store, "c");
+	ASSERT_EQ(a, b) << "identical maps should be shared";
+	ASSERT_EQ(a->references, 2u) << "shared map should be referenced by both entries";
+	ASSERT_NE(a, c) << "different maps should not be shared";
+	ASSERT_EQ(storeMapLookup(a, "ports"), storeMapLookup(c, "ports")) << "identical lists in different maps should be shared";
+	ASSERT_TRUE(storeListGet(storeMapLookup(a, "ports"), 1) != NULL) << "elements of shared lists should be readable";
+	ASSERT_EQ(storeMapLookup(a, "host"), storeMapLookup(b, "host")) << "identical strings should be shared";
+	ASSERT_STREQ(storeMapLookup(c, "host")->content.stringValue, "beta") << "different strings should be kept";
+
+	ASSERT_EQ(storeDeduplicate(store), 0u) << "deduplicating again should not free anything";
+
+	storeFree(store);
+	storeFreeParser(parser);
+}
+
+TEST(Dedup, sharedStoresAreImmutable)
+{
+	StoreParser *parser = storeCreateParser();
+	Store *store = storeParse(parser, "a = {x = [1 2]}; b = {x = [1 2]}; c = [1 2]");
+	ASSERT_TRUE(store != NULL) << "test store should parse successfully";
+	storeDeduplicate(store);
+
+	Store *a = storeMapLookup(store, "a");
+	Store *value = storeCreateIntValue(3);
+	ASSERT_FALSE(storeMapInsert(a, "y", value)) << "inserting into a shared map should fail";
+	ASSERT_FALSE(storeMapRemove(a, "x")) << "removing from a shared map should fail";
+	ASSERT_FALSE(storeListAppend(storeMapLookup(a, "x"), value)) << "appending to a shared list should fail";
+	ASSERT_FALSE(storeListRemove(storeMapLookup(a, "x"), 0)) << "removing from a shared list should fail";
+
+	// releasing one owner makes the other one the sole owner again
+	ASSERT_TRUE(storeMapRemove(store, "b")) << "removing an entry of the unshared root should succeed";
+	ASSERT_EQ(a->references, 1u) << "removing one owner should release its reference";
+	ASSERT_TRUE(storeMapInsert(a, "y", value)) << "inserting into a no longer shared map should succeed";
+	ASSERT_EQ(storeMapGetSize(a), 2) << "map should contain the inserted entry";
+
+	storeFree(store);
+	storeFreeParser(parser);
+}
+
+TEST(Dedup, leavesOtherOwnersAlone)
+{
+	StoreParser *parser = storeCreateParser();
+	Store *other = storeParse(parser, "x = {p = {v = 1}, q = {v = 1}}");
+	ASSERT_TRUE(other != NULL) << "test store should parse successfully";
+	Store *x = storeMapLookup(other, "x");
+	Store *p = storeMapLookup(x, "p");
+	Store *q = storeMapLookup(x, "q");
+
+	Store *store = storeParse(parser, "y = {v = 1}");
+	ASSERT_TRUE(store != NULL) << "test store should parse successfully";
+	storeMapInsert(store, "x", storeRetain(x));
+	storeDeduplicate(store);
+	ASSERT_EQ(storeMapLookup(store, "x"), x) << "shared subtree should be kept";
+	ASSERT_EQ(storeMapLookup(x, "p"), p) << "children of a shared subtree should not be replaced";
+	ASSERT_EQ(storeMapLookup(x, "q"), q) << "children of a shared subtree should not be replaced";
+	ASSERT_EQ(q->references, 1u) << "children of a shared subtree should not be shared";
+	storeFree(store);
+
+	storeFreeze(other);
+	ASSERT_EQ(storeDeduplicate(other), 0u) << "deduplicating a frozen store should not free anything";
+	ASSERT_EQ(storeMapLookup(storeMapLookup(other, "x"), "q"), q) << "children of a frozen store should not be replaced";
+	storeFree(other);
+
+	storeFreeParser(parser);
+}
+
+TEST(Dedup, scalarsAndArrays)
+{
+	StoreParser *parser = storeCreateParser();
+	storeSetParserFlags(parser, STORE_PARSE_PACK_LISTS | STORE_PARSE_DEDUPLICATE);
+	Store *store = storeParse(parser, "[[1 2 3] [1 2 3] [1 2] 0.0 -0.0 7 7 \"7\"]");
+	ASSERT_TRUE(store != NULL) << "test store should parse successfully";
+
+	ASSERT_EQ(storeListGet(store, 0), storeListGet(store, 1)) << "identical packed arrays should be shared";
+	ASSERT_EQ(storeListGet(store, 0)->type, STORE_INT_ARRAY) << "shared array should stay packed";
+	ASSERT_NE(storeListGet(store, 0), storeListGet(store, 2)) << "arrays of different lengths should not be shared";
+	ASSERT_NE(storeListGet(store, 3), storeListGet(store, 4)) << "zeros of different signs should not be shared";
+	ASSERT_EQ(storeListGet(store, 5), storeListGet(store, 6)) << "equal ints should be shared";
+	ASSERT_NE(storeListGet(store, 6), storeListGet(store, 7)) << "stores of different types should not be shared";
+
+	storeFree(store);
+	storeFreeParser(parser);
+}
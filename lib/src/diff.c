@@ -0,0 +1,383 @@
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL
+#include <stdint.h> // uint64_t
+#include <string.h> // strcmp strpbrk
+
+#include <glib.h>
+
+#include "store/clone.h"
+#include "store/compare.h"
+#include "store/diff.h"
+#include "store/list.h"
+#include "store/map.h"
+#include "store/memory.h"
+#include "store/path.h"
+
+/**
+ * Lists whose differing middle sections would need a larger table to match their elements are diffed position by position
+ */
+static const size_t maxMatchCells = 1 << 22;
+
+typedef struct {
+	/** The list of operations being computed */
+	Store *patch;
+	/** The path of the stores currently being diffed */
+	GString *path;
+} DiffContext;
+
+typedef struct {
+	/** The differing middle sections of both lists, after their common prefix and suffix */
+	Store **firstElements;
+	Store **secondElements;
+	uint64_t *firstHashes;
+	uint64_t *secondHashes;
+	int firstLength;
+	int secondLength;
+	/** lengths[i * (secondLength + 1) + j] is the length of the longest common subsequence of the sections from i and j */
+	int *lengths;
+} ListMatch;
+
+static void diffStores(DiffContext *diff, Store *first, Store *second);
+static void diffMaps(DiffContext *diff, Store *first, Store *second);
+static void diffLists(DiffContext *diff, Store *first, Store *second);
+static void diffMatchedLists(DiffContext *diff, ListMatch *match, int offset);
+static void diffElements(DiffContext *diff, int index, Store *first, Store *second);
+static bool matchElements(ListMatch *match, int i, int j);
+static Store **getElements(Store *store);
+static void appendOperation(DiffContext *diff, const char *op, Store *value);
+static void appendKey(GString *path, const char *key);
+static void appendIndex(GString *path, int index);
+static bool applyOperation(Store *store, Store *operation);
+
+Store *storeDiff(Store *first, Store *second)
+{
+	DiffContext diff;
+	diff.patch = storeCreateListValue();
+	diff.path = g_string_new("");
+
+	if(!storeEquals(first, second)) {
+		diffStores(&diff, first, second);
+	}
+
+	g_string_free(diff.path, true);
+	return diff.patch;
+}
+
+bool storePatch(Store *store, Store *patch)
+{
+	if(patch->type != STORE_LIST) {
+		return false;
+	}
+
+	for(GList *iter = patch->content.listValue->head; iter != NULL; iter = iter->next) {
+		if(!applyOperation(store, (Store *) iter->data)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Appends the operations transforming one store into another to a diff
+ *
+ * @param diff			the diff to append to, whose path leads to both stores
+ * @param first			the store to transform
+ * @param second		the store to transform into, which must not be equal to the first one
+ */
+static void diffStores(DiffContext *diff, Store *first, Store *second)
+{
+	if(first->type == STORE_MAP && second->type == STORE_MAP) {
+		diffMaps(diff, first, second);
+	} else if(first->type == STORE_LIST && second->type == STORE_LIST) {
+		diffLists(diff, first, second);
+	} else {
+		appendOperation(diff, "replace", second);
+	}
+}
+
+static void diffMaps(DiffContext *diff, Store *first, Store *second)
+{
+	size_t pathLength = diff->path->len;
+	StoreMapIterator iterator;
+	const char *key;
+	Store *value;
+
+	storeMapIteratorInit(&iterator, first);
+	while(storeMapIteratorNext(&iterator, &key, &value)) {
+		Store *otherValue = storeMapLookup(second, key);
+		appendKey(diff->path, key);
+
+		if(otherValue == NULL) {
+			appendOperation(diff, "remove", NULL);
+		} else if(!storeEquals(value, otherValue)) {
+			diffStores(diff, value, otherValue);
+		}
+
+		g_string_truncate(diff->path, pathLength);
+	}
+
+	storeMapIteratorInit(&iterator, second);
+	while(storeMapIteratorNext(&iterator, &key, &value)) {
+		if(storeMapLookup(first, key) == NULL) {
+			appendKey(diff->path, key);
+			appendOperation(diff, "add", value);
+			g_string_truncate(diff->path, pathLength);
+		}
+	}
+}
+
+/**
+ * Diffs two generic lists by trimming their common prefix and suffix and matching the elements in between
+ */
+static void diffLists(DiffContext *diff, Store *first, Store *second)
+{
+	Store **firstElements = getElements(first);
+	Store **secondElements = getElements(second);
+	int firstLength = storeListGetLength(first);
+	int secondLength = storeListGetLength(second);
+
+	int prefix = 0;
+	while(prefix < firstLength && prefix < secondLength && storeEquals(firstElements[prefix], secondElements[prefix])) {
+		prefix++;
+	}
+
+	int suffix = 0;
+	while(suffix < firstLength - prefix && suffix < secondLength - prefix && storeEquals(firstElements[firstLength - suffix - 1], secondElements[secondLength - suffix - 1])) {
+		suffix++;
+	}
+
+	ListMatch match;
+	match.firstElements = firstElements + prefix;
+	match.secondElements = secondElements + prefix;
+	match.firstLength = firstLength - prefix - suffix;
+	match.secondLength = secondLength - prefix - suffix;
+
+	size_t numCells = (size_t) (match.firstLength + 1) * (size_t) (match.secondLength + 1);
+	if(match.firstLength > 0 && match.secondLength > 0 && numCells <= maxMatchCells) {
+		diffMatchedLists(diff, &match, prefix);
+	} else {
+		// pair up the elements by position, then remove or add the remaining ones
+		int numPairs = match.firstLength < match.secondLength ? match.firstLength : match.secondLength;
+		for(int i = 0; i < numPairs; i++) {
+			diffElements(diff, prefix + i, match.firstElements[i], match.secondElements[i]);
+		}
+
+		for(int i = numPairs; i < match.firstLength; i++) {
+			diffElements(diff, prefix + numPairs, match.firstElements[i], NULL);
+		}
+
+		for(int i = numPairs; i < match.secondLength; i++) {
+			diffElements(diff, prefix + i, NULL, match.secondElements[i]);
+		}
+	}
+
+	storeFreeMemory(firstElements);
+	storeFreeMemory(secondElements);
+}
+
+/**
+ * Diffs the middle sections of two lists along the longest common subsequence of their elements, where elements are
+ * compared by their hashes first. An element removed where another one is added is diffed against the added one instead.
+ *
+ * @param diff			the diff to append to, whose path leads to both lists
+ * @param match			the middle sections of the lists, which must both be non-empty
+ * @param offset		the index of the middle sections in the lists
+ */
+static void diffMatchedLists(DiffContext *diff, ListMatch *match, int offset)
+{
+	match->firstHashes = (uint64_t *) storeAllocateMemory(match->firstLength * sizeof(uint64_t));
+	match->secondHashes = (uint64_t *) storeAllocateMemory(match->secondLength * sizeof(uint64_t));
+	for(int i = 0; i < match->firstLength; i++) {
+		match->firstHashes[i] = storeHash(match->firstElements[i]);
+	}
+	for(int j = 0; j < match->secondLength; j++) {
+		match->secondHashes[j] = storeHash(match->secondElements[j]);
+	}
+
+	int width = match->secondLength + 1;
+	match->lengths = (int *) storeAllocateMemory((size_t) (match->firstLength + 1) * width * sizeof(int));
+	for(int i = match->firstLength; i >= 0; i--) {
+		for(int j = match->secondLength; j >= 0; j--) {
+			int *length = &match->lengths[i * width + j];
+			if(i == match->firstLength || j == match->secondLength) {
+				*length = 0;
+			} else if(matchElements(match, i, j)) {
+				*length = match->lengths[(i + 1) * width + j + 1] + 1;
+			} else {
+				int skipFirst = match->lengths[(i + 1) * width + j];
+				int skipSecond = match->lengths[i * width + j + 1];
+				*length = skipFirst > skipSecond ? skipFirst : skipSecond;
+			}
+		}
+	}
+
+	// the index in the list as modified by the operations appended so far
+	int index = offset;
+	int i = 0;
+	int j = 0;
+	while(i < match->firstLength || j < match->secondLength) {
+		int length = match->lengths[i * width + j];
+		if(i < match->firstLength && j < match->secondLength && match->lengths[(i + 1) * width + j + 1] == length - (matchElements(match, i, j) ? 1 : 0)) {
+			// either a common element or a pair of elements whose replacement doesn't shorten the common subsequence
+			diffElements(diff, index, match->firstElements[i], match->secondElements[j]);
+			index++;
+			i++;
+			j++;
+		} else if(i < match->firstLength && (j == match->secondLength || match->lengths[(i + 1) * width + j] == length)) {
+			diffElements(diff, index, match->firstElements[i], NULL);
+			i++;
+		} else {
+			diffElements(diff, index, NULL, match->secondElements[j]);
+			index++;
+			j++;
+		}
+	}
+
+	storeFreeMemory(match->lengths);
+	storeFreeMemory(match->firstHashes);
+	storeFreeMemory(match->secondHashes);
+}
+
+/**
+ * Appends the operations transforming a list element
+ *
+ * @param diff			the diff to append to, whose path leads to the list
+ * @param index			the index of the element in the list as modified by the operations appended so far
+ * @param first			the element to transform, or NULL to add the second one
+ * @param second		the element to transform into, or NULL to remove the first one
+ */
+static void diffElements(DiffContext *diff, int index, Store *first, Store *second)
+{
+	if(first != NULL && second != NULL && storeEquals(first, second)) {
+		return;
+	}
+
+	size_t pathLength = diff->path->len;
+	appendIndex(diff->path, index);
+
+	if(first == NULL) {
+		appendOperation(diff, "add", second);
+	} else if(second == NULL) {
+		appendOperation(diff, "remove", NULL);
+	} else {
+		diffStores(diff, first, second);
+	}
+
+	g_string_truncate(diff->path, pathLength);
+}
+
+static bool matchElements(ListMatch *match, int i, int j)
+{
+	return match->firstHashes[i] == match->secondHashes[j] && storeEquals(match->firstElements[i], match->secondElements[j]);
+}
+
+/**
+ * Collects the elements of a generic list into an array, to be freed with storeFreeMemory
+ */
+static Store **getElements(Store *store)
+{
+	int length = storeListGetLength(store);
+	Store **elements = (Store **) storeAllocateMemory((length > 0 ? length : 1) * sizeof(Store *));
+
+	int i = 0;
+	for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+		elements[i++] = (Store *) iter->data;
+	}
+
+	return elements;
+}
+
+/**
+ * Appends an operation at the diff's current path to its patch
+ *
+ * @param diff			the diff to append to
+ * @param op			the name of the operation
+ * @param value			the value of the operation, which is copied, or NULL if it has none
+ */
+static void appendOperation(DiffContext *diff, const char *op, Store *value)
+{
+	Store *operation = storeCreateMapValue();
+	storeMapInsert(operation, "op", storeCreateStringValue(op));
+	storeMapInsert(operation, "path", storeCreateStringValueLength(diff->path->str, diff->path->len));
+	if(value != NULL) {
+		storeMapInsert(operation, "value", storeClone(value, 0));
+	}
+
+	storeListAppend(diff->patch, operation);
+}
+
+/**
+ * Appends a key segment to a path, quoting the key in square brackets if it contains special characters
+ */
+static void appendKey(GString *path, const char *key)
+{
+	if(*key != '\0' && strcmp(key, "*") != 0 && strpbrk(key, ".[]\"\\") == NULL) {
+		if(path->len > 0) {
+			g_string_append_c(path, '.');
+		}
+
+		g_string_append(path, key);
+		return;
+	}
+
+	g_string_append(path, "[\"");
+	for(const char *c = key; *c != '\0'; c++) {
+		if(*c == '"' || *c == '\\') {
+			g_string_append_c(path, '\\');
+		}
+
+		g_string_append_c(path, *c);
+	}
+	g_string_append(path, "\"]");
+}
+
+static void appendIndex(GString *path, int index)
+{
+	g_string_append_printf(path, "[%d]", index);
+}
+
+/**
+ * Applies a single operation of a patch to a store
+ *
+ * @param store			the store to modify
+ * @param operation		the operation map to apply
+ * @result				true if the operation was applied, false if it is malformed or failed
+ */
+static bool applyOperation(Store *store, Store *operation)
+{
+	if(operation->type != STORE_MAP) {
+		return false;
+	}
+
+	Store *op = storeMapLookup(operation, "op");
+	Store *pathString = storeMapLookup(operation, "path");
+	Store *value = storeMapLookup(operation, "value");
+	if(op == NULL || op->type != STORE_STRING || pathString == NULL || pathString->type != STORE_STRING) {
+		return false;
+	}
+
+	StorePath *path = storeCompilePath(pathString->content.stringValue);
+	if(path == NULL) {
+		return false;
+	}
+
+	bool applied = false;
+	if(strcmp(op->content.stringValue, "remove") == 0) {
+		applied = storeRemovePath(store, path);
+	} else if(value != NULL && (strcmp(op->content.stringValue, "add") == 0 || strcmp(op->content.stringValue, "replace") == 0)) {
+		Store *copy = storeClone(value, 0);
+		if(strcmp(op->content.stringValue, "add") == 0) {
+			applied = storeInsertPath(store, path, copy);
+		} else {
+			applied = storeSetPath(store, path, copy);
+		}
+
+		if(!applied) {
+			storeFree(copy);
+		}
+	}
+
+	storeFreePath(path);
+	return applied;
+}
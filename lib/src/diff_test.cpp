@@ -0,0 +1,129 @@
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "diff.c"
+
+class Diff: public ::testing::Test {
+public:
+	virtual void SetUp() {
+		parser = storeCreateParser();
+	}
+
+	virtual void TearDown() {
+		storeFreeParser(parser);
+	}
+
+protected:
+	Store *parse(const char *input, int flags = 0) {
+		storeSetParserFlags(parser, flags);
+		Store *store = storeParse(parser, input);
+		EXPECT_TRUE(store != NULL) << "test store '" << input << "' should parse successfully";
+		return store;
+	}
+
+	void expectDiff(const char *first, const char *second, int numOperations, int flags = 0) {
+		Store *firstStore = parse(first, flags);
+		Store *secondStore = parse(second, flags);
+
+		Store *patch = storeDiff(firstStore, secondStore);
+		EXPECT_EQ(storeListGetLength(patch), numOperations) << "diffing '" << first << "' with '" << second << "' should produce the expected number of operations";
+		EXPECT_TRUE(storePatch(firstStore, patch)) << "patch from '" << first << "' to '" << second << "' should apply";
+		EXPECT_TRUE(storeEquals(firstStore, secondStore)) << "patching '" << first << "' should result in '" << second << "'";
+
+		storeFree(patch);
+		storeFree(firstStore);
+		storeFree(secondStore);
+	}
+
+	StoreParser *parser;
+};
+
+TEST_F(Diff, maps)
+{
+	expectDiff("a = 1; b = {c = x, d = y}", "a = 1; b = {c = x, d = y}", 0);
+	expectDiff("a = 1; b = {c = x, d = y}", "a = 1; b = {c = x, d = z}", 1);
+	expectDiff("a = 1; b = 2", "b = 2; c = 3", 2);
+	expectDiff("a = {\"x.y\" = 1, \"*\" = 2, \"\" = 3}", "a = {\"x.y\" = 4, \"*\" = 5, \"\" = 6}", 3);
+	expectDiff("a = {b = 1}", "a = [1]", 1);
+}
+
+TEST_F(Diff, lists)
+{
+	expectDiff("[a b c d]", "[a b c d]", 0);
+	expectDiff("[a b c d]", "[a x c d]", 1);
+	expectDiff("[a b c d]", "[a c d]", 1);
+	expectDiff("[a b c d]", "[x a b c d y]", 2);
+	expectDiff("[a b c d e]", "[e d c b a]", 4);
+	expectDiff("[]", "[a b]", 2);
+	expectDiff("[a b]", "[]", 2);
+	expectDiff("[{name = alpha, port = 80} {name = beta, port = 81}]", "[{name = alpha, port = 80} {name = gamma, port = 81}]", 1);
+	expectDiff("[1 2 3]", "[1 5 3]", 1, STORE_PARSE_PACK_LISTS);
+}
+
+TEST_F(Diff, root)
+{
+	expectDiff("1", "2", 1);
+	expectDiff("\"a\"", "[a b]", 1);
+	expectDiff("[a b]", "\"some longer string\"", 1);
+}
+
+TEST_F(Diff, operations)
+{
+	Store *first = parse("servers = [{name = alpha} {name = beta}]; timeout = 10");
+	Store *second = parse("servers = [{name = alpha} {name = gamma}]; retries = 3");
+	Store *patch = storeDiff(first, second);
+
+	Store *expected = parse("[{op = replace, path = \"servers[1].name\", value = gamma} {op = remove, path = timeout} {op = add, path = retries, value = 3}]");
+	ASSERT_TRUE(storeEquals(patch, expected)) << "patch should consist of the expected operations";
+
+	storeFree(expected);
+	storeFree(patch);
+	storeFree(second);
+	storeFree(first);
+}
+
+TEST_F(Diff, parsedPatch)
+{
+	Store *store = parse("a = {b = [1 2 3]}");
+	Store *patch = parse("[{op = add, path = \"a.b[3]\", value = 4} {op = remove, path = \"a.b[0]\"} {op = replace, path = \"a[\\\"c\\\"]\", value = x}]");
+	ASSERT_TRUE(storePatch(store, patch)) << "parsed patch should apply";
+
+	Store *expected = parse("a = {b = [2 3 4], c = x}");
+	ASSERT_TRUE(storeEquals(store, expected)) << "parsed patch should result in the expected store";
+
+	Store *emptyPatch = parse("[]");
+	ASSERT_TRUE(storePatch(expected, emptyPatch)) << "empty patch should apply";
+
+	storeFree(emptyPatch);
+	storeFree(expected);
+	storeFree(patch);
+	storeFree(store);
+}
+
+TEST_F(Diff, failures)
+{
+	Store *store = parse("a = {b = 1}");
+	Store *patch = parse("[{op = remove, path = a.c}]");
+	ASSERT_FALSE(storePatch(store, patch)) << "removing a missing key should fail";
+	storeFree(patch);
+
+	patch = parse("[{op = add, path = a.b, value = 2}]");
+	ASSERT_FALSE(storePatch(store, patch)) << "adding an existing key should fail";
+	storeFree(patch);
+
+	patch = parse("[{op = move, path = a.b}]");
+	ASSERT_FALSE(storePatch(store, patch)) << "unknown operations should fail";
+	storeFree(patch);
+
+	storeFreeze(store);
+	patch = parse("[{op = replace, path = a.b, value = 2}]");
+	ASSERT_FALSE(storePatch(store, patch)) << "patching a frozen store should fail";
+	storeFree(patch);
+
+	storeFree(store);
+}
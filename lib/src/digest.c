@@ -0,0 +1,106 @@
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+#include <stdint.h> // uint8_t uint64_t
+#include <stdio.h> // snprintf
+
+#include "store/digest.h"
+
+static const uint64_t c1 = 0x87c37b91114253d5ull;
+static const uint64_t c2 = 0x4cf5ad432745937full;
+
+static uint64_t readBlock(const uint8_t *bytes);
+static uint64_t readTail(const uint8_t *bytes, size_t length);
+static uint64_t rotate(uint64_t value, int bits);
+static uint64_t finalize(uint64_t value);
+
+StoreDigest storeDigest(const void *data, size_t length)
+{
+	const uint8_t *bytes = (const uint8_t *) data;
+	size_t numBlocks = length / 16;
+	uint64_t h1 = 0;
+	uint64_t h2 = 0;
+
+	for(size_t i = 0; i < numBlocks; i++) {
+		uint64_t k1 = readBlock(bytes + 16 * i);
+		uint64_t k2 = readBlock(bytes + 16 * i + 8);
+
+		h1 ^= rotate(k1 * c1, 31) * c2;
+		h1 = (rotate(h1, 27) + h2) * 5 + 0x52dce729;
+
+		h2 ^= rotate(k2 * c2, 33) * c1;
+		h2 = (rotate(h2, 31) + h1) * 5 + 0x38495ab5;
+	}
+
+	const uint8_t *tail = bytes + 16 * numBlocks;
+	size_t tailLength = length & 15;
+	if(tailLength > 8) {
+		h2 ^= rotate(readTail(tail + 8, tailLength - 8) * c2, 33) * c1;
+	}
+
+	if(tailLength > 0) {
+		h1 ^= rotate(readTail(tail, tailLength > 8 ? 8 : tailLength) * c1, 31) * c2;
+	}
+
+	h1 ^= (uint64_t) length;
+	h2 ^= (uint64_t) length;
+	h1 += h2;
+	h2 += h1;
+	h1 = finalize(h1);
+	h2 = finalize(h2);
+	h1 += h2;
+	h2 += h1;
+
+	StoreDigest digest;
+	digest.low = h1;
+	digest.high = h2;
+	return digest;
+}
+
+bool storeDigestEquals(StoreDigest first, StoreDigest second)
+{
+	return first.low == second.low && first.high == second.high;
+}
+
+void storeFormatDigest(StoreDigest digest, char *string)
+{
+	snprintf(string, STORE_DIGEST_STRING_LENGTH + 1, "%016llx%016llx", (unsigned long long) digest.high, (unsigned long long) digest.low);
+}
+
+/**
+ * Reads eight bytes in little endian order, so that digests don't depend on the machine
+ */
+static uint64_t readBlock(const uint8_t *bytes)
+{
+	return readTail(bytes, 8);
+}
+
+/**
+ * Reads up to eight bytes in little endian order
+ */
+static uint64_t readTail(const uint8_t *bytes, size_t length)
+{
+	uint64_t value = 0;
+	for(size_t i = 0; i < length; i++) {
+		value |= (uint64_t) bytes[i] << (8 * i);
+	}
+
+	return value;
+}
+
+static uint64_t rotate(uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+/**
+ * Mixes the bits of a value so that every input bit affects every output bit
+ */
+static uint64_t finalize(uint64_t value)
+{
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccdull;
+	value ^= value >> 33;
+	value *= 0xc4ceb9fe1a85ec53ull;
+	value ^= value >> 33;
+	return value;
+}
@@ -0,0 +1,84 @@
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL size_t
+#include <stdio.h> // SEEK_END SEEK_SET FILE fopen fseek ftell fread fclose rename
+#include <stdlib.h> // malloc free mkstemp
+#include <unistd.h> // close unlink write
+
+#include <glib.h>
+
+#include "store/file.h"
+
+char *storeReadFile(const char *filename, size_t *length)
+{
+	FILE *file = fopen(filename, "rb");
+	if(file == NULL) {
+		return NULL;
+	}
+
+	if(fseek(file, 0, SEEK_END) != 0) {
+		fclose(file);
+		return NULL;
+	}
+
+	long size = ftell(file);
+	if(size < 0) {
+		fclose(file);
+		return NULL;
+	}
+
+	if(fseek(file, 0, SEEK_SET) != 0) {
+		fclose(file);
+		return NULL;
+	}
+
+	char *contents = (char *) malloc(size + 1);
+	if(fread(contents, 1, size, file) != (size_t) size) {
+		free(contents);
+		fclose(file);
+		return NULL;
+	}
+
+	contents[size] = '\0';
+	fclose(file);
+
+	if(length != NULL) {
+		*length = size;
+	}
+
+	return contents;
+}
+
+bool storeWriteFileAtomically(const char *filename, const char *contents, size_t length)
+{
+	GString *temporaryFilename = g_string_new(filename);
+	g_string_append(temporaryFilename, ".XXXXXX");
+
+	int fd = mkstemp(temporaryFilename->str);
+	if(fd < 0) {
+		g_string_free(temporaryFilename, true);
+		return false;
+	}
+
+	bool written = true;
+	for(size_t offset = 0; offset < length && written; ) {
+		ssize_t count = write(fd, contents + offset, length - offset);
+		if(count < 0) {
+			written = false;
+		} else {
+			offset += count;
+		}
+	}
+
+	if(close(fd) != 0) {
+		written = false;
+	}
+
+	if(!written || rename(temporaryFilename->str, filename) != 0) {
+		unlink(temporaryFilename->str);
+		g_string_free(temporaryFilename, true);
+		return false;
+	}
+
+	g_string_free(temporaryFilename, true);
+	return true;
+}
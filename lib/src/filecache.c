@@ -0,0 +1,202 @@
+#include <dirent.h> // DIR opendir readdir closedir dirent
+#include <fcntl.h> // AT_FDCWD
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL size_t
+#include <stdio.h> // snprintf
+#include <stdlib.h> // free
+#include <string.h> // strcmp strlen
+#include <sys/stat.h> // stat utimensat
+#include <time.h> // timespec
+#include <unistd.h> // unlink
+
+#include <glib.h>
+
+#include "store/binary.h"
+#include "store/dedup.h"
+#include "store/digest.h"
+#include "store/file.h"
+#include "store/filecache.h"
+#include "store/memory.h"
+#include "store/parser.h"
+
+/**
+ * The suffix of every cache entry's filename
+ */
+static const char *entrySuffix = ".storecache";
+
+typedef struct {
+	char *filename;
+	size_t size;
+	struct timespec modified;
+} CacheEntry;
+
+static Store *loadEntry(const char *entryFilename, int parseFlags);
+static void pruneCache(const char *cacheDirectory, size_t maxCacheSize);
+static bool isCurrentVersion(const char *name);
+static int compareEntryAge(const void *firstPointer, const void *secondPointer);
+static void freeEntry(void *entryPointer);
+
+Store *storeParseFileCached(const char *filename, const char *cacheDirectory, int parseFlags, size_t maxCacheSize)
+{
+	size_t length;
+	char *contents = storeReadFile(filename, &length);
+	if(contents == NULL) {
+		return NULL;
+	}
+
+	// the spans would be recorded in a parser the caller never sees
+	parseFlags &= ~STORE_PARSE_SPANS;
+
+	char digest[STORE_DIGEST_STRING_LENGTH + 1];
+	storeFormatDigest(storeDigest(contents, length), digest);
+	GString *entryFilename = g_string_new("");
+	g_string_append_printf(entryFilename, "%s/%s-%d.v%d%s", cacheDirectory, digest, parseFlags, STORE_BINARY_VERSION, entrySuffix);
+
+	Store *store = loadEntry(entryFilename->str, parseFlags);
+	if(store != NULL) {
+		g_string_free(entryFilename, true);
+		free(contents);
+		return store;
+	}
+
+	StoreParser *parser = storeCreateParser();
+	storeSetParserFlags(parser, parseFlags);
+	store = storeParse(parser, contents);
+	storeFreeParser(parser);
+	free(contents);
+
+	if(store != NULL) {
+		size_t encodedLength;
+		char *encoded = storeEncodeBinary(store, &encodedLength);
+		if(encodedLength <= maxCacheSize && storeWriteFileAtomically(entryFilename->str, encoded, encodedLength)) {
+			pruneCache(cacheDirectory, maxCacheSize);
+		}
+		free(encoded);
+	}
+
+	g_string_free(entryFilename, true);
+	return store;
+}
+
+/**
+ * Loads a store from a cache entry and marks the entry as recently used
+ *
+ * @param entryFilename	the filename of the cache entry
+ * @param parseFlags	the flags the cached store was parsed with
+ * @result				the cached store, or NULL if there is no valid entry
+ */
+static Store *loadEntry(const char *entryFilename, int parseFlags)
+{
+	size_t length;
+	char *encoded = storeReadFile(entryFilename, &length);
+	if(encoded == NULL) {
+		return NULL;
+	}
+
+	Store *store = storeDecodeBinary(encoded, length);
+	free(encoded);
+	if(store == NULL) {
+		return NULL;
+	}
+
+	// the encoding doesn't preserve shared subtrees
+	if(parseFlags & STORE_PARSE_DEDUPLICATE) {
+		storeDeduplicate(store);
+	}
+
+	utimensat(AT_FDCWD, entryFilename, NULL, 0);
+	return store;
+}
+
+/**
+ * Deletes the cache entries of other binary encoding versions, and the least recently used entries until the remaining
+ * ones fit into the cache size. Entries deleted concurrently by other processes are skipped.
+ *
+ * @param cacheDirectory	the directory to prune
+ * @param maxCacheSize		the maximum total number of bytes of the remaining entries
+ */
+static void pruneCache(const char *cacheDirectory, size_t maxCacheSize)
+{
+	DIR *directory = opendir(cacheDirectory);
+	if(directory == NULL) {
+		return;
+	}
+
+	GList *entries = NULL;
+	size_t totalSize = 0;
+	size_t suffixLength = strlen(entrySuffix);
+
+	struct dirent *dirent;
+	while((dirent = readdir(directory)) != NULL) {
+		size_t nameLength = strlen(dirent->d_name);
+		if(nameLength < suffixLength || strcmp(dirent->d_name + nameLength - suffixLength, entrySuffix) != 0) {
+			continue;
+		}
+
+		GString *filename = g_string_new(cacheDirectory);
+		g_string_append_c(filename, '/');
+		g_string_append(filename, dirent->d_name);
+
+		struct stat status;
+		if(!isCurrentVersion(dirent->d_name)) {
+			unlink(filename->str);
+			g_string_free(filename, true);
+		} else if(stat(filename->str, &status) != 0) {
+			g_string_free(filename, true);
+		} else {
+			CacheEntry *entry = storeAllocateMemoryType(CacheEntry);
+			entry->filename = g_string_free(filename, false);
+			entry->size = status.st_size;
+			entry->modified = status.st_mtim;
+			entries = g_list_prepend(entries, entry);
+			totalSize += entry->size;
+		}
+	}
+	closedir(directory);
+
+	entries = g_list_sort(entries, compareEntryAge);
+	for(GList *iter = entries; iter != NULL && totalSize > maxCacheSize; iter = iter->next) {
+		CacheEntry *entry = (CacheEntry *) iter->data;
+		unlink(entry->filename);
+		totalSize -= entry->size;
+	}
+
+	g_list_free_full(entries, freeEntry);
+}
+
+/**
+ * Returns whether the name of a cache entry carries the current binary encoding version
+ */
+static bool isCurrentVersion(const char *name)
+{
+	char suffix[32];
+	snprintf(suffix, sizeof(suffix), ".v%d%s", STORE_BINARY_VERSION, entrySuffix);
+
+	size_t nameLength = strlen(name);
+	size_t suffixLength = strlen(suffix);
+	return nameLength >= suffixLength && strcmp(name + nameLength - suffixLength, suffix) == 0;
+}
+
+/**
+ * Orders cache entries from the least to the most recently used
+ */
+static int compareEntryAge(const void *firstPointer, const void *secondPointer)
+{
+	const CacheEntry *first = (const CacheEntry *) firstPointer;
+	const CacheEntry *second = (const CacheEntry *) secondPointer;
+
+	if(first->modified.tv_sec != second->modified.tv_sec) {
+		return first->modified.tv_sec < second->modified.tv_sec ? -1 : 1;
+	} else if(first->modified.tv_nsec != second->modified.tv_nsec) {
+		return first->modified.tv_nsec < second->modified.tv_nsec ? -1 : 1;
+	}
+
+	return 0;
+}
+
+static void freeEntry(void *entryPointer)
+{
+	CacheEntry *entry = (CacheEntry *) entryPointer;
+	free(entry->filename);
+	storeFreeMemory(entry);
+}
@@ -0,0 +1,186 @@
+#include <cstdio>
+#include <string>
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/compare.h>
+	#include <store/dedup.h>
+	#include <store/map.h>
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "digest.c"
+#include "filecache.c"
+
+class FileCache: public ::testing::Test {
+public:
+	virtual void SetUp() {
+		char pattern[] = "/tmp/store_filecache_XXXXXX";
+		ASSERT_TRUE(mkdtemp(pattern) != NULL) << "temporary directory should be created";
+		directory = pattern;
+		cacheDirectory = directory + "/cache";
+		ASSERT_EQ(mkdir(cacheDirectory.c_str(), 0700), 0) << "cache directory should be created";
+	}
+
+	virtual void TearDown() {
+		removeAll(cacheDirectory);
+		removeAll(directory);
+	}
+
+protected:
+	void writeFile(const std::string& name, const char *contents) {
+		FILE *file = fopen((directory + "/" + name).c_str(), "w");
+		ASSERT_TRUE(file != NULL) << "test file should be created";
+		fputs(contents, file);
+		fclose(file);
+	}
+
+	Store *parse(const std::string& name, int flags = 0, size_t maxCacheSize = 1 << 20) {
+		return storeParseFileCached((directory + "/" + name).c_str(), cacheDirectory.c_str(), flags, maxCacheSize);
+	}
+
+	int countEntries() {
+		int count = 0;
+		DIR *dir = opendir(cacheDirectory.c_str());
+		while(struct dirent *dirent = readdir(dir)) {
+			if(dirent->d_name[0] != '.') {
+				count++;
+			}
+		}
+		closedir(dir);
+		return count;
+	}
+
+	void removeAll(const std::string& path) {
+		DIR *dir = opendir(path.c_str());
+		if(dir != NULL) {
+			while(struct dirent *dirent = readdir(dir)) {
+				if(strcmp(dirent->d_name, ".") != 0 && strcmp(dirent->d_name, "..") != 0) {
+					unlink((path + "/" + dirent->d_name).c_str());
+				}
+			}
+			closedir(dir);
+		}
+		rmdir(path.c_str());
+	}
+
+	std::string directory;
+	std::string cacheDirectory;
+};
+
+TEST(Digest, vectors)
+{
+	StoreDigest empty = storeDigest("", 0);
+	ASSERT_EQ(empty.low, 0u) << "empty input should have the reference digest";
+	ASSERT_EQ(empty.high, 0u) << "empty input should have the reference digest";
+
+	StoreDigest hello = storeDigest("hello", 5);
+	ASSERT_EQ(hello.low, 0xcbd8a7b341bd9b02ull) << "short input should have the reference digest";
+	ASSERT_EQ(hello.high, 0x5b1e906a48ae1d19ull) << "short input should have the reference digest";
+
+	const char *text = "The quick brown fox jumps over the lazy dog";
+	ASSERT_TRUE(storeDigestEquals(storeDigest(text, strlen(text)), storeDigest(text, strlen(text)))) << "digest should be deterministic";
+	ASSERT_FALSE(storeDigestEquals(storeDigest(text, strlen(text)), storeDigest(text, strlen(text) - 1))) << "different inputs should have different digests";
+
+	char string[STORE_DIGEST_STRING_LENGTH + 1];
+	storeFormatDigest(hello, string);
+	ASSERT_STREQ(string, "5b1e906a48ae1d19cbd8a7b341bd9b02") << "digest should be formatted upper bits first";
+}
+
+TEST_F(FileCache, hitAndMiss)
+{
+	writeFile("config.store", "a = {b = [1 2 3]}; c = hello");
+	Store *parsed = parse("config.store");
+	ASSERT_TRUE(parsed != NULL) << "file should be parsed on a miss";
+	ASSERT_EQ(countEntries(), 1) << "miss should write a cache entry";
+
+	Store *cached = parse("config.store");
+	ASSERT_TRUE(cached != NULL) << "file should be loaded on a hit";
+	ASSERT_TRUE(storeEquals(cached, parsed)) << "cached store should equal the parsed one";
+	ASSERT_EQ(countEntries(), 1) << "hit should not write another entry";
+	storeFree(cached);
+
+	Store *packed = parse("config.store", STORE_PARSE_PACK_LISTS);
+	ASSERT_EQ(countEntries(), 2) << "different parse flags should have their own entry";
+	storeFree(packed);
+	packed = parse("config.store", STORE_PARSE_PACK_LISTS);
+	ASSERT_EQ(storeMapLookup(storeMapLookup(packed, "a"), "b")->type, STORE_INT_ARRAY) << "cached entry should keep packed arrays";
+	storeFree(packed);
+
+	writeFile("config.store", "a = {b = [1 2 4]}; c = hello");
+	Store *changed = parse("config.store");
+	ASSERT_FALSE(storeEquals(changed, parsed)) << "changed file should miss the cache";
+	ASSERT_EQ(countEntries(), 3) << "changed file should have its own entry";
+	storeFree(changed);
+	storeFree(parsed);
+
+	writeFile("broken.store", "a = [");
+	ASSERT_TRUE(parse("broken.store") == NULL) << "unparsable file should fail";
+	ASSERT_TRUE(parse("missing.store") == NULL) << "missing file should fail";
+	ASSERT_EQ(countEntries(), 3) << "failures should not write entries";
+}
+
+TEST_F(FileCache, invalidation)
+{
+	writeFile("config.store", "a = 1");
+	storeFree(parse("config.store"));
+
+	// corrupt the entry, which must then be replaced
+	DIR *dir = opendir(cacheDirectory.c_str());
+	std::string entry;
+	while(struct dirent *dirent = readdir(dir)) {
+		if(dirent->d_name[0] != '.') {
+			entry = cacheDirectory + "/" + dirent->d_name;
+		}
+	}
+	closedir(dir);
+	FILE *file = fopen(entry.c_str(), "w");
+	fputs("garbage", file);
+	fclose(file);
+
+	Store *store = parse("config.store");
+	ASSERT_TRUE(store != NULL && storeMapLookup(store, "a")->content.intValue == 1) << "corrupt entry should be reparsed";
+	storeFree(store);
+
+	file = fopen((cacheDirectory + "/0123-0.v0.storecache").c_str(), "w");
+	fputs("old", file);
+	fclose(file);
+	writeFile("other.store", "b = 2");
+	storeFree(parse("other.store"));
+	ASSERT_EQ(access((cacheDirectory + "/0123-0.v0.storecache").c_str(), F_OK), -1) << "entry of another version should be deleted";
+	ASSERT_EQ(countEntries(), 2) << "current entries should be kept";
+}
+
+TEST_F(FileCache, sizeBound)
+{
+	writeFile("first.store", "a = \"first value\"");
+	writeFile("second.store", "a = \"second value\"");
+	writeFile("third.store", "a = \"third value\"");
+
+	storeFree(parse("first.store", 0, 60));
+	usleep(10000);
+	storeFree(parse("second.store", 0, 60));
+	usleep(10000);
+	storeFree(parse("first.store", 0, 60)); // marks the first entry as recently used
+	usleep(10000);
+	storeFree(parse("third.store", 0, 60));
+	ASSERT_EQ(countEntries(), 2) << "cache should be pruned to its size";
+
+	std::string second = cacheDirectory + "/";
+	char digest[STORE_DIGEST_STRING_LENGTH + 1];
+	const char *contents = "a = \"second value\"";
+	storeFormatDigest(storeDigest(contents, strlen(contents)), digest);
+	second += digest;
+	second += "-0.v" + std::to_string(STORE_BINARY_VERSION) + ".storecache";
+	ASSERT_EQ(access(second.c_str(), F_OK), -1) << "least recently used entry should be deleted";
+
+	storeFree(parse("first.store", 0, 10));
+	ASSERT_EQ(countEntries(), 2) << "entry larger than the cache should not be written";
+}
@@ -0,0 +1,467 @@
+#include <stdlib.h> // free qsort
+#include <string.h> // strcmp strdup memcpy memmove memset
+
+#include <glib.h>
+
+#include "store/index.h"
+#include "store/list.h"
+#include "store/map.h"
+#include "store/memory.h"
+#include "store/path.h"
+
+/**
+ * The initial number of entries allocated for an index
+ */
+static const int initialIndexCapacity = 16;
+
+typedef struct {
+	/** The indexed element, or NULL for an unused slot of a hash index */
+	Store *element;
+	/** A copy of the element's key, an int or a string owned by the entry */
+	Store key;
+	/** The hash of the key */
+	unsigned int hash;
+	/** Whether the element was removed from this slot of a hash index */
+	bool removed;
+} IndexEntry;
+
+typedef struct {
+	IndexEntry entry;
+	/** The position of the element in the list, which orders elements with equal keys */
+	int position;
+} SortingEntry;
+
+struct StoreIndexStruct {
+	StoreIndexType type;
+	/** The indexed list store */
+	Store *list;
+	/** The compiled key path */
+	StorePath *path;
+	/** The number of indexed elements */
+	int size;
+	/** The number of allocated entries, a power of two for hash indexes */
+	int capacity;
+	/** The number of used slots of a hash index, including removed ones */
+	int used;
+	/** The open addressing slots of a hash index, or the entries of a sorted index ordered by key */
+	IndexEntry *entries;
+};
+
+static bool initEntry(StoreIndex *index, Store *element, IndexEntry *entry);
+static void buildSortedIndex(StoreIndex *index);
+static int compareSortingEntries(const void *first, const void *second);
+static bool getKey(StoreIndex *index, Store *element, Store *key);
+static unsigned int hashIndexKey(Store *key);
+static bool keysEqual(Store *first, Store *second);
+static int compareKeys(Store *first, Store *second);
+static void freeEntryKey(IndexEntry *entry);
+static void insertHashEntry(StoreIndex *index, IndexEntry *entry);
+static void rehash(StoreIndex *index, int capacity);
+static void insertSortedEntry(StoreIndex *index, IndexEntry *entry);
+static int findBound(StoreIndex *index, Store *key, bool upper);
+
+StoreIndex *storeCreateIndex(Store *store, const char *keyPath, StoreIndexType type)
+{
+	if(store->type != STORE_LIST) {
+		return NULL;
+	}
+
+	StorePath *path = storeCompilePath(keyPath);
+	if(path == NULL) {
+		return NULL;
+	}
+
+	StoreIndex *index = storeAllocateMemoryType(StoreIndex);
+	index->type = type;
+	index->list = store;
+	index->path = path;
+	index->size = 0;
+	index->capacity = initialIndexCapacity;
+	index->used = 0;
+	index->entries = (IndexEntry *) storeAllocateMemory(index->capacity * sizeof(IndexEntry));
+	memset(index->entries, 0, index->capacity * sizeof(IndexEntry));
+
+	if(type == STORE_INDEX_SORTED) {
+		buildSortedIndex(index);
+	} else {
+		for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+			storeIndexAddElement(index, (Store *) iter->data);
+		}
+	}
+
+	storeListAttachIndex(store, index);
+	return index;
+}
+
+void storeFreeIndex(StoreIndex *index)
+{
+	storeListDetachIndex(index->list, index);
+
+	int numEntries = index->type == STORE_INDEX_HASH ? index->capacity : index->size;
+	for(int i = 0; i < numEntries; i++) {
+		if(index->entries[i].element != NULL) {
+			freeEntryKey(&index->entries[i]);
+		}
+	}
+
+	storeFreeMemory(index->entries);
+	storeFreePath(index->path);
+	storeFreeMemory(index);
+}
+
+void storeIndexAddElement(StoreIndex *index, Store *element)
+{
+	IndexEntry entry;
+	if(!initEntry(index, element, &entry)) {
+		return;
+	}
+
+	if(index->type == STORE_INDEX_HASH) {
+		insertHashEntry(index, &entry);
+	} else {
+		insertSortedEntry(index, &entry);
+	}
+
+	index->size++;
+}
+
+void storeIndexRemoveElement(StoreIndex *index, Store *element)
+{
+	// the element's key might have been modified since it was indexed, so fall back to a full scan
+	int numEntries = index->type == STORE_INDEX_HASH ? index->capacity : index->size;
+	int position = -1;
+
+	Store key;
+	if(getKey(index, element, &key)) {
+		if(index->type == STORE_INDEX_HASH) {
+			unsigned int mask = index->capacity - 1;
+			for(unsigned int slot = hashIndexKey(&key) & mask; index->entries[slot].element != NULL || index->entries[slot].removed; slot = (slot + 1) & mask) {
+				if(index->entries[slot].element == element) {
+					position = slot;
+					break;
+				}
+			}
+		} else {
+			for(int i = findBound(index, &key, false); i < index->size && keysEqual(&index->entries[i].key, &key); i++) {
+				if(index->entries[i].element == element) {
+					position = i;
+					break;
+				}
+			}
+		}
+	}
+
+	for(int i = 0; i < numEntries && position < 0; i++) {
+		if(index->entries[i].element == element) {
+			position = i;
+		}
+	}
+
+	if(position < 0) {
+		return;
+	}
+
+	freeEntryKey(&index->entries[position]);
+	if(index->type == STORE_INDEX_HASH) {
+		index->entries[position].element = NULL;
+		index->entries[position].removed = true;
+	} else {
+		memmove(&index->entries[position], &index->entries[position + 1], (index->size - position - 1) * sizeof(IndexEntry));
+	}
+
+	index->size--;
+}
+
+int storeIndexGetSize(StoreIndex *index)
+{
+	return index->size;
+}
+
+Store *storeIndexLookup(StoreIndex *index, Store *key)
+{
+	if(key->type != STORE_INT && key->type != STORE_STRING) {
+		return NULL;
+	}
+
+	if(index->type == STORE_INDEX_SORTED) {
+		int position = findBound(index, key, false);
+		if(position < index->size && keysEqual(&index->entries[position].key, key)) {
+			return index->entries[position].element;
+		}
+
+		return NULL;
+	}
+
+	unsigned int hash = hashIndexKey(key);
+	unsigned int mask = index->capacity - 1;
+	for(unsigned int slot = hash & mask; index->entries[slot].element != NULL || index->entries[slot].removed; slot = (slot + 1) & mask) {
+		IndexEntry *entry = &index->entries[slot];
+		if(entry->element != NULL && entry->hash == hash && keysEqual(&entry->key, key)) {
+			return entry->element;
+		}
+	}
+
+	return NULL;
+}
+
+Store *storeIndexLookupInt(StoreIndex *index, int key)
+{
+	Store keyStore;
+	keyStore.type = STORE_INT;
+	keyStore.content.intValue = key;
+	return storeIndexLookup(index, &keyStore);
+}
+
+Store *storeIndexLookupString(StoreIndex *index, const char *key)
+{
+	Store keyStore;
+	keyStore.type = STORE_STRING;
+	keyStore.content.stringValue = (char *) key;
+	return storeIndexLookup(index, &keyStore);
+}
+
+int storeIndexLowerBound(StoreIndex *index, Store *key)
+{
+	if(index->type != STORE_INDEX_SORTED) {
+		return -1;
+	}
+
+	return findBound(index, key, false);
+}
+
+int storeIndexUpperBound(StoreIndex *index, Store *key)
+{
+	if(index->type != STORE_INDEX_SORTED) {
+		return -1;
+	}
+
+	return findBound(index, key, true);
+}
+
+Store *storeIndexGetElement(StoreIndex *index, int position)
+{
+	if(index->type != STORE_INDEX_SORTED || position < 0 || position >= index->size) {
+		return NULL;
+	}
+
+	return index->entries[position].element;
+}
+
+/**
+ * Initializes the entry of an element, copying the element's key
+ *
+ * @param index			the index to initialize the entry for
+ * @param element		the element to initialize the entry of
+ * @param entry			the entry to initialize
+ * @result				true if the element has an int or string key and therefore is indexed
+ */
+static bool initEntry(StoreIndex *index, Store *element, IndexEntry *entry)
+{
+	if(!getKey(index, element, &entry->key)) {
+		return false;
+	}
+
+	entry->element = element;
+	entry->hash = hashIndexKey(&entry->key);
+	entry->removed = false;
+	if(entry->key.type == STORE_STRING) {
+		entry->key.content.stringValue = strdup(entry->key.content.stringValue);
+	}
+
+	return true;
+}
+
+/**
+ * Fills an empty sorted index with the elements of its list by sorting them all at once, which orders elements with
+ * equal keys by their list position just like adding them one by one would
+ *
+ * @param index			the empty sorted index to fill
+ */
+static void buildSortedIndex(StoreIndex *index)
+{
+	int length = (int) g_queue_get_length(index->list->content.listValue);
+	SortingEntry *sortingEntries = (SortingEntry *) storeAllocateMemory((length > 0 ? length : 1) * sizeof(SortingEntry));
+
+	int size = 0;
+	int position = 0;
+	for(GList *iter = index->list->content.listValue->head; iter != NULL; iter = iter->next, position++) {
+		if(initEntry(index, (Store *) iter->data, &sortingEntries[size].entry)) {
+			sortingEntries[size].position = position;
+			size++;
+		}
+	}
+
+	qsort(sortingEntries, size, sizeof(SortingEntry), compareSortingEntries);
+
+	if(size > index->capacity) {
+		storeFreeMemory(index->entries);
+		index->capacity = size;
+		index->entries = (IndexEntry *) storeAllocateMemory(index->capacity * sizeof(IndexEntry));
+	}
+
+	for(int i = 0; i < size; i++) {
+		index->entries[i] = sortingEntries[i].entry;
+	}
+
+	index->size = size;
+	storeFreeMemory(sortingEntries);
+}
+
+static int compareSortingEntries(const void *first, const void *second)
+{
+	const SortingEntry *firstEntry = (const SortingEntry *) first;
+	const SortingEntry *secondEntry = (const SortingEntry *) second;
+
+	int comparison = compareKeys((Store *) &firstEntry->entry.key, (Store *) &secondEntry->entry.key);
+	if(comparison != 0) {
+		return comparison;
+	}
+
+	return firstEntry->position - secondEntry->position;
+}
+
+/**
+ * Reads the key of an element at the index's key path
+ *
+ * @param index			the index to read the key for
+ * @param element		the element to read the key of
+ * @param key			the store to copy the key into, the string of a string key is owned by the element
+ * @result				true if the element has an int or string key
+ */
+static bool getKey(StoreIndex *index, Store *element, Store *key)
+{
+	Store *value = storeGetPath(element, index->path);
+	if(value == NULL || (value->type != STORE_INT && value->type != STORE_STRING)) {
+		return false;
+	}
+
+	*key = *value;
+	return true;
+}
+
+static unsigned int hashIndexKey(Store *key)
+{
+	if(key->type == STORE_STRING) {
+		return storeHashString(key->content.stringValue);
+	}
+
+	// spread consecutive ints over the slots
+	return (unsigned int) key->content.intValue * 2654435761u;
+}
+
+static bool keysEqual(Store *first, Store *second)
+{
+	return compareKeys(first, second) == 0;
+}
+
+/**
+ * Compares two keys, ordering ints numerically before strings ordered by strcmp
+ */
+static int compareKeys(Store *first, Store *second)
+{
+	if(first->type != second->type) {
+		return first->type == STORE_INT ? -1 : 1;
+	}
+
+	if(first->type == STORE_STRING) {
+		return strcmp(first->content.stringValue, second->content.stringValue);
+	}
+
+	if(first->content.intValue != second->content.intValue) {
+		return first->content.intValue < second->content.intValue ? -1 : 1;
+	}
+
+	return 0;
+}
+
+static void freeEntryKey(IndexEntry *entry)
+{
+	if(entry->key.type == STORE_STRING) {
+		free(entry->key.content.stringValue);
+	}
+}
+
+static void insertHashEntry(StoreIndex *index, IndexEntry *entry)
+{
+	// keep the load including removed slots at most one half
+	if(2 * (index->used + 1) > index->capacity) {
+		rehash(index, 2 * (index->size + 1) > index->capacity / 2 ? 2 * index->capacity : index->capacity);
+	}
+
+	unsigned int mask = index->capacity - 1;
+	unsigned int slot = entry->hash & mask;
+	while(index->entries[slot].element != NULL) {
+		slot = (slot + 1) & mask;
+	}
+
+	if(!index->entries[slot].removed) {
+		index->used++;
+	}
+
+	index->entries[slot] = *entry;
+}
+
+/**
+ * Rebuilds the slots of a hash index, dropping removed ones
+ *
+ * @param index			the hash index to rebuild
+ * @param capacity		the new number of slots, a power of two
+ */
+static void rehash(StoreIndex *index, int capacity)
+{
+	IndexEntry *entries = index->entries;
+	int oldCapacity = index->capacity;
+
+	index->capacity = capacity;
+	index->used = 0;
+	index->entries = (IndexEntry *) storeAllocateMemory(capacity * sizeof(IndexEntry));
+	memset(index->entries, 0, capacity * sizeof(IndexEntry));
+
+	for(int i = 0; i < oldCapacity; i++) {
+		if(entries[i].element != NULL) {
+			insertHashEntry(index, &entries[i]);
+		}
+	}
+
+	storeFreeMemory(entries);
+}
+
+static void insertSortedEntry(StoreIndex *index, IndexEntry *entry)
+{
+	if(index->size == index->capacity) {
+		IndexEntry *entries = (IndexEntry *) storeAllocateMemory(2 * index->capacity * sizeof(IndexEntry));
+		memcpy(entries, index->entries, index->size * sizeof(IndexEntry));
+		storeFreeMemory(index->entries);
+		index->entries = entries;
+		index->capacity *= 2;
+	}
+
+	int position = findBound(index, &entry->key, true);
+	memmove(&index->entries[position + 1], &index->entries[position], (index->size - position) * sizeof(IndexEntry));
+	index->entries[position] = *entry;
+}
+
+/**
+ * Binary searches the entries of a sorted index for a key
+ *
+ * @param index			the sorted index to search
+ * @param key			the key to search for
+ * @param upper			whether to find the first entry greater than the key instead of the first one not less than it
+ * @result				the position of the found entry, or the size of the index if there is none
+ */
+static int findBound(StoreIndex *index, Store *key, bool upper)
+{
+	int low = 0;
+	int high = index->size;
+	while(low < high) {
+		int middle = low + (high - low) / 2;
+		int comparison = compareKeys(&index->entries[middle].key, key);
+		if(comparison < 0 || (upper && comparison == 0)) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	return low;
+}
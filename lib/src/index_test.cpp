@@ -0,0 +1,155 @@
+#include <string>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "index.c"
+
+class Index: public ::testing::Test {
+public:
+	virtual void SetUp() {
+		parser = storeCreateParser();
+		store = storeParse(parser, "[{id = 3, name = c} {id = 1, name = a} {name = none} {id = 2, name = b} {id = 2, name = d}]");
+		ASSERT_TRUE(store != NULL) << "test store should parse successfully";
+	}
+
+	virtual void TearDown() {
+		storeFree(store);
+		storeFreeParser(parser);
+	}
+
+protected:
+	Store *createElement(int id) {
+		Store *element = storeCreateMapValue();
+		storeMapInsert(element, "id", storeCreateIntValue(id));
+		storeMapInsert(element, "name", storeCreateStringValue(("element" + std::to_string(id)).c_str()));
+		return element;
+	}
+
+	StoreParser *parser;
+	Store *store;
+};
+
+TEST_F(Index, hashLookup)
+{
+	StoreIndex *index = storeCreateIndex(store, "id", STORE_INDEX_HASH);
+	ASSERT_TRUE(index != NULL) << "index over a list should be created";
+	ASSERT_EQ(storeIndexGetSize(index), 4) << "elements without a key should not be indexed";
+
+	Store *element = storeIndexLookupInt(index, 1);
+	ASSERT_TRUE(element != NULL) << "indexed key should be found";
+	ASSERT_STREQ(storeMapLookup(element, "name")->content.stringValue, "a") << "lookup should return the element with the key";
+	ASSERT_TRUE(storeIndexLookupInt(index, 4) == NULL) << "missing key should not be found";
+	ASSERT_TRUE(storeIndexLookupString(index, "1") == NULL) << "string key should not match an int key";
+	ASSERT_EQ(storeIndexLowerBound(index, storeMapLookup(element, "id")), -1) << "hash index should not support range queries";
+
+	StoreIndex *names = storeCreateIndex(store, "name", STORE_INDEX_HASH);
+	ASSERT_EQ(storeIndexLookupString(names, "none"), storeListGet(store, 2)) << "string key should be found";
+
+	storeFreeIndex(index);
+	// the remaining index is freed together with the list
+}
+
+TEST_F(Index, maintained)
+{
+	StoreIndex *index = storeCreateIndex(store, "id", STORE_INDEX_HASH);
+
+	for(int id = 10; id < 1000; id++) {
+		ASSERT_TRUE(storeListAppend(store, createElement(id))) << "appending to a list should succeed";
+	}
+	ASSERT_EQ(storeIndexGetSize(index), 994) << "appended elements should be indexed";
+	ASSERT_STREQ(storeMapLookup(storeIndexLookupInt(index, 500), "name")->content.stringValue, "element500") << "appended element should be found";
+
+	ASSERT_TRUE(storeListInsert(store, 0, createElement(-5))) << "inserting into a list should succeed";
+	ASSERT_EQ(storeIndexLookupInt(index, -5), storeListGet(store, 0)) << "inserted element should be found";
+
+	ASSERT_TRUE(storeListRemove(store, 1)) << "removing from a list should succeed";
+	ASSERT_TRUE(storeIndexLookupInt(index, 3) == NULL) << "removed element should not be found";
+	ASSERT_EQ(storeIndexGetSize(index), 994) << "removed element should not be indexed";
+
+	for(int i = storeListGetLength(store) - 1; i >= 0; i -= 2) {
+		storeListRemove(store, i);
+	}
+	for(int id = 10; id < 1000; id++) {
+		Store *element = storeIndexLookupInt(index, id);
+		if(element != NULL) {
+			ASSERT_EQ(storeMapLookup(element, "id")->content.intValue, id) << "remaining element should be found by its key";
+		}
+	}
+
+	ASSERT_FALSE(storeListRemove(store, 5000)) << "removing out of bounds should fail";
+	ASSERT_FALSE(storeListPack(store)) << "indexed list should not be packed";
+}
+
+TEST_F(Index, sortedRange)
+{
+	StoreIndex *index = storeCreateIndex(store, "id", STORE_INDEX_SORTED);
+	storeListAppend(store, createElement(0));
+
+	Store lower;
+	lower.type = STORE_INT;
+	lower.content.intValue = 1;
+	Store upper;
+	upper.type = STORE_INT;
+	upper.content.intValue = 2;
+
+	int begin = storeIndexLowerBound(index, &lower);
+	int end = storeIndexUpperBound(index, &upper);
+	ASSERT_EQ(begin, 1) << "lower bound should skip smaller keys";
+	ASSERT_EQ(end, 4) << "upper bound should include equal keys";
+
+	const char *solution[] = {"a", "b", "d"};
+	for(int position = begin; position < end; position++) {
+		Store *element = storeIndexGetElement(index, position);
+		ASSERT_STREQ(storeMapLookup(element, "name")->content.stringValue, solution[position - begin]) << "range should be sorted by key and then by indexing order";
+	}
+
+	storeListRemove(store, 3);
+	ASSERT_EQ(storeIndexUpperBound(index, &upper), 3) << "removed element should leave the sorted index";
+	ASSERT_EQ(storeIndexLookupInt(index, 2), storeListGet(store, 3)) << "lookup should find the remaining element with the key";
+}
+
+TEST_F(Index, sortedBuild)
+{
+	Store *list = storeCreateListValue();
+	for(int i = 0; i < 1000; i++) {
+		Store *element = storeCreateMapValue();
+		storeMapInsert(element, "id", storeCreateIntValue((i * 7919) % 500));
+		storeMapInsert(element, "position", storeCreateIntValue(i));
+		storeListAppend(list, element);
+	}
+
+	StoreIndex *index = storeCreateIndex(list, "id", STORE_INDEX_SORTED);
+	ASSERT_EQ(storeIndexGetSize(index), 1000) << "all elements should be indexed";
+
+	for(int position = 1; position < 1000; position++) {
+		Store *previous = storeIndexGetElement(index, position - 1);
+		Store *element = storeIndexGetElement(index, position);
+		int previousId = storeMapLookup(previous, "id")->content.intValue;
+		int id = storeMapLookup(element, "id")->content.intValue;
+		ASSERT_LE(previousId, id) << "elements should be sorted by key";
+		if(previousId == id) {
+			ASSERT_LT(storeMapLookup(previous, "position")->content.intValue, storeMapLookup(element, "position")->content.intValue) << "elements with equal keys should be sorted by list position";
+		}
+	}
+
+	storeListAppend(list, createElement(250));
+	ASSERT_EQ(storeIndexGetSize(index), 1001) << "appended element should be indexed";
+	ASSERT_EQ(storeIndexGetElement(index, storeIndexUpperBound(index, storeMapLookup(storeListGet(list, 1000), "id")) - 1), storeListGet(list, 1000)) << "appended element should follow the elements with an equal key";
+
+	storeFree(list);
+}
+
+TEST_F(Index, invalid)
+{
+	Store *notAList = storeCreateIntValue(1);
+	ASSERT_TRUE(storeCreateIndex(notAList, "id", STORE_INDEX_HASH) == NULL) << "index over a non list should fail";
+	ASSERT_TRUE(storeCreateIndex(store, "a..b", STORE_INDEX_HASH) == NULL) << "index with a malformed path should fail";
+	ASSERT_FALSE(storeListAppend(notAList, notAList)) << "appending to a non list should fail";
+	storeFree(notAList);
+}
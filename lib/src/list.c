@@ -0,0 +1,297 @@
+#include <stdint.h> // uint64_t
+
+#include <glib.h>
+
+#include "store/index.h"
+#include "store/list.h"
+#include "store/map.h"
+#include "store/memory.h"
+
+typedef struct {
+	/** The elements of the list, the first member so that a pointer to the list is also a pointer to the queue */
+	GQueue queue;
+	/** list of (StoreIndex *) maintained over the elements */
+	GList *indexes;
+	/** Whether the list was frozen and rejects modifications */
+	bool frozen;
+	/** The cached structural hash of a frozen list, or zero if it wasn't computed yet, see storeHash */
+	uint64_t hash;
+} StoreList;
+
+GQueue *storeCreateList()
+{
+	StoreList *list = storeAllocateMemoryType(StoreList);
+	g_queue_init(&list->queue);
+	list->indexes = NULL;
+	list->frozen = false;
+	list->hash = 0;
+	return &list->queue;
+}
+
+void storeFreeList(GQueue *queue)
+{
+	StoreList *list = (StoreList *) queue;
+
+	// freeing an index detaches it from the list
+	while(list->indexes != NULL) {
+		storeFreeIndex((StoreIndex *) list->indexes->data);
+	}
+
+	for(GList *iter = queue->head; iter != NULL; iter = iter->next) {
+		storeFree((Store *) iter->data);
+	}
+
+	g_queue_clear(queue);
+	storeFreeMemory(list);
+}
+
+GQueue *storeCopyList(GQueue *list, StoreCopyFunction copyElement, void *userData)
+{
+	GQueue *copy = storeCreateList();
+	for(GList *iter = list->head; iter != NULL; iter = iter->next) {
+		g_queue_push_tail(copy, copyElement((Store *) iter->data, userData));
+	}
+
+	return copy;
+}
+
+void storeFreezeList(GQueue *queue)
+{
+	((StoreList *) queue)->frozen = true;
+}
+
+uint64_t storeListGetCachedHash(GQueue *queue)
+{
+	return __atomic_load_n(&((StoreList *) queue)->hash, __ATOMIC_RELAXED);
+}
+
+void storeListCacheHash(GQueue *queue, uint64_t hash)
+{
+	StoreList *list = (StoreList *) queue;
+	if(list->frozen) {
+		// frozen lists may be hashed by multiple threads at once, which all compute the same hash
+		__atomic_store_n(&list->hash, hash, __ATOMIC_RELAXED);
+	}
+}
+
+size_t storeGetListMemorySize(GQueue *queue)
+{
+	return sizeof(StoreList) + g_queue_get_length(queue) * sizeof(GList);
+}
+
+void storeListAttachIndex(Store *store, StoreIndex *index)
+{
+	StoreList *list = (StoreList *) store->content.listValue;
+	list->indexes = g_list_append(list->indexes, index);
+}
+
+void storeListDetachIndex(Store *store, StoreIndex *index)
+{
+	StoreList *list = (StoreList *) store->content.listValue;
+	list->indexes = g_list_remove(list->indexes, index);
+}
+
+bool storeListHasIndexes(Store *store)
+{
+	return store->type == STORE_LIST && ((StoreList *) store->content.listValue)->indexes != NULL;
+}
+
+bool storeListIsFrozen(Store *store)
+{
+	return store->type == STORE_LIST && ((StoreList *) store->content.listValue)->frozen;
+}
+
+int storeListGetLength(Store *store)
+{
+	switch(store->type) {
+		case STORE_LIST:
+			return g_queue_get_length(store->content.listValue);
+		case STORE_INT_ARRAY:
+		case STORE_FLOAT_ARRAY:
+			return store->content.arrayValue->length;
+		default:
+			return -1;
+	}
+}
+
+Store *storeListGet(Store *store, int index)
+{
+	if(store->type != STORE_LIST || index < 0 || index >= (int) g_queue_get_length(store->content.listValue)) {
+		return NULL;
+	}
+
+	return (Store *) g_queue_peek_nth(store->content.listValue, index);
+}
+
+bool storeListGetElement(Store *store, int index, Store *element)
+{
+	if(index < 0 || index >= storeListGetLength(store)) {
+		return false;
+	}
+
+	switch(store->type) {
+		case STORE_INT_ARRAY:
+			element->type = STORE_INT;
+			element->content.intValue = store->content.arrayValue->intValues[index];
+		break;
+		case STORE_FLOAT_ARRAY:
+			element->type = STORE_FLOAT;
+			element->content.floatValue = store->content.arrayValue->floatValues[index];
+		break;
+		default:
+			*element = *storeListGet(store, index);
+		break;
+	}
+
+	return true;
+}
+
+int storeListGetInt(Store *store, int index, int defaultValue)
+{
+	Store element;
+	if(!storeListGetElement(store, index, &element) || element.type != STORE_INT) {
+		return defaultValue;
+	}
+
+	return element.content.intValue;
+}
+
+double storeListGetFloat(Store *store, int index, double defaultValue)
+{
+	Store element;
+	if(!storeListGetElement(store, index, &element)) {
+		return defaultValue;
+	}
+
+	switch(element.type) {
+		case STORE_FLOAT:
+			return element.content.floatValue;
+		case STORE_INT:
+			return element.content.intValue;
+		default:
+			return defaultValue;
+	}
+}
+
+bool storeListAppend(Store *store, Store *value)
+{
+	if(store->type != STORE_LIST || store->references > 1 || storeListIsFrozen(store)) {
+		return false;
+	}
+
+	StoreList *list = (StoreList *) store->content.listValue;
+	g_queue_push_tail(&list->queue, value);
+
+	for(GList *iter = list->indexes; iter != NULL; iter = iter->next) {
+		storeIndexAddElement((StoreIndex *) iter->data, value);
+	}
+
+	return true;
+}
+
+bool storeListInsert(Store *store, int index, Store *value)
+{
+	if(store->type != STORE_LIST || store->references > 1 || storeListIsFrozen(store) || index < 0 || index > (int) g_queue_get_length(store->content.listValue)) {
+		return false;
+	}
+
+	StoreList *list = (StoreList *) store->content.listValue;
+	g_queue_push_nth(&list->queue, value, index);
+
+	for(GList *iter = list->indexes; iter != NULL; iter = iter->next) {
+		storeIndexAddElement((StoreIndex *) iter->data, value);
+	}
+
+	return true;
+}
+
+bool storeListRemove(Store *store, int index)
+{
+	if(store->type != STORE_LIST || store->references > 1 || storeListIsFrozen(store) || index < 0 || index >= (int) g_queue_get_length(store->content.listValue)) {
+		return false;
+	}
+
+	StoreList *list = (StoreList *) store->content.listValue;
+	Store *element = (Store *) g_queue_pop_nth(&list->queue, index);
+
+	for(GList *iter = list->indexes; iter != NULL; iter = iter->next) {
+		storeIndexRemoveElement((StoreIndex *) iter->data, element);
+	}
+
+	storeFree(element);
+	return true;
+}
+
+bool storeListPack(Store *store)
+{
+	if(store->type != STORE_LIST || g_queue_is_empty(store->content.listValue)) {
+		return false;
+	}
+
+	if(store->references > 1 || ((StoreList *) store->content.listValue)->indexes != NULL || storeListIsFrozen(store)) {
+		return false;
+	}
+
+	GQueue *list = store->content.listValue;
+	StoreType elementType = ((Store *) list->head->data)->type;
+	if(elementType != STORE_INT && elementType != STORE_FLOAT) {
+		return false;
+	}
+
+	for(GList *iter = list->head; iter != NULL; iter = iter->next) {
+		if(((Store *) iter->data)->type != elementType) {
+			return false;
+		}
+	}
+
+	StoreArray *array = storeAllocateMemoryType(StoreArray);
+	array->length = g_queue_get_length(list);
+	array->intValues = NULL;
+	array->floatValues = NULL;
+	array->frozen = false;
+	if(elementType == STORE_INT) {
+		array->intValues = (int *) storeAllocateMemory(array->length * sizeof(int));
+	} else {
+		array->floatValues = (double *) storeAllocateMemory(array->length * sizeof(double));
+	}
+
+	int i = 0;
+	for(GList *iter = list->head; iter != NULL; iter = iter->next) {
+		Store *element = (Store *) iter->data;
+		if(elementType == STORE_INT) {
+			array->intValues[i] = element->content.intValue;
+		} else {
+			array->floatValues[i] = element->content.floatValue;
+		}
+
+		i++;
+	}
+	storeFreeList(list);
+
+	store->type = elementType == STORE_INT ? STORE_INT_ARRAY : STORE_FLOAT_ARRAY;
+	store->content.arrayValue = array;
+	return true;
+}
+
+void storePackLists(Store *store)
+{
+	// the lists below a shared store belong to its other owners as well
+	if(store->references > 1) {
+		return;
+	}
+
+	if(store->type == STORE_LIST) {
+		for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+			storePackLists((Store *) iter->data);
+		}
+
+		storeListPack(store);
+	} else if(store->type == STORE_MAP) {
+		StoreMapIterator iterator;
+		Store *value;
+		storeMapIteratorInit(&iterator, store);
+		while(storeMapIteratorNext(&iterator, NULL, &value)) {
+			storePackLists(value);
+		}
+	}
+}
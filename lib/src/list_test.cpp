@@ -0,0 +1,104 @@
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "list.c"
+
+static Store *createList(int numInts, int numFloats)
+{
+	Store *store = storeCreateListValue();
+	for(int i = 0; i < numInts; i++) {
+		g_queue_push_tail(store->content.listValue, storeCreateIntValue(i));
+	}
+	for(int i = 0; i < numFloats; i++) {
+		g_queue_push_tail(store->content.listValue, storeCreateFloatValue(i + 0.5));
+	}
+
+	return store;
+}
+
+TEST(List, packInts)
+{
+	Store *store = createList(100, 0);
+	ASSERT_TRUE(storeListPack(store)) << "list of ints should be packed";
+	ASSERT_EQ(store->type, STORE_INT_ARRAY) << "packed list should be an int array";
+	ASSERT_EQ(storeListGetLength(store), 100) << "packed list should keep its length";
+
+	for(int i = 0; i < 100; i++) {
+		ASSERT_EQ(storeListGetInt(store, i, -1), i) << "packed element " << i << " should be correct";
+		ASSERT_EQ(storeListGetFloat(store, i, -1.0), i) << "packed int element " << i << " should convert to float";
+	}
+	ASSERT_EQ(storeListGetInt(store, 100, -1), -1) << "out of bounds element should return the default";
+	ASSERT_TRUE(storeListGet(store, 0) == NULL) << "packed array elements should not be returned as stores";
+
+	storeFree(store);
+}
+
+TEST(List, packFloats)
+{
+	Store *store = createList(0, 10);
+	ASSERT_TRUE(storeListPack(store)) << "list of floats should be packed";
+	ASSERT_EQ(store->type, STORE_FLOAT_ARRAY) << "packed list should be a float array";
+
+	Store element;
+	ASSERT_TRUE(storeListGetElement(store, 3, &element)) << "packed element should be readable";
+	ASSERT_EQ(element.type, STORE_FLOAT) << "packed float element should be read as a float store";
+	ASSERT_EQ(element.content.floatValue, 3.5) << "packed element should be correct";
+	ASSERT_EQ(storeListGetInt(store, 3, -1), -1) << "float element should not be returned as int";
+
+	storeFree(store);
+}
+
+TEST(List, packMixed)
+{
+	Store *mixed = createList(2, 2);
+	ASSERT_FALSE(storeListPack(mixed)) << "list of ints and floats should not be packed";
+	ASSERT_EQ(mixed->type, STORE_LIST) << "unpacked list should remain a generic list";
+
+	Store element;
+	ASSERT_TRUE(storeListGetElement(mixed, 2, &element)) << "generic list element should be readable";
+	ASSERT_EQ(element.type, STORE_FLOAT) << "generic list element should keep its type";
+	ASSERT_EQ(storeListGetFloat(mixed, 2, -1.0), 0.5) << "generic list element should be correct";
+	storeFree(mixed);
+
+	Store *empty = createList(0, 0);
+	ASSERT_FALSE(storeListPack(empty)) << "empty list should not be packed";
+	storeFree(empty);
+
+	Store *shared = createList(3, 0);
+	storeRetain(shared);
+	ASSERT_FALSE(storeListPack(shared)) << "shared list should not be packed";
+	ASSERT_EQ(shared->type, STORE_LIST) << "shared list should remain a generic list";
+	storeFree(shared);
+	ASSERT_TRUE(storeListPack(shared)) << "no longer shared list should be packed";
+	storeFree(shared);
+
+	Store *notAList = storeCreateIntValue(0);
+	ASSERT_EQ(storeListGetLength(notAList), -1) << "length of a non list should be -1";
+	ASSERT_FALSE(storeListGetElement(notAList, 0, &element)) << "reading an element of a non list should fail";
+	storeFree(notAList);
+}
+
+TEST(List, parsePacked)
+{
+	StoreParser *parser = storeCreateParser();
+	storeSetParserFlags(parser, STORE_PARSE_PACK_LISTS);
+
+	Store *store = storeParse(parser, "series = [[1 2 3] [4.5 5.5] [1 2.5] [a b]]");
+	ASSERT_TRUE(store != NULL) << "store should parse successfully";
+
+	Store *series = storeMapLookup(store, "series");
+	ASSERT_EQ(series->type, STORE_LIST) << "list of lists should not be packed";
+	ASSERT_EQ(storeListGet(series, 0)->type, STORE_INT_ARRAY) << "nested list of ints should be packed";
+	ASSERT_EQ(storeListGet(series, 1)->type, STORE_FLOAT_ARRAY) << "nested list of floats should be packed";
+	ASSERT_EQ(storeListGet(series, 2)->type, STORE_LIST) << "nested mixed list should not be packed";
+	ASSERT_EQ(storeListGet(series, 3)->type, STORE_LIST) << "nested list of strings should not be packed";
+	ASSERT_EQ(storeListGetInt(storeListGet(series, 0), 2, -1), 3) << "packed element should be correct";
+
+	storeFree(store);
+	storeFreeParser(parser);
+}
@@ -0,0 +1,801 @@
+#include <stdlib.h> // free
+#include <string.h> // strcmp strdup strlen memcpy memmove memset
+
+#include "store/map.h"
+#include "store/memory.h"
+
+/**
+ * Maps with up to this many entries are searched linearly and don't allocate an index
+ */
+static const int smallMapThreshold = 8;
+
+/**
+ * Index slot markers for slots that never held an entry or whose entry was removed
+ */
+static const int emptySlot = -1;
+static const int removedSlot = -2;
+
+/**
+ * The average number of keys per bucket of a frozen map's perfect hash
+ */
+static const int perfectHashBucketSize = 4;
+
+/**
+ * The percentage of slots of a frozen map's perfect hash that are used, which leaves enough free slots for the last
+ * buckets to be placed quickly
+ */
+static const int perfectHashLoadPercent = 90;
+
+/**
+ * The number of pilots to try per bucket before giving up on a seed of a frozen map's perfect hash
+ */
+static const unsigned int perfectHashMaxPilots = 1u << 16;
+
+/**
+ * The number of seeds to try before giving up on building a perfect hash
+ */
+static const int perfectHashMaxSeeds = 8;
+
+typedef struct {
+	/** The entry's key, or NULL if the entry was removed */
+	char *key;
+	/** The cached hash of the key */
+	unsigned int hash;
+	/** The entry's value */
+	Store *value;
+} StoreMapEntry;
+
+struct StoreMapStruct {
+	/** The number of live entries in the map */
+	int size;
+	/** The number of used entries in the entry array, including removed ones */
+	int length;
+	/** The number of entries allocated in the entry array */
+	int capacity;
+	/** The dense entry array in insertion order */
+	StoreMapEntry *entries;
+	/** The number of slots in the index, a power of two, or zero while the map is small */
+	int indexCapacity;
+	/** The number of index slots that are not empty, including removed ones */
+	int indexUsed;
+	/** The open addressing index mapping hashed keys to entry array positions, NULL while the map is small */
+	int *index;
+	/** Whether the map was frozen and rejects modifications */
+	bool frozen;
+	/** The keys of a frozen map packed contiguously, referenced by the entries */
+	char *keyData;
+	/** The number of buckets of a frozen map's perfect hash */
+	int numBuckets;
+	/** The pilot of each bucket of a frozen map's perfect hash, in which case the index maps slots to entry positions */
+	unsigned int *pilots;
+	/** The seed of the key hash of a frozen map's perfect hash, see hashPerfectKey */
+	uint64_t perfectHashSeed;
+	/** The cached structural hash of a frozen map, or zero if it wasn't computed yet, see storeHash */
+	uint64_t hash;
+};
+
+static int findEntry(StoreMap *map, const char *key, unsigned int hash, int *slotPointer);
+static void appendEntry(StoreMap *map, char *key, unsigned int hash, Store *value);
+static void rebuildIndex(StoreMap *map, int indexCapacity);
+static void packKeys(StoreMap *map);
+static bool buildPerfectHash(StoreMap *map);
+static bool placePerfectHashBuckets(StoreMap *map, uint64_t seed, int numBuckets, int numSlots, int *slots, unsigned int *pilots);
+static uint64_t mixHash(uint64_t hash);
+static uint64_t hashPerfectKey(const char *key, uint64_t seed);
+static unsigned int getPerfectHashBucket(uint64_t keyHash, int numBuckets);
+static unsigned int getPerfectHashSlot(uint64_t keyHash, unsigned int pilot, int numSlots);
+
+StoreMap *storeCreateMap()
+{
+	StoreMap *map = storeAllocateMemoryType(StoreMap);
+	map->size = 0;
+	map->length = 0;
+	map->capacity = 0;
+	map->entries = NULL;
+	map->indexCapacity = 0;
+	map->indexUsed = 0;
+	map->index = NULL;
+	map->frozen = false;
+	map->keyData = NULL;
+	map->numBuckets = 0;
+	map->pilots = NULL;
+	map->perfectHashSeed = 0;
+	map->hash = 0;
+	return map;
+}
+
+void storeFreeMap(StoreMap *map)
+{
+	for(int i = 0; i < map->length; i++) {
+		if(map->entries[i].key != NULL) {
+			if(map->keyData == NULL) {
+				free(map->entries[i].key);
+			}
+			storeFree(map->entries[i].value);
+		}
+	}
+
+	storeFreeMemory(map->entries);
+	storeFreeMemory(map->index);
+	storeFreeMemory(map->keyData);
+	storeFreeMemory(map->pilots);
+	storeFreeMemory(map);
+}
+
+StoreMap *storeCopyMap(StoreMap *map, StoreCopyFunction copyValue, void *userData)
+{
+	StoreMap *copy = storeCreateMap();
+	if(map->size == 0) {
+		return copy;
+	}
+
+	copy->entries = (StoreMapEntry *) storeAllocateMemory(map->size * sizeof(StoreMapEntry));
+	copy->capacity = map->size;
+	for(int i = 0; i < map->length; i++) {
+		if(map->entries[i].key != NULL) {
+			copy->entries[copy->length].key = strdup(map->entries[i].key);
+			copy->entries[copy->length].hash = map->entries[i].hash;
+			copy->entries[copy->length].value = copyValue(map->entries[i].value, userData);
+			copy->length++;
+		}
+	}
+	copy->size = copy->length;
+
+	if(copy->size > smallMapThreshold) {
+		// size the index like a map that grew to the same size
+		int indexCapacity = 4 * smallMapThreshold;
+		while(3 * copy->size > indexCapacity) {
+			indexCapacity *= 2;
+		}
+
+		rebuildIndex(copy, indexCapacity);
+	}
+
+	return copy;
+}
+
+size_t storeGetMapMemorySize(StoreMap *map)
+{
+	size_t size = sizeof(StoreMap) + map->capacity * sizeof(StoreMapEntry) + map->indexCapacity * sizeof(int) + map->numBuckets * sizeof(unsigned int);
+	for(int i = 0; i < map->length; i++) {
+		if(map->entries[i].key != NULL) {
+			size += strlen(map->entries[i].key) + 1;
+		}
+	}
+
+	return size;
+}
+
+unsigned int storeHashString(const char *key)
+{
+	unsigned int hash = 2166136261u;
+	for(const unsigned char *c = (const unsigned char *) key; *c != '\0'; c++) {
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+void storeFreezeMap(StoreMap *map)
+{
+	if(map->frozen) {
+		return;
+	}
+
+	if(map->size < map->length) {
+		rebuildIndex(map, map->indexCapacity);
+	}
+
+	if(map->length < map->capacity) {
+		StoreMapEntry *entries = (StoreMapEntry *) storeAllocateMemory(map->length * sizeof(StoreMapEntry));
+		memcpy(entries, map->entries, map->length * sizeof(StoreMapEntry));
+		storeFreeMemory(map->entries);
+		map->entries = entries;
+		map->capacity = map->length;
+	}
+
+	packKeys(map);
+
+	// if no perfect hash can be found for any seed, the regular index is kept
+	buildPerfectHash(map);
+
+	map->frozen = true;
+}
+
+uint64_t storeMapGetCachedHash(StoreMap *map)
+{
+	return __atomic_load_n(&map->hash, __ATOMIC_RELAXED);
+}
+
+void storeMapCacheHash(StoreMap *map, uint64_t hash)
+{
+	if(map->frozen) {
+		// frozen maps may be hashed by multiple threads at once, which all compute the same hash
+		__atomic_store_n(&map->hash, hash, __ATOMIC_RELAXED);
+	}
+}
+
+bool storeMapIsFrozen(Store *store)
+{
+	return store->type == STORE_MAP && store->content.mapValue->frozen;
+}
+
+int storeMapGetSize(Store *store)
+{
+	if(store->type != STORE_MAP) {
+		return -1;
+	}
+
+	return store->content.mapValue->size;
+}
+
+Store *storeMapLookup(Store *store, const char *key)
+{
+	if(store->type != STORE_MAP) {
+		return NULL;
+	}
+
+	StoreMap *map = store->content.mapValue;
+	int position = findEntry(map, key, storeHashString(key), NULL);
+	if(position < 0) {
+		return NULL;
+	}
+
+	return map->entries[position].value;
+}
+
+StoreKey *storeCreateKey(const char *string)
+{
+	StoreKey *key = storeAllocateMemoryType(StoreKey);
+	key->string = strdup(string);
+	key->hash = storeHashString(string);
+	return key;
+}
+
+void storeFreeKey(StoreKey *key)
+{
+	free(key->string);
+	storeFreeMemory(key);
+}
+
+Store *storeMapGet(Store *store, StoreKey *key)
+{
+	if(store->type != STORE_MAP) {
+		return NULL;
+	}
+
+	StoreMap *map = store->content.mapValue;
+	int position = findEntry(map, key->string, key->hash, NULL);
+	if(position < 0) {
+		return NULL;
+	}
+
+	return map->entries[position].value;
+}
+
+int storeMapGetInt(Store *store, StoreKey *key, int defaultValue)
+{
+	Store *value = storeMapGet(store, key);
+	if(value == NULL || value->type != STORE_INT) {
+		return defaultValue;
+	}
+
+	return value->content.intValue;
+}
+
+double storeMapGetFloat(Store *store, StoreKey *key, double defaultValue)
+{
+	Store *value = storeMapGet(store, key);
+	if(value == NULL) {
+		return defaultValue;
+	}
+
+	switch(value->type) {
+		case STORE_FLOAT:
+			return value->content.floatValue;
+		case STORE_INT:
+			return value->content.intValue;
+		default:
+			return defaultValue;
+	}
+}
+
+const char *storeMapGetString(Store *store, StoreKey *key, const char *defaultValue)
+{
+	Store *value = storeMapGet(store, key);
+	if(value == NULL || value->type != STORE_STRING) {
+		return defaultValue;
+	}
+
+	return value->content.stringValue;
+}
+
+bool storeMapInsert(Store *store, const char *key, Store *value)
+{
+	if(store->type != STORE_MAP) {
+		return false;
+	}
+
+	StoreMap *map = store->content.mapValue;
+	if(map->frozen || store->references > 1) {
+		return false;
+	}
+
+	unsigned int hash = storeHashString(key);
+	int position = findEntry(map, key, hash, NULL);
+	if(position >= 0) {
+		// replaced entries keep their original position in the iteration order
+		storeFree(map->entries[position].value);
+		map->entries[position].value = value;
+		return false;
+	}
+
+	appendEntry(map, strdup(key), hash, value);
+	return true;
+}
+
+bool storeMapRemove(Store *store, const char *key)
+{
+	if(store->type != STORE_MAP) {
+		return false;
+	}
+
+	StoreMap *map = store->content.mapValue;
+	if(map->frozen || store->references > 1) {
+		return false;
+	}
+
+	int slot = emptySlot;
+	int position = findEntry(map, key, storeHashString(key), &slot);
+	if(position < 0) {
+		return false;
+	}
+
+	free(map->entries[position].key);
+	storeFree(map->entries[position].value);
+	map->size--;
+
+	if(map->index == NULL) {
+		// small maps are cheap to keep dense
+		memmove(&map->entries[position], &map->entries[position + 1], (map->length - position - 1) * sizeof(StoreMapEntry));
+		map->length--;
+	} else {
+		// leave a hole so that the positions referenced by the index stay valid
+		map->entries[position].key = NULL;
+		map->entries[position].value = NULL;
+		map->index[slot] = removedSlot;
+	}
+
+	return true;
+}
+
+void storeMapIteratorInit(StoreMapIterator *iterator, Store *store)
+{
+	iterator->map = store->type == STORE_MAP ? store->content.mapValue : NULL;
+	iterator->index = 0;
+}
+
+bool storeMapIteratorNext(StoreMapIterator *iterator, const char **key, Store **value)
+{
+	StoreMap *map = iterator->map;
+	if(map == NULL) {
+		return false;
+	}
+
+	while(iterator->index < map->length) {
+		StoreMapEntry *entry = &map->entries[iterator->index];
+		iterator->index++;
+
+		if(entry->key == NULL) {
+			continue;
+		}
+
+		if(key != NULL) {
+			*key = entry->key;
+		}
+		if(value != NULL) {
+			*value = entry->value;
+		}
+		return true;
+	}
+
+	return false;
+}
+
+void storeMapIteratorReplace(StoreMapIterator *iterator, Store *value)
+{
+	iterator->map->entries[iterator->index - 1].value = value;
+}
+
+/**
+ * Finds the position of an entry in the entry array
+ *
+ * @param map			the map to search
+ * @param key			the key to search for
+ * @param hash			the hash of the key
+ * @param slotPointer	if not NULL and the map has an index, set to the index slot referencing the entry
+ * @result				the position of the entry, or -1 if there is no entry for the key
+ */
+static int findEntry(StoreMap *map, const char *key, unsigned int hash, int *slotPointer)
+{
+	if(map->pilots != NULL) {
+		// a frozen map's perfect hash needs a single probe
+		uint64_t keyHash = hashPerfectKey(key, map->perfectHashSeed);
+		unsigned int bucket = getPerfectHashBucket(keyHash, map->numBuckets);
+		int position = map->index[getPerfectHashSlot(keyHash, map->pilots[bucket], map->indexCapacity)];
+		if(position == emptySlot) {
+			return -1;
+		}
+
+		StoreMapEntry *entry = &map->entries[position];
+		if(entry->hash == hash && strcmp(entry->key, key) == 0) {
+			return position;
+		}
+
+		return -1;
+	}
+
+	if(map->index == NULL) {
+		for(int i = 0; i < map->length; i++) {
+			StoreMapEntry *entry = &map->entries[i];
+			if(entry->hash == hash && strcmp(entry->key, key) == 0) {
+				return i;
+			}
+		}
+
+		return -1;
+	}
+
+	unsigned int mask = map->indexCapacity - 1;
+	for(unsigned int slot = hash & mask; map->index[slot] != emptySlot; slot = (slot + 1) & mask) {
+		int position = map->index[slot];
+		if(position == removedSlot) {
+			continue;
+		}
+
+		StoreMapEntry *entry = &map->entries[position];
+		if(entry->hash == hash && strcmp(entry->key, key) == 0) {
+			if(slotPointer != NULL) {
+				*slotPointer = slot;
+			}
+			return position;
+		}
+	}
+
+	return -1;
+}
+
+static void appendEntry(StoreMap *map, char *key, unsigned int hash, Store *value)
+{
+	if(map->length == map->capacity) {
+		if(map->size < map->length) {
+			// reclaim the holes left by removals before growing
+			rebuildIndex(map, map->indexCapacity);
+		}
+
+		if(map->length == map->capacity) {
+			int capacity = map->capacity == 0 ? 2 : 2 * map->capacity;
+			StoreMapEntry *entries = (StoreMapEntry *) storeAllocateMemory(capacity * sizeof(StoreMapEntry));
+			if(map->entries != NULL) {
+				memcpy(entries, map->entries, map->length * sizeof(StoreMapEntry));
+				storeFreeMemory(map->entries);
+			}
+
+			map->entries = entries;
+			map->capacity = capacity;
+		}
+	}
+
+	int position = map->length;
+	map->entries[position].key = key;
+	map->entries[position].hash = hash;
+	map->entries[position].value = value;
+	map->length++;
+	map->size++;
+
+	if(map->index == NULL) {
+		if(map->size > smallMapThreshold) {
+			rebuildIndex(map, 4 * smallMapThreshold);
+		}
+		return;
+	}
+
+	// keep the index at most two thirds full
+	if(3 * (map->indexUsed + 1) > 2 * map->indexCapacity) {
+		int indexCapacity = map->indexCapacity;
+		while(3 * map->size > indexCapacity) {
+			indexCapacity *= 2;
+		}
+
+		rebuildIndex(map, indexCapacity);
+		return;
+	}
+
+	unsigned int mask = map->indexCapacity - 1;
+	unsigned int slot = hash & mask;
+	while(map->index[slot] >= 0) {
+		slot = (slot + 1) & mask;
+	}
+
+	if(map->index[slot] == emptySlot) {
+		map->indexUsed++;
+	}
+	map->index[slot] = position;
+}
+
+/**
+ * Rebuilds the index of a map, compacting away the holes left by removed entries
+ *
+ * @param map			the map to rebuild the index for
+ * @param indexCapacity	the new number of index slots, must be a power of two
+ */
+static void rebuildIndex(StoreMap *map, int indexCapacity)
+{
+	if(map->size < map->length) {
+		int length = 0;
+		for(int i = 0; i < map->length; i++) {
+			if(map->entries[i].key != NULL) {
+				map->entries[length] = map->entries[i];
+				length++;
+			}
+		}
+		map->length = length;
+	}
+
+	storeFreeMemory(map->index);
+	map->index = (int *) storeAllocateMemory(indexCapacity * sizeof(int));
+	map->indexCapacity = indexCapacity;
+	map->indexUsed = map->length;
+	for(int i = 0; i < indexCapacity; i++) {
+		map->index[i] = emptySlot;
+	}
+
+	unsigned int mask = indexCapacity - 1;
+	for(int i = 0; i < map->length; i++) {
+		unsigned int slot = map->entries[i].hash & mask;
+		while(map->index[slot] != emptySlot) {
+			slot = (slot + 1) & mask;
+		}
+		map->index[slot] = i;
+	}
+}
+
+/**
+ * Moves the keys of a map into a single contiguous block
+ *
+ * @param map			the map to pack the keys of, must not contain removed entries
+ */
+static void packKeys(StoreMap *map)
+{
+	if(map->length == 0) {
+		return;
+	}
+
+	size_t size = 0;
+	for(int i = 0; i < map->length; i++) {
+		size += strlen(map->entries[i].key) + 1;
+	}
+
+	map->keyData = (char *) storeAllocateMemory(size);
+
+	char *key = map->keyData;
+	for(int i = 0; i < map->length; i++) {
+		size_t keySize = strlen(map->entries[i].key) + 1;
+		memcpy(key, map->entries[i].key, keySize);
+		free(map->entries[i].key);
+		map->entries[i].key = key;
+		key += keySize;
+	}
+}
+
+/**
+ * Builds a perfect hash over the keys of a map using the hash and displace algorithm.
+ * The keys are hashed with a seeded 64 bit hash of their characters and distributed into buckets, and then the
+ * buckets are placed into the slots from largest to smallest, searching for each bucket a pilot for which all of its
+ * keys land in free slots. If a bucket can't be placed, the search is repeated with another seed.
+ *
+ * @param map			the map to build a perfect hash for, must not contain removed entries
+ * @result				true if a perfect hash was built and replaced the map's index
+ */
+static bool buildPerfectHash(StoreMap *map)
+{
+	int numKeys = map->length;
+	if(numKeys == 0) {
+		return false;
+	}
+
+	int numBuckets = (numKeys + perfectHashBucketSize - 1) / perfectHashBucketSize;
+	int numSlots = (int) ((long long) numKeys * 100 / perfectHashLoadPercent) + 1;
+	int *slots = (int *) storeAllocateMemory(numSlots * sizeof(int));
+	unsigned int *pilots = (unsigned int *) storeAllocateMemory(numBuckets * sizeof(unsigned int));
+
+	uint64_t seed = 0;
+	bool success = false;
+	for(int i = 0; i < perfectHashMaxSeeds && !success; i++) {
+		seed = mixHash(0x9e3779b97f4a7c15ull * (i + 1));
+		success = placePerfectHashBuckets(map, seed, numBuckets, numSlots, slots, pilots);
+	}
+
+	if(!success) {
+		storeFreeMemory(slots);
+		storeFreeMemory(pilots);
+		return false;
+	}
+
+	storeFreeMemory(map->index);
+	map->index = slots;
+	map->indexCapacity = numSlots;
+	map->indexUsed = numKeys;
+	map->numBuckets = numBuckets;
+	map->pilots = pilots;
+	map->perfectHashSeed = seed;
+	return true;
+}
+
+/**
+ * Searches the pilots of a perfect hash for one seed
+ *
+ * @param map			the map to build a perfect hash for
+ * @param seed			the seed of the key hash
+ * @param numBuckets	the number of buckets to distribute the keys into
+ * @param numSlots		the number of slots to place the keys into
+ * @param slots			the slots to fill with entry positions
+ * @param pilots		the pilots to fill for each bucket
+ * @result				true if all buckets were placed, false if two keys share their hash or a bucket couldn't be placed
+ */
+static bool placePerfectHashBuckets(StoreMap *map, uint64_t seed, int numBuckets, int numSlots, int *slots, unsigned int *pilots)
+{
+	int numKeys = map->length;
+	uint64_t *keyHashes = (uint64_t *) storeAllocateMemory(numKeys * sizeof(uint64_t));
+	for(int i = 0; i < numKeys; i++) {
+		keyHashes[i] = hashPerfectKey(map->entries[i].key, seed);
+	}
+
+	// counting sort the keys by bucket
+	int *bucketStarts = (int *) storeAllocateMemory((numBuckets + 1) * sizeof(int));
+	int *bucketKeys = (int *) storeAllocateMemory(numKeys * sizeof(int));
+	memset(bucketStarts, 0, (numBuckets + 1) * sizeof(int));
+	for(int i = 0; i < numKeys; i++) {
+		bucketStarts[getPerfectHashBucket(keyHashes[i], numBuckets) + 1]++;
+	}
+
+	int maxBucketSize = 0;
+	for(int b = 0; b < numBuckets; b++) {
+		if(bucketStarts[b + 1] > maxBucketSize) {
+			maxBucketSize = bucketStarts[b + 1];
+		}
+		bucketStarts[b + 1] += bucketStarts[b];
+	}
+
+	int *bucketFill = (int *) storeAllocateMemory(numBuckets * sizeof(int));
+	memset(bucketFill, 0, numBuckets * sizeof(int));
+	for(int i = 0; i < numKeys; i++) {
+		int bucket = getPerfectHashBucket(keyHashes[i], numBuckets);
+		bucketKeys[bucketStarts[bucket] + bucketFill[bucket]] = i;
+		bucketFill[bucket]++;
+	}
+
+	// keys sharing their hash share their bucket and can't be separated by any pilot, so check for them up front
+	bool success = true;
+	for(int b = 0; b < numBuckets && success; b++) {
+		for(int k = bucketStarts[b]; k < bucketStarts[b + 1] && success; k++) {
+			for(int j = bucketStarts[b]; j < k && success; j++) {
+				if(keyHashes[bucketKeys[j]] == keyHashes[bucketKeys[k]]) {
+					success = false;
+				}
+			}
+		}
+	}
+
+	// counting sort the buckets by descending size
+	int *sizeStarts = (int *) storeAllocateMemory((maxBucketSize + 2) * sizeof(int));
+	int *bucketOrder = (int *) storeAllocateMemory(numBuckets * sizeof(int));
+	memset(sizeStarts, 0, (maxBucketSize + 2) * sizeof(int));
+	for(int b = 0; b < numBuckets; b++) {
+		sizeStarts[maxBucketSize - bucketFill[b] + 1]++;
+	}
+	for(int size = 0; size <= maxBucketSize; size++) {
+		sizeStarts[size + 1] += sizeStarts[size];
+	}
+	for(int b = 0; b < numBuckets; b++) {
+		bucketOrder[sizeStarts[maxBucketSize - bucketFill[b]]++] = b;
+	}
+
+	for(int i = 0; i < numSlots; i++) {
+		slots[i] = emptySlot;
+	}
+
+	unsigned int *candidates = (unsigned int *) storeAllocateMemory((maxBucketSize > 0 ? maxBucketSize : 1) * sizeof(unsigned int));
+	for(int i = 0; i < numBuckets && success; i++) {
+		int bucket = bucketOrder[i];
+		int bucketSize = bucketFill[bucket];
+		pilots[bucket] = 0;
+
+		if(bucketSize == 0) {
+			continue;
+		}
+
+		bool placed = false;
+		for(unsigned int pilot = 0; pilot < perfectHashMaxPilots && !placed; pilot++) {
+			placed = true;
+			for(int k = 0; k < bucketSize && placed; k++) {
+				unsigned int slot = getPerfectHashSlot(keyHashes[bucketKeys[bucketStarts[bucket] + k]], pilot, numSlots);
+				if(slots[slot] != emptySlot) {
+					placed = false;
+				}
+
+				for(int j = 0; j < k && placed; j++) {
+					if(candidates[j] == slot) {
+						placed = false;
+					}
+				}
+
+				candidates[k] = slot;
+			}
+
+			if(placed) {
+				pilots[bucket] = pilot;
+			}
+		}
+
+		if(!placed) {
+			success = false;
+			break;
+		}
+
+		for(int k = 0; k < bucketSize; k++) {
+			slots[candidates[k]] = bucketKeys[bucketStarts[bucket] + k];
+		}
+	}
+
+	storeFreeMemory(keyHashes);
+	storeFreeMemory(bucketStarts);
+	storeFreeMemory(bucketKeys);
+	storeFreeMemory(bucketFill);
+	storeFreeMemory(sizeStarts);
+	storeFreeMemory(bucketOrder);
+	storeFreeMemory(candidates);
+	return success;
+}
+
+/**
+ * Mixes the bits of a hash using the SplitMix64 finalizer
+ */
+static uint64_t mixHash(uint64_t hash)
+{
+	hash ^= hash >> 30;
+	hash *= 0xbf58476d1ce4e5b9ull;
+	hash ^= hash >> 27;
+	hash *= 0x94d049bb133111ebull;
+	hash ^= hash >> 31;
+	return hash;
+}
+
+/**
+ * Hashes the characters of a key for a frozen map's perfect hash, independently of the key's cached 32 bit hash so that
+ * keys sharing that hash can still be told apart
+ *
+ * @param key			the key to hash
+ * @param seed			the seed selecting the hash function
+ * @result				the 64 bit hash of the key
+ */
+static uint64_t hashPerfectKey(const char *key, uint64_t seed)
+{
+	uint64_t hash = 14695981039346656037ull ^ seed;
+	for(const unsigned char *c = (const unsigned char *) key; *c != '\0'; c++) {
+		hash ^= *c;
+		hash *= 1099511628211ull;
+	}
+
+	return mixHash(hash);
+}
+
+static unsigned int getPerfectHashBucket(uint64_t keyHash, int numBuckets)
+{
+	return (unsigned int) ((keyHash >> 32) % (unsigned int) numBuckets);
+}
+
+static unsigned int getPerfectHashSlot(uint64_t keyHash, unsigned int pilot, int numSlots)
+{
+	return (unsigned int) (mixHash(keyHash ^ (0x9e3779b97f4a7c15ull * (pilot + 1))) % (unsigned int) numSlots);
+}
@@ -0,0 +1,301 @@
+#include <string>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/store.h>
+}
+
+#include "map.c"
+
+TEST(Map, insertLookup)
+{
+	Store *store = storeCreateMapValue();
+	ASSERT_EQ(storeMapGetSize(store), 0) << "created map should be empty";
+
+	bool inserted = storeMapInsert(store, "foo", storeCreateIntValue(42));
+	ASSERT_TRUE(inserted) << "inserting a new key should report an insertion";
+	ASSERT_EQ(storeMapGetSize(store), 1) << "map should have one entry after inserting";
+
+	Store *value = storeMapLookup(store, "foo");
+	ASSERT_TRUE(value != NULL) << "looking up an inserted key should not return NULL";
+	ASSERT_EQ(value->type, STORE_INT) << "looked up value should be a store of type int";
+	ASSERT_EQ(value->content.intValue, 42) << "looked up value should have the inserted int value";
+	ASSERT_TRUE(storeMapLookup(store, "bar") == NULL) << "looking up a missing key should return NULL";
+
+	storeFree(store);
+}
+
+TEST(Map, insertReplace)
+{
+	Store *store = storeCreateMapValue();
+	storeMapInsert(store, "foo", storeCreateIntValue(1));
+
+	bool inserted = storeMapInsert(store, "foo", storeCreateStringValue("bar"));
+	ASSERT_FALSE(inserted) << "inserting an existing key should report a replacement";
+	ASSERT_EQ(storeMapGetSize(store), 1) << "replacing a value should not change the map size";
+
+	Store *value = storeMapLookup(store, "foo");
+	ASSERT_EQ(value->type, STORE_STRING) << "looked up value should be the replacing store";
+	ASSERT_STREQ(value->content.stringValue, "bar") << "looked up value should have the replacing string value";
+
+	storeFree(store);
+}
+
+TEST(Map, remove)
+{
+	Store *store = storeCreateMapValue();
+	storeMapInsert(store, "a", storeCreateIntValue(1));
+	storeMapInsert(store, "b", storeCreateIntValue(2));
+	storeMapInsert(store, "c", storeCreateIntValue(3));
+
+	ASSERT_TRUE(storeMapRemove(store, "b")) << "removing an existing key should succeed";
+	ASSERT_FALSE(storeMapRemove(store, "b")) << "removing a missing key should fail";
+	ASSERT_EQ(storeMapGetSize(store), 2) << "map should have two entries after removing";
+	ASSERT_TRUE(storeMapLookup(store, "b") == NULL) << "removed key should no longer be found";
+	ASSERT_EQ(storeMapLookup(store, "c")->content.intValue, 3) << "remaining keys should still be found";
+
+	storeFree(store);
+}
+
+TEST(Map, insertionOrder)
+{
+	Store *store = storeCreateMapValue();
+	storeMapInsert(store, "zeta", storeCreateIntValue(0));
+	storeMapInsert(store, "alpha", storeCreateIntValue(1));
+	storeMapInsert(store, "mu", storeCreateIntValue(2));
+	storeMapInsert(store, "alpha", storeCreateIntValue(3));
+
+	const char *solution[] = {"zeta", "alpha", "mu"};
+	int solutionValues[] = {0, 3, 2};
+
+	int i = 0;
+	const char *key;
+	Store *value;
+	StoreMapIterator iter;
+	storeMapIteratorInit(&iter, store);
+	while(storeMapIteratorNext(&iter, &key, &value)) {
+		ASSERT_LT(i, 3) << "iterator should visit exactly three entries";
+		ASSERT_STREQ(key, solution[i]) << "iterator should visit keys in insertion order";
+		ASSERT_EQ(value->content.intValue, solutionValues[i]) << "replaced values should keep their original position";
+		i++;
+	}
+	ASSERT_EQ(i, 3) << "iterator should visit exactly three entries";
+
+	storeFree(store);
+}
+
+TEST(Map, upgradeBeyondThreshold)
+{
+	Store *store = storeCreateMapValue();
+
+	int numEntries = 4 * smallMapThreshold;
+	for(int i = 0; i < numEntries; i++) {
+		std::string key = "key" + std::to_string(i);
+		ASSERT_TRUE(storeMapInsert(store, key.c_str(), storeCreateIntValue(i))) << "inserting a new key should report an insertion";
+	}
+
+	ASSERT_EQ(storeMapGetSize(store), numEntries) << "map should contain all inserted entries";
+	ASSERT_TRUE(store->content.mapValue->index != NULL) << "map should have built an index";
+
+	for(int i = 0; i < numEntries; i++) {
+		std::string key = "key" + std::to_string(i);
+		Store *value = storeMapLookup(store, key.c_str());
+		ASSERT_TRUE(value != NULL) << "looking up key " << key << " should not return NULL";
+		ASSERT_EQ(value->content.intValue, i) << "looked up value for key " << key << " should be correct";
+	}
+
+	int expected = 0;
+	StoreMapIterator iter;
+	storeMapIteratorInit(&iter, store);
+	Store *value;
+	while(storeMapIteratorNext(&iter, NULL, &value)) {
+		ASSERT_EQ(value->content.intValue, expected) << "iterating the indexed map should visit entries in insertion order";
+		expected++;
+	}
+	ASSERT_EQ(expected, numEntries) << "iterating the indexed map should visit every entry once";
+
+	storeFree(store);
+}
+
+TEST(Map, removeIndexed)
+{
+	Store *store = storeCreateMapValue();
+
+	int numEntries = 1000;
+	for(int i = 0; i < numEntries; i++) {
+		std::string key = "key" + std::to_string(i);
+		storeMapInsert(store, key.c_str(), storeCreateIntValue(i));
+	}
+
+	for(int i = 0; i < numEntries; i += 2) {
+		std::string key = "key" + std::to_string(i);
+		ASSERT_TRUE(storeMapRemove(store, key.c_str())) << "removing key " << key << " should succeed";
+	}
+	ASSERT_EQ(storeMapGetSize(store), numEntries / 2) << "map should have half of its entries left";
+
+	// reinserting fills the holes left by the removals
+	for(int i = 0; i < numEntries; i += 2) {
+		std::string key = "key" + std::to_string(i);
+		ASSERT_TRUE(storeMapInsert(store, key.c_str(), storeCreateIntValue(i))) << "reinserting key " << key << " should succeed";
+	}
+
+	for(int i = 0; i < numEntries; i++) {
+		std::string key = "key" + std::to_string(i);
+		Store *value = storeMapLookup(store, key.c_str());
+		ASSERT_TRUE(value != NULL) << "looking up key " << key << " should not return NULL";
+		ASSERT_EQ(value->content.intValue, i) << "looked up value for key " << key << " should be correct";
+	}
+
+	int i = 0;
+	Store *value;
+	StoreMapIterator iter;
+	storeMapIteratorInit(&iter, store);
+	while(storeMapIteratorNext(&iter, NULL, &value)) {
+		int expected = i < numEntries / 2 ? 2 * i + 1 : 2 * (i - numEntries / 2);
+		ASSERT_EQ(value->content.intValue, expected) << "reinserted entries should be iterated after the remaining ones";
+		i++;
+	}
+	ASSERT_EQ(i, numEntries) << "iterator should visit every entry once";
+
+	storeFree(store);
+}
+
+TEST(Map, keyHandles)
+{
+	Store *store = storeCreateMapValue();
+	storeMapInsert(store, "port", storeCreateIntValue(8080));
+	storeMapInsert(store, "ratio", storeCreateFloatValue(0.5));
+	storeMapInsert(store, "timeout", storeCreateIntValue(30));
+	storeMapInsert(store, "host", storeCreateStringValue("localhost"));
+
+	StoreKey *port = storeCreateKey("port");
+	StoreKey *ratio = storeCreateKey("ratio");
+	StoreKey *timeout = storeCreateKey("timeout");
+	StoreKey *host = storeCreateKey("host");
+	StoreKey *missing = storeCreateKey("missing");
+
+	ASSERT_EQ(storeMapGet(store, port), storeMapLookup(store, "port")) << "looking up a key handle should find the same value as looking up its string";
+	ASSERT_TRUE(storeMapGet(store, missing) == NULL) << "looking up a missing key handle should return NULL";
+
+	ASSERT_EQ(storeMapGetInt(store, port, -1), 8080) << "int getter should return the stored int";
+	ASSERT_EQ(storeMapGetInt(store, host, -1), -1) << "int getter should return the default for a string";
+	ASSERT_EQ(storeMapGetInt(store, missing, -1), -1) << "int getter should return the default for a missing key";
+	ASSERT_EQ(storeMapGetFloat(store, ratio, -1.0), 0.5) << "float getter should return the stored float";
+	ASSERT_EQ(storeMapGetFloat(store, timeout, -1.0), 30.0) << "float getter should convert a stored int";
+	ASSERT_EQ(storeMapGetFloat(store, host, -1.0), -1.0) << "float getter should return the default for a string";
+	ASSERT_STREQ(storeMapGetString(store, host, "default"), "localhost") << "string getter should return the stored string";
+	ASSERT_STREQ(storeMapGetString(store, port, "default"), "default") << "string getter should return the default for an int";
+
+	storeFreeKey(port);
+	storeFreeKey(ratio);
+	storeFreeKey(timeout);
+	storeFreeKey(host);
+	storeFreeKey(missing);
+	storeFree(store);
+}
+
+TEST(Map, notAMap)
+{
+	Store *store = storeCreateIntValue(42);
+	Store *value = storeCreateIntValue(1);
+
+	ASSERT_EQ(storeMapGetSize(store), -1) << "size of a non-map store should be -1";
+	ASSERT_TRUE(storeMapLookup(store, "foo") == NULL) << "lookup in a non-map store should return NULL";
+	ASSERT_FALSE(storeMapInsert(store, "foo", value)) << "inserting into a non-map store should fail";
+
+	StoreMapIterator iter;
+	storeMapIteratorInit(&iter, store);
+	ASSERT_FALSE(storeMapIteratorNext(&iter, NULL, NULL)) << "iterating a non-map store should immediately end";
+
+	storeFree(value);
+	storeFree(store);
+}
+
+TEST(Map, freeze)
+{
+	Store *store = storeCreateMapValue();
+
+	int numEntries = 1000;
+	for(int i = 0; i < numEntries; i++) {
+		std::string key = "key" + std::to_string(i);
+		storeMapInsert(store, key.c_str(), storeCreateIntValue(i));
+	}
+
+	for(int i = 0; i < numEntries; i += 3) {
+		std::string key = "key" + std::to_string(i);
+		storeMapRemove(store, key.c_str());
+	}
+
+	Store *child = storeCreateMapValue();
+	storeMapInsert(child, "nested", storeCreateIntValue(-1));
+	storeMapInsert(store, "child", child);
+
+	storeFreeze(store);
+	ASSERT_TRUE(storeMapIsFrozen(store)) << "frozen map should be reported as frozen";
+	ASSERT_TRUE(storeMapIsFrozen(child)) << "freezing a map should freeze its descendants";
+	ASSERT_TRUE(store->content.mapValue->pilots != NULL) << "frozen map should have built a perfect hash";
+
+	for(int i = 0; i < numEntries; i++) {
+		std::string key = "key" + std::to_string(i);
+		Store *value = storeMapLookup(store, key.c_str());
+		if(i % 3 == 0) {
+			ASSERT_TRUE(value == NULL) << "looking up removed key " << key << " in a frozen map should return NULL";
+		} else {
+			ASSERT_TRUE(value != NULL) << "looking up key " << key << " in a frozen map should not return NULL";
+			ASSERT_EQ(value->content.intValue, i) << "looked up value for key " << key << " should be correct";
+		}
+	}
+	ASSERT_TRUE(storeMapLookup(store, "missing") == NULL) << "looking up a missing key in a frozen map should return NULL";
+	ASSERT_EQ(storeMapLookup(child, "nested")->content.intValue, -1) << "looking up a key in a frozen small map should succeed";
+
+	Store *rejected = storeCreateIntValue(0);
+	ASSERT_FALSE(storeMapInsert(store, "key1", rejected)) << "inserting into a frozen map should fail";
+	ASSERT_FALSE(storeMapInsert(store, "new", rejected)) << "inserting into a frozen map should fail";
+	ASSERT_FALSE(storeMapRemove(store, "key1")) << "removing from a frozen map should fail";
+	ASSERT_EQ(storeMapLookup(store, "key1")->content.intValue, 1) << "failed modifications should leave the frozen map unchanged";
+	storeFree(rejected);
+
+	int expected = 1;
+	StoreMapIterator iter;
+	storeMapIteratorInit(&iter, store);
+	const char *key;
+	Store *value;
+	while(storeMapIteratorNext(&iter, &key, &value) && value != child) {
+		ASSERT_EQ(value->content.intValue, expected) << "iterating the frozen map should visit entries in insertion order";
+		ASSERT_EQ(key, "key" + std::to_string(expected)) << "iterated key should match its value";
+		expected += expected % 3 == 1 ? 1 : 2;
+	}
+	ASSERT_EQ(expected, numEntries) << "iterating the frozen map should visit every entry once";
+
+	storeFree(store);
+}
+
+TEST(Map, freezeSharedHashes)
+{
+	// pairs of keys sharing their 32 bit FNV-1a hash
+	const char *keys[] = {"costarring", "liquid", "declinate", "macallums", "altarage", "zinke"};
+
+	Store *store = storeCreateMapValue();
+	for(int i = 0; i < 100; i++) {
+		std::string key = "filler" + std::to_string(i);
+		storeMapInsert(store, key.c_str(), storeCreateIntValue(-1));
+	}
+	for(int i = 0; i < 6; i++) {
+		ASSERT_EQ(storeHashString(keys[i]), storeHashString(keys[i - i % 2])) << "test keys should share their hash";
+		storeMapInsert(store, keys[i], storeCreateIntValue(i));
+	}
+
+	storeFreeze(store);
+	ASSERT_TRUE(store->content.mapValue->pilots != NULL) << "keys sharing their hash should not prevent a perfect hash";
+
+	for(int i = 0; i < 6; i++) {
+		Store *value = storeMapLookup(store, keys[i]);
+		ASSERT_TRUE(value != NULL) << "looking up key " << keys[i] << " in a frozen map should not return NULL";
+		ASSERT_EQ(value->content.intValue, i) << "looked up value for key " << keys[i] << " should be correct";
+	}
+	ASSERT_TRUE(storeMapLookup(store, "missing") == NULL) << "looking up a missing key in a frozen map should return NULL";
+
+	storeFree(store);
+}
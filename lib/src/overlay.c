@@ -0,0 +1,525 @@
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL
+#include <stdint.h> // uint64_t
+#include <stdlib.h> // free
+#include <string.h> // memcpy strdup strlen
+
+#include <glib.h>
+
+#include "store/map.h"
+#include "store/memory.h"
+#include "store/overlay.h"
+
+/**
+ * The maximum number of layers of an overlay, so that the layers merged into a map fit into a bit mask
+ */
+#define MAX_LAYERS 64
+
+typedef struct {
+	/** The index of the layer */
+	int layer;
+	/** The map the layer defines at some path */
+	Store *map;
+} LayerMap;
+
+typedef struct {
+	/** The key path of the merged map, in which each key is preceded by its length and a colon */
+	char *path;
+	/** The merged map, owned by its parent merged map or the overlay's root unless it is orphaned */
+	Store *map;
+	/** The bit mask of the layers whose maps at the path are merged */
+	uint64_t layers;
+	/** The maps of the merged layers at the path from the top down, owned by the layers */
+	LayerMap *layerMaps;
+	int numLayerMaps;
+	/** set of (char *) keys that several of the merged layers map to maps, whose merged values aren't built yet */
+	GHashTable *pending;
+	/** Whether all merged maps below this one are built */
+	bool flattened;
+	/** Whether the parent of the merged map was discarded, in which case it waits to be reattached by the rebuilt parent */
+	bool orphaned;
+} MergedNode;
+
+struct StoreOverlayStruct {
+	Store *layers[MAX_LAYERS];
+	int numLayers;
+	/** The merged view, which is either a merged map or a layer's root, or NULL if it needs to be rebuilt */
+	Store *root;
+	/** table of (char *) key paths to (MergedNode *) merged maps */
+	GHashTable *nodesByPath;
+	/** table of (Store *) merged maps to (MergedNode *) merged maps, to tell them apart from layer values */
+	GHashTable *nodesByMap;
+};
+
+static Store *getRoot(StoreOverlay *overlay);
+static MergedNode *createNode(StoreOverlay *overlay, char *path, LayerMap *layerMaps, int numLayerMaps);
+static Store *resolvePending(StoreOverlay *overlay, MergedNode *node, const char *key);
+static void flattenNode(StoreOverlay *overlay, MergedNode *node);
+static Store *collectLayerMaps(LayerMap *layerMaps, int numLayerMaps, const char *key, LayerMap *childMaps, int *numChildMaps);
+static uint64_t getLayerMask(LayerMap *layerMaps, int numLayerMaps);
+static char *appendKey(const char *path, const char *key);
+static void invalidateLayer(StoreOverlay *overlay, int layer);
+static void discardOrphan(StoreOverlay *overlay, MergedNode *node);
+static void forgetNode(StoreOverlay *overlay, MergedNode *node);
+static void freeNode(MergedNode *node);
+
+StoreOverlay *storeCreateOverlay()
+{
+	StoreOverlay *overlay = storeAllocateMemoryType(StoreOverlay);
+	overlay->numLayers = 0;
+	overlay->root = NULL;
+	overlay->nodesByPath = g_hash_table_new(g_str_hash, g_str_equal);
+	overlay->nodesByMap = g_hash_table_new(g_direct_hash, g_direct_equal);
+	return overlay;
+}
+
+void storeFreeOverlay(StoreOverlay *overlay)
+{
+	GHashTableIter iter;
+	void *nodePointer;
+	g_hash_table_iter_init(&iter, overlay->nodesByPath);
+	while(g_hash_table_iter_next(&iter, NULL, &nodePointer)) {
+		MergedNode *node = (MergedNode *) nodePointer;
+		if(node->orphaned) {
+			storeFree(node->map);
+		}
+
+		freeNode(node);
+	}
+
+	if(overlay->root != NULL) {
+		storeFree(overlay->root);
+	}
+
+	for(int i = 0; i < overlay->numLayers; i++) {
+		if(overlay->layers[i] != NULL) {
+			storeFree(overlay->layers[i]);
+		}
+	}
+
+	g_hash_table_destroy(overlay->nodesByPath);
+	g_hash_table_destroy(overlay->nodesByMap);
+	storeFreeMemory(overlay);
+}
+
+int storeOverlayPushLayer(StoreOverlay *overlay, Store *layer)
+{
+	if(overlay->numLayers == MAX_LAYERS) {
+		return -1;
+	}
+
+	int index = overlay->numLayers++;
+	overlay->layers[index] = layer;
+	invalidateLayer(overlay, index);
+	return index;
+}
+
+bool storeOverlaySetLayer(StoreOverlay *overlay, int index, Store *layer)
+{
+	if(index < 0 || index >= overlay->numLayers) {
+		return false;
+	}
+
+	invalidateLayer(overlay, index);
+
+	if(overlay->layers[index] != NULL) {
+		storeFree(overlay->layers[index]);
+	}
+
+	overlay->layers[index] = layer;
+	return true;
+}
+
+Store *storeOverlayGetLayer(StoreOverlay *overlay, int index)
+{
+	if(index < 0 || index >= overlay->numLayers) {
+		return NULL;
+	}
+
+	return overlay->layers[index];
+}
+
+int storeOverlayGetNumLayers(StoreOverlay *overlay)
+{
+	return overlay->numLayers;
+}
+
+Store *storeOverlayGetPath(StoreOverlay *overlay, StorePath *path)
+{
+	Store *store = getRoot(overlay);
+	if(store == NULL) {
+		return NULL;
+	}
+
+	if(storePathHasWildcard(path)) {
+		MergedNode *root = (MergedNode *) g_hash_table_lookup(overlay->nodesByMap, store);
+		if(root != NULL) {
+			flattenNode(overlay, root);
+		}
+
+		return storeGetPath(store, path);
+	}
+
+	int numSegments = storePathGetNumSegments(path);
+	for(int i = 0; i < numSegments; i++) {
+		MergedNode *node = (MergedNode *) g_hash_table_lookup(overlay->nodesByMap, store);
+		if(node == NULL) {
+			// below the merged maps, the value is taken from a single layer
+			return storeGetPathFrom(store, path, i);
+		}
+
+		StoreKey *key = storePathGetKey(path, i);
+		if(key == NULL) {
+			return NULL;
+		}
+
+		Store *child = storeMapGet(node->map, key);
+		if(child == NULL) {
+			child = resolvePending(overlay, node, key->string);
+		}
+
+		if(child == NULL) {
+			return NULL;
+		}
+
+		store = child;
+	}
+
+	MergedNode *node = (MergedNode *) g_hash_table_lookup(overlay->nodesByMap, store);
+	if(node != NULL) {
+		flattenNode(overlay, node);
+	}
+
+	return store;
+}
+
+/**
+ * Returns the merged view of an overlay, building the root merged map if needed
+ *
+ * @param overlay		the overlay to query
+ * @result				the merged view, or NULL if no layer defines a store
+ */
+static Store *getRoot(StoreOverlay *overlay)
+{
+	if(overlay->root != NULL) {
+		return overlay->root;
+	}
+
+	LayerMap layerMaps[MAX_LAYERS];
+	int numLayerMaps = 0;
+	for(int i = overlay->numLayers - 1; i >= 0; i--) {
+		Store *layer = overlay->layers[i];
+		if(layer == NULL) {
+			continue;
+		}
+
+		if(layer->type != STORE_MAP) {
+			if(numLayerMaps == 0) {
+				overlay->root = storeRetain(layer);
+				return overlay->root;
+			}
+
+			break;
+		}
+
+		layerMaps[numLayerMaps].layer = i;
+		layerMaps[numLayerMaps].map = layer;
+		numLayerMaps++;
+	}
+
+	if(numLayerMaps == 0) {
+		return NULL;
+	} else if(numLayerMaps == 1) {
+		overlay->root = storeRetain(layerMaps[0].map);
+	} else {
+		overlay->root = createNode(overlay, strdup(""), layerMaps, numLayerMaps)->map;
+	}
+
+	return overlay->root;
+}
+
+/**
+ * Creates a merged map from the maps of several layers. Entries defined by a single layer share the layer's value,
+ * while entries that need to be merged themselves are reattached from an orphaned merged map of the same layers or
+ * left pending until they are looked up.
+ *
+ * @param overlay		the overlay to create the merged map for
+ * @param path			the key path of the merged map, ownership is transferred to the merged map
+ * @param layerMaps		the maps of the layers to merge from the top down
+ * @param numLayerMaps	the number of maps to merge, at least two
+ * @result				the created merged map, owned by the overlay
+ */
+static MergedNode *createNode(StoreOverlay *overlay, char *path, LayerMap *layerMaps, int numLayerMaps)
+{
+	MergedNode *previous = (MergedNode *) g_hash_table_lookup(overlay->nodesByPath, path);
+	if(previous != NULL && previous->orphaned) {
+		discardOrphan(overlay, previous);
+	}
+
+	MergedNode *node = storeAllocateMemoryType(MergedNode);
+	node->path = path;
+	node->map = storeCreateMapValue();
+	node->layers = getLayerMask(layerMaps, numLayerMaps);
+	node->layerMaps = (LayerMap *) storeAllocateMemory(numLayerMaps * sizeof(LayerMap));
+	memcpy(node->layerMaps, layerMaps, numLayerMaps * sizeof(LayerMap));
+	node->numLayerMaps = numLayerMaps;
+	node->pending = g_hash_table_new_full(g_str_hash, g_str_equal, free, NULL);
+	node->flattened = false;
+	node->orphaned = false;
+
+	for(int i = 0; i < numLayerMaps; i++) {
+		StoreMapIterator iter;
+		storeMapIteratorInit(&iter, layerMaps[i].map);
+		const char *key;
+		Store *value;
+		while(storeMapIteratorNext(&iter, &key, &value)) {
+			if(storeMapLookup(node->map, key) != NULL || g_hash_table_contains(node->pending, key)) {
+				continue; // a higher layer already defined the key
+			}
+
+			LayerMap childMaps[MAX_LAYERS];
+			int numChildMaps;
+			collectLayerMaps(layerMaps + i, numLayerMaps - i, key, childMaps, &numChildMaps);
+			if(numChildMaps < 2) {
+				storeMapInsert(node->map, key, storeRetain(value));
+				continue;
+			}
+
+			char *childPath = appendKey(path, key);
+			MergedNode *child = (MergedNode *) g_hash_table_lookup(overlay->nodesByPath, childPath);
+			free(childPath);
+
+			if(child != NULL && child->orphaned && child->layers == getLayerMask(childMaps, numChildMaps)) {
+				// none of the layers merged into the orphan changed, so it is still valid
+				storeMapInsert(node->map, key, child->map);
+				child->orphaned = false;
+			} else {
+				if(child != NULL && child->orphaned) {
+					discardOrphan(overlay, child);
+				}
+
+				char *pendingKey = strdup(key);
+				g_hash_table_add(node->pending, pendingKey);
+			}
+		}
+	}
+
+	g_hash_table_insert(overlay->nodesByPath, node->path, node);
+	g_hash_table_insert(overlay->nodesByMap, node->map, node);
+	return node;
+}
+
+/**
+ * Builds the merged value of a pending key of a merged map
+ *
+ * @param overlay		the overlay of the merged map
+ * @param node			the merged map to build the value in
+ * @param key			the key to build the value for
+ * @result				the merged value, or NULL if the key isn't pending
+ */
+static Store *resolvePending(StoreOverlay *overlay, MergedNode *node, const char *key)
+{
+	if(!g_hash_table_contains(node->pending, key)) {
+		return NULL;
+	}
+
+	LayerMap childMaps[MAX_LAYERS];
+	int numChildMaps;
+	collectLayerMaps(node->layerMaps, node->numLayerMaps, key, childMaps, &numChildMaps);
+	MergedNode *child = createNode(overlay, appendKey(node->path, key), childMaps, numChildMaps);
+
+	storeMapInsert(node->map, key, child->map);
+	g_hash_table_remove(node->pending, key);
+	return child->map;
+}
+
+/**
+ * Builds all pending merged maps below a merged map
+ *
+ * @param overlay		the overlay of the merged map
+ * @param node			the merged map to flatten
+ */
+static void flattenNode(StoreOverlay *overlay, MergedNode *node)
+{
+	if(node->flattened) {
+		return;
+	}
+
+	GList *keys = g_hash_table_get_keys(node->pending);
+	for(GList *iter = keys; iter != NULL; iter = iter->next) {
+		// copy the key since resolving it frees the pending one
+		char *key = strdup((const char *) iter->data);
+		resolvePending(overlay, node, key);
+		free(key);
+	}
+	g_list_free(keys);
+
+	StoreMapIterator iter;
+	storeMapIteratorInit(&iter, node->map);
+	Store *value;
+	while(storeMapIteratorNext(&iter, NULL, &value)) {
+		MergedNode *child = (MergedNode *) g_hash_table_lookup(overlay->nodesByMap, value);
+		if(child != NULL) {
+			flattenNode(overlay, child);
+		}
+	}
+
+	node->flattened = true;
+}
+
+/**
+ * Collects the maps to merge for the value of a key, which are the layers' maps for the key from the top down until a
+ * layer maps the key to something other than a map
+ *
+ * @param layerMaps		the maps of the layers containing the key from the top down
+ * @param numLayerMaps	the number of layer maps
+ * @param key			the key to collect the maps for
+ * @param childMaps		the array of at least numLayerMaps elements to fill with the maps for the key
+ * @param numChildMaps	pointer to be set to the number of collected maps
+ * @result				the value of the key in the topmost layer defining it, or NULL if no layer defines it
+ */
+static Store *collectLayerMaps(LayerMap *layerMaps, int numLayerMaps, const char *key, LayerMap *childMaps, int *numChildMaps)
+{
+	Store *top = NULL;
+	*numChildMaps = 0;
+
+	for(int i = 0; i < numLayerMaps; i++) {
+		Store *value = storeMapLookup(layerMaps[i].map, key);
+		if(value == NULL) {
+			continue;
+		}
+
+		if(top == NULL) {
+			top = value;
+		}
+
+		if(value->type != STORE_MAP) {
+			break;
+		}
+
+		childMaps[*numChildMaps].layer = layerMaps[i].layer;
+		childMaps[*numChildMaps].map = value;
+		(*numChildMaps)++;
+	}
+
+	return top;
+}
+
+static uint64_t getLayerMask(LayerMap *layerMaps, int numLayerMaps)
+{
+	uint64_t mask = 0;
+	for(int i = 0; i < numLayerMaps; i++) {
+		mask |= (uint64_t) 1 << layerMaps[i].layer;
+	}
+
+	return mask;
+}
+
+/**
+ * Appends a key to a key path, preceding it by its length so that keys containing any characters can't collide
+ *
+ * @result				the extended key path, must be freed with free
+ */
+static char *appendKey(const char *path, const char *key)
+{
+	GString *string = g_string_new(path);
+	g_string_append_printf(string, "%d:%s", (int) strlen(key), key);
+	return g_string_free(string, false);
+}
+
+/**
+ * Discards the merged view and the merged maps a changed layer contributed to. Since a layer contributing to a merged
+ * map also contributes to all its ancestors, the discarded merged maps form a subtree below the root. The merged maps
+ * below them that remain valid are orphaned and kept, so that rebuilding their parents reattaches them.
+ *
+ * @param overlay		the overlay to invalidate
+ * @param layer			the index of the changed layer
+ */
+static void invalidateLayer(StoreOverlay *overlay, int layer)
+{
+	uint64_t mask = (uint64_t) 1 << layer;
+	GList *discarded = NULL;
+
+	GHashTableIter iter;
+	void *nodePointer;
+	g_hash_table_iter_init(&iter, overlay->nodesByPath);
+	while(g_hash_table_iter_next(&iter, NULL, &nodePointer)) {
+		MergedNode *node = (MergedNode *) nodePointer;
+		// the root is always rebuilt since the changed layer may contribute to it now
+		if((node->layers & mask) != 0 || node->map == overlay->root) {
+			discarded = g_list_prepend(discarded, node);
+		}
+	}
+
+	for(GList *nodeIter = discarded; nodeIter != NULL; nodeIter = nodeIter->next) {
+		MergedNode *node = (MergedNode *) nodeIter->data;
+
+		StoreMapIterator mapIter;
+		storeMapIteratorInit(&mapIter, node->map);
+		Store *value;
+		while(storeMapIteratorNext(&mapIter, NULL, &value)) {
+			MergedNode *child = (MergedNode *) g_hash_table_lookup(overlay->nodesByMap, value);
+			if(child != NULL && (child->layers & mask) == 0) {
+				// keep the child alive when its parent is freed
+				storeRetain(child->map);
+				child->orphaned = true;
+			}
+		}
+	}
+
+	for(GList *nodeIter = discarded; nodeIter != NULL; nodeIter = nodeIter->next) {
+		MergedNode *node = (MergedNode *) nodeIter->data;
+		// discarded merged maps are freed through the root unless they were orphaned before
+		if(node->orphaned) {
+			storeFree(node->map);
+		}
+
+		g_hash_table_remove(overlay->nodesByPath, node->path);
+		g_hash_table_remove(overlay->nodesByMap, node->map);
+		freeNode(node);
+	}
+	g_list_free(discarded);
+
+	if(overlay->root != NULL) {
+		storeFree(overlay->root);
+		overlay->root = NULL;
+	}
+}
+
+/**
+ * Frees an orphaned merged map that can't be reattached, together with the merged maps below it
+ */
+static void discardOrphan(StoreOverlay *overlay, MergedNode *node)
+{
+	Store *map = node->map;
+	forgetNode(overlay, node);
+	storeFree(map);
+}
+
+/**
+ * Removes a merged map and the merged maps below it from an overlay's tables without freeing the maps
+ */
+static void forgetNode(StoreOverlay *overlay, MergedNode *node)
+{
+	StoreMapIterator iter;
+	storeMapIteratorInit(&iter, node->map);
+	Store *value;
+	while(storeMapIteratorNext(&iter, NULL, &value)) {
+		MergedNode *child = (MergedNode *) g_hash_table_lookup(overlay->nodesByMap, value);
+		if(child != NULL) {
+			forgetNode(overlay, child);
+		}
+	}
+
+	g_hash_table_remove(overlay->nodesByPath, node->path);
+	g_hash_table_remove(overlay->nodesByMap, node->map);
+	freeNode(node);
+}
+
+static void freeNode(MergedNode *node)
+{
+	g_hash_table_destroy(node->pending);
+	storeFreeMemory(node->layerMaps);
+	free(node->path);
+	storeFreeMemory(node);
+}
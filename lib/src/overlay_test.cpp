@@ -0,0 +1,139 @@
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/list.h>
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "overlay.c"
+
+class Overlay: public ::testing::Test {
+public:
+	virtual void SetUp() {
+		parser = storeCreateParser();
+		overlay = storeCreateOverlay();
+	}
+
+	virtual void TearDown() {
+		storeFreeOverlay(overlay);
+		storeFreeParser(parser);
+	}
+
+protected:
+	Store *parse(const char *input) {
+		Store *store = storeParse(parser, input);
+		EXPECT_TRUE(store != NULL) << "layer '" << input << "' should parse successfully";
+		return store;
+	}
+
+	Store *getPath(const char *pathString) {
+		StorePath *path = storeCompilePath(pathString);
+		EXPECT_TRUE(path != NULL) << "path '" << pathString << "' should compile";
+		if(path == NULL) {
+			return NULL;
+		}
+
+		Store *result = storeOverlayGetPath(overlay, path);
+		storeFreePath(path);
+		return result;
+	}
+
+	int getInt(const char *pathString) {
+		Store *result = getPath(pathString);
+		EXPECT_TRUE(result != NULL && result->type == STORE_INT) << "path '" << pathString << "' should select an int";
+		return result != NULL && result->type == STORE_INT ? result->content.intValue : -1;
+	}
+
+	StoreParser *parser;
+	StoreOverlay *overlay;
+};
+
+TEST_F(Overlay, merge)
+{
+	ASSERT_TRUE(getPath("") == NULL) << "an overlay without layers should be empty";
+
+	ASSERT_EQ(storeOverlayPushLayer(overlay, parse("server = {port = 80, tls = {cert = base, key = base}}; workers = 4; tags = [a b]")), 0) << "base layer should be added at the bottom";
+	ASSERT_EQ(storeOverlayPushLayer(overlay, NULL), 1) << "empty layer should be added";
+	ASSERT_EQ(storeOverlayPushLayer(overlay, parse("server = {port = 8080, tls = {cert = env}}; tags = [c]")), 2) << "environment layer should be added";
+	ASSERT_EQ(storeOverlayPushLayer(overlay, parse("server = {tls = {key = host}}; workers = {count = 8}")), 3) << "host layer should be added on top";
+	ASSERT_EQ(storeOverlayGetNumLayers(overlay), 4) << "overlay should have four layers";
+
+	ASSERT_EQ(getInt("server.port"), 8080) << "higher layer should override a value of a lower one";
+	ASSERT_STREQ(getPath("server.tls.cert")->content.stringValue, "env") << "nested value should be merged from the environment layer";
+	ASSERT_STREQ(getPath("server.tls.key")->content.stringValue, "host") << "nested value should be merged from the host layer";
+	ASSERT_EQ(getInt("workers.count"), 8) << "map of a higher layer should replace a non-map value";
+	ASSERT_EQ(storeListGetLength(getPath("tags")), 1) << "list of a higher layer should replace a list rather than being merged";
+	ASSERT_TRUE(getPath("tags[0]") != NULL) << "path should continue into values taken from a single layer";
+	ASSERT_TRUE(getPath("server.missing") == NULL) << "missing key should not be found";
+	ASSERT_TRUE(getPath("server[0]") == NULL) << "index into a merged map should not be found";
+
+	Store *tls = getPath("server.tls");
+	ASSERT_EQ(getPath("server.tls"), tls) << "merged map should be memoized";
+	ASSERT_EQ(storeMapGetSize(tls), 2) << "flattened merged map should contain the keys of all layers";
+
+	Store *root = getPath("");
+	ASSERT_EQ(storeMapGetSize(root), 3) << "merged view should contain the keys of all layers";
+	ASSERT_EQ(storeMapGetSize(storeMapLookup(root, "server")), 2) << "merged view should be flattened completely";
+	ASSERT_EQ(getInt("*.port"), 8080) << "wildcard path should match in the flattened view";
+}
+
+TEST_F(Overlay, invalidate)
+{
+	storeOverlayPushLayer(overlay, parse("a = {x = {v = 1}}; b = {y = {v = 1}}"));
+	storeOverlayPushLayer(overlay, parse("a = {x = {w = 2}}; b = {y = {w = 2}}"));
+	storeOverlayPushLayer(overlay, parse("a = {x = {v = 3}}"));
+
+	ASSERT_EQ(getInt("a.x.v"), 3) << "top layer should override the base layer";
+	Store *a = getPath("a");
+	Store *b = getPath("b");
+	ASSERT_EQ(getInt("b.y.w"), 2) << "middle layer should be merged";
+
+	ASSERT_TRUE(storeOverlaySetLayer(overlay, 2, parse("a = {x = {v = 4}}"))) << "top layer should be replaced";
+	ASSERT_EQ(getInt("a.x.v"), 4) << "lookup should reflect the replaced layer";
+	ASSERT_EQ(getPath("b"), b) << "merged map the replaced layer didn't contribute to should be kept";
+	ASSERT_EQ(getInt("b.y.v"), 1) << "kept merged map should still be valid";
+	(void) a;
+
+	ASSERT_TRUE(storeOverlaySetLayer(overlay, 2, parse("b = {y = {v = 5}}"))) << "top layer should be replaced again";
+	ASSERT_EQ(getInt("b.y.v"), 5) << "layer newly contributing to a kept merged map should invalidate it";
+	ASSERT_EQ(getInt("a.x.v"), 1) << "layer no longer contributing should be invalidated";
+	ASSERT_EQ(getInt("a.x.w"), 2) << "remaining layers should still be merged";
+
+	ASSERT_TRUE(storeOverlaySetLayer(overlay, 0, parse("42"))) << "base layer should be replaced";
+	ASSERT_TRUE(getPath("a.x.v") == NULL) << "non-map base layer should not contribute to the merged maps";
+	ASSERT_EQ(getInt("b.y.w"), 2) << "maps of the other layers should still be merged";
+
+	ASSERT_TRUE(storeOverlaySetLayer(overlay, 1, NULL)) << "middle layer should be cleared";
+	ASSERT_TRUE(storeOverlaySetLayer(overlay, 2, parse("[1 2 3]"))) << "top layer should be replaced by a list";
+	ASSERT_EQ(storeListGetLength(getPath("")), 3) << "non-map top layer should replace everything below it";
+	ASSERT_EQ(getInt("[1]"), 2) << "path should select from the top layer";
+
+	ASSERT_FALSE(storeOverlaySetLayer(overlay, 3, NULL)) << "missing layer should not be replaced";
+	Store *unused = parse("{}");
+	ASSERT_FALSE(storeOverlaySetLayer(overlay, -1, unused)) << "negative layer should not be replaced";
+	storeFree(unused);
+}
+
+TEST_F(Overlay, orphans)
+{
+	storeOverlayPushLayer(overlay, parse("a = {b = {c = {v = 1}}}; d = {e = {v = 1}}"));
+	storeOverlayPushLayer(overlay, parse("a = {b = {c = {w = 2}}}; d = {e = {w = 2}}"));
+	storeOverlayPushLayer(overlay, parse("a = {x = 3}"));
+
+	Store *c = getPath("a.b.c");
+	ASSERT_EQ(getInt("a.b.c.w"), 2) << "deeply merged value should be found";
+
+	// the top layer contributes to a, but not to a.b
+	ASSERT_TRUE(storeOverlaySetLayer(overlay, 2, parse("a = {x = 4}"))) << "top layer should be replaced";
+	ASSERT_EQ(getInt("a.x"), 4) << "lookup should reflect the replaced layer";
+	ASSERT_EQ(getPath("a.b.c"), c) << "orphaned merged map should be reattached";
+
+	// replacing a layer again before the orphan's parent is rebuilt keeps the orphan waiting
+	getPath("d.e");
+	ASSERT_TRUE(storeOverlaySetLayer(overlay, 2, parse("a = {b = 5}"))) << "top layer should be replaced";
+	ASSERT_TRUE(storeOverlaySetLayer(overlay, 2, parse("a = {x = 6}"))) << "top layer should be replaced";
+	ASSERT_EQ(getInt("a.b.c.v"), 1) << "merged map should be rebuilt after being hidden";
+	ASSERT_EQ(getInt("d.e.v"), 1) << "merged map should survive repeated invalidations";
+}
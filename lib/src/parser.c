@@ -1,21 +1,29 @@
-#include <ctype.h> // isspace isdigit
 #include <stdarg.h> // va_list va_start
 #include <stdbool.h> // bool true false
-#include <stddef.h> // NULL
-#include <stdlib.h> // atoi atof
-#include <string.h> // strdup
+#include <stddef.h> // NULL size_t
+#include <stdint.h> // SIZE_MAX uint32_t
+#include <stdlib.h> // atoi atof free
+#include <string.h> // strchr strdup strpbrk
 
+#include "store/dedup.h"
 #include "store/encoding.h"
+#include "store/list.h"
+#include "store/map.h"
 #include "store/memory.h"
 #include "store/parser.h"
+#include "store/syntax.h"
 
 typedef struct {
 	char *key;
 	Store *value;
 } Entry;
 
-static const int maxDepth = 1000;
-
+static void postprocessStore(StoreParser *parser, Store *store);
+static Store *findEnclosingContainer(StoreSpanTable *spans, Store *store, const char *input, int editStart, int editEnd);
+static Store *selectContainingChild(StoreSpanTable *spans, Store *child, int editStart, int editEnd);
+static bool reparseContainer(StoreParser *parser, Store *container, const char *input, int editStart, int removedLength, int insertedLength);
+static void adoptSpans(StoreSpanTable *spans, StoreSpanTable *source, Store *store, int offset);
+static void forgetSpans(StoreSpanTable *spans, Store *store);
 static Store *parseStore(const char *input, StoreParseState *state);
 static Store *parseValue(const char *input, StoreParseState *state);
 static Store *parseString(const char *input, StoreParseState *state);
@@ -26,9 +34,6 @@ static Store *parseElements(const char *input, StoreParseState *state);
 static Store *parseMap(const char *input, StoreParseState *state);
 static Store *parseEntries(const char *input, StoreParseState *state);
 static Entry *parseEntry(const char *input, StoreParseState *state);
-static GString *parseDigits(const char *input, StoreParseState *state);
-static GString *parseFloating(const char *input, StoreParseState *state);
-static GString *parseExponential(const char *input, StoreParseState *state);
 static GString *parseShortString(const char *input, StoreParseState *state);
 static GString *parseLongString(const char *input, StoreParseState *state);
 static GString *parseLongStringChunk(const char *input, StoreParseState *state);
@@ -36,13 +41,12 @@ static char parseTerminal(const char *input, StoreParseState *state);
 static char parseHex(const char *input, StoreParseState *state);
 static char parseDigit(const char *input, StoreParseState *state);
 static char parseDelimiter(const char *input, StoreParseState *state);
-static StoreParseState *createParseState(StoreParseStatePosition position, int depth);
+static StoreParseState *createParseState(StoreParseStatePosition position, int depth, StoreSpanTable *spans);
 static void freeParseState(StoreParseState *state);
+static void recordSpan(StoreParseState *state, Store *store, int start, int end);
 static void reportAndFreeState(bool success, StoreParseState *parentState, StoreParseState *state, const char *type, const char *message, ...);
 static void freeParseReportPointer(void *parseReportPointer);
 static void freeParseReport(StoreParseReport *lastReport);
-static bool isHex(char c);
-static bool isSeparator(char c);
 
 StoreParser *storeCreateParser()
 {
@@ -52,6 +56,9 @@ StoreParser *storeCreateParser()
 	parser->state.position.column = 1;
 	parser->state.depth = 0;
 	parser->state.reports = g_queue_new();
+	parser->state.spans = NULL;
+	parser->flags = 0;
+	parser->spans = NULL;
 	return parser;
 }
 
@@ -63,18 +70,256 @@ void storeResetParser(StoreParser *parser)
 	parser->state.depth = 0;
 	g_queue_free_full(parser->state.reports, freeParseReportPointer);
 	parser->state.reports = g_queue_new();
+	parser->state.spans = NULL;
 }
 
 void storeFreeParser(StoreParser *parser)
 {
+	if(parser->spans != NULL) {
+		storeFreeSpanTable(parser->spans);
+	}
+
 	g_queue_free_full(parser->state.reports, freeParseReportPointer);
 	storeFreeMemory(parser);
 }
 
+void storeSetParserFlags(StoreParser *parser, int flags)
+{
+	parser->flags = flags;
+}
+
 Store *storeParse(StoreParser *parser, const char *input)
 {
 	storeResetParser(parser);
-	return parseStore(input, &parser->state);
+
+	if(parser->spans != NULL) {
+		storeFreeSpanTable(parser->spans);
+		parser->spans = NULL;
+	}
+
+	StoreSpanTable *spans = (parser->flags & STORE_PARSE_SPANS) ? storeCreateSpanTable() : NULL;
+	parser->state.spans = spans;
+	Store *store = parseStore(input, &parser->state);
+	parser->state.spans = NULL;
+
+	if(store != NULL) {
+		postprocessStore(parser, store);
+	}
+
+	if(spans != NULL) {
+		// only keep the spans of stores that made it into the result, not of those discarded while backtracking
+		if(store != NULL) {
+			parser->spans = storeCreateSpanTable();
+			adoptSpans(parser->spans, spans, store, 0);
+		}
+
+		storeFreeSpanTable(spans);
+	}
+
+	return store;
+}
+
+Store *storeReparse(StoreParser *parser, Store *store, const char *input, int editStart, int removedLength, int insertedLength)
+{
+	if(parser->spans != NULL) {
+		Store *container = findEnclosingContainer(parser->spans, store, input, editStart, editStart + removedLength);
+		if(container != NULL && reparseContainer(parser, container, input, editStart, removedLength, insertedLength)) {
+			return store;
+		}
+	}
+
+	Store *reparsed = storeParse(parser, input);
+	if(reparsed != NULL) {
+		storeFree(store);
+	}
+
+	return reparsed;
+}
+
+/**
+ * Applies the post-processing requested by a parser's flags to a parsed store
+ */
+static void postprocessStore(StoreParser *parser, Store *store)
+{
+	if(parser->flags & STORE_PARSE_PACK_LISTS) {
+		storePackLists(store);
+	}
+
+	if(parser->flags & STORE_PARSE_DEDUPLICATE) {
+		storeDeduplicate(store);
+	}
+}
+
+/**
+ * Finds the innermost list or map of a store whose brackets enclose an edit
+ *
+ * @param spans			the spans of the store's descendants
+ * @param store			the store to search
+ * @param input			the edited input
+ * @param editStart		the byte offset at which the edit starts
+ * @param editEnd		the byte offset in the previous input at which the edit ends
+ * @result				the enclosing list or map, or NULL if there is none that can be modified in place
+ */
+static Store *findEnclosingContainer(StoreSpanTable *spans, Store *store, const char *input, int editStart, int editEnd)
+{
+	Store *container = NULL;
+	Store *current = store;
+	while(current != NULL) {
+		StoreSpan span;
+		if(!storeSpanTableLookup(spans, current, &span) || span.start >= editStart || span.end <= editEnd) {
+			break;
+		}
+
+		// modifying a descendant of a frozen store would invalidate the hashes cached in it
+		if(storeMapIsFrozen(current) || storeListIsFrozen(current)) {
+			return NULL;
+		}
+
+		// shared stores must not be modified, but their parent can be re-parsed as a whole
+		if(current->references > 1 || storeListHasIndexes(current)) {
+			break;
+		}
+
+		// the top level entries of a store aren't enclosed by brackets, so they can't be re-parsed on their own
+		char c = input[span.start];
+		if(c == '{' || c == '[' || c == '(') {
+			container = current;
+		}
+
+		Store *next = NULL;
+		if(current->type == STORE_LIST) {
+			for(GList *iter = current->content.listValue->head; iter != NULL && next == NULL; iter = iter->next) {
+				next = selectContainingChild(spans, (Store *) iter->data, editStart, editEnd);
+			}
+		} else if(current->type == STORE_MAP) {
+			StoreMapIterator iterator;
+			Store *value;
+			storeMapIteratorInit(&iterator, current);
+			while(next == NULL && storeMapIteratorNext(&iterator, NULL, &value)) {
+				next = selectContainingChild(spans, value, editStart, editEnd);
+			}
+		}
+
+		current = next;
+	}
+
+	return container;
+}
+
+/**
+ * Returns a child if it is a list or map whose span contains an edit, or NULL otherwise
+ */
+static Store *selectContainingChild(StoreSpanTable *spans, Store *child, int editStart, int editEnd)
+{
+	if(child->type == STORE_STRING || child->type == STORE_INT || child->type == STORE_FLOAT || child->type == STORE_TABLE) {
+		return NULL;
+	}
+
+	StoreSpan span;
+	if(!storeSpanTableLookup(spans, child, &span) || span.start >= editStart || span.end <= editEnd) {
+		return NULL;
+	}
+
+	return child;
+}
+
+/**
+ * Re-parses the edited text of a list or map and replaces its content with the result
+ *
+ * @param parser			the parser holding the spans of the stores of the previous input
+ * @param container			the list or map enclosing the edit
+ * @param input				the edited input
+ * @param editStart			the byte offset at which the edit starts
+ * @param removedLength		the number of bytes the edit removed from the previous input
+ * @param insertedLength	the number of bytes the edit inserted in their place
+ * @result					true if the container was replaced, false if its edited text isn't a single list or map
+ */
+static bool reparseContainer(StoreParser *parser, Store *container, const char *input, int editStart, int removedLength, int insertedLength)
+{
+	StoreSpan span;
+	storeSpanTableLookup(parser->spans, container, &span);
+	int delta = insertedLength - removedLength;
+	GString *text = g_string_new_len(input + span.start, span.end + delta - span.start);
+
+	StoreSpanTable *spans = storeCreateSpanTable();
+	storeResetParser(parser);
+	parser->state.spans = spans;
+	Store *replacement = parseStore(text->str, &parser->state);
+	parser->state.spans = NULL;
+	g_string_free(text, true);
+
+	if(replacement == NULL || (replacement->type != STORE_LIST && replacement->type != STORE_MAP)) {
+		if(replacement != NULL) {
+			storeFree(replacement);
+		}
+
+		storeFreeSpanTable(spans);
+		return false;
+	}
+
+	postprocessStore(parser, replacement);
+
+	forgetSpans(parser->spans, container);
+
+	// shift the spans following the edit, including the end of every enclosing store
+	storeSpanTableShift(parser->spans, editStart, delta);
+
+	adoptSpans(parser->spans, spans, replacement, span.start);
+	storeSpanTableRemove(parser->spans, replacement);
+	storeFreeSpanTable(spans);
+
+	storeReplaceContent(container, replacement);
+	return true;
+}
+
+/**
+ * Copies the spans of a store and its descendants from one span table into another
+ *
+ * @param spans			the table to copy the spans into
+ * @param source		the table to copy the spans from
+ * @param store			the store whose spans to copy
+ * @param offset		the offset to add to the copied spans
+ */
+static void adoptSpans(StoreSpanTable *spans, StoreSpanTable *source, Store *store, int offset)
+{
+	StoreSpan span;
+	if(storeSpanTableLookup(source, store, &span)) {
+		storeSpanTableSet(spans, store, span.start + offset, span.end + offset);
+	}
+
+	if(store->type == STORE_LIST) {
+		for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+			adoptSpans(spans, source, (Store *) iter->data, offset);
+		}
+	} else if(store->type == STORE_MAP) {
+		StoreMapIterator iterator;
+		Store *value;
+		storeMapIteratorInit(&iterator, store);
+		while(storeMapIteratorNext(&iterator, NULL, &value)) {
+			adoptSpans(spans, source, value, offset);
+		}
+	}
+}
+
+/**
+ * Removes the spans of the descendants of a store from a span table
+ */
+static void forgetSpans(StoreSpanTable *spans, Store *store)
+{
+	if(store->type == STORE_LIST) {
+		for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+			storeSpanTableRemove(spans, (Store *) iter->data);
+			forgetSpans(spans, (Store *) iter->data);
+		}
+	} else if(store->type == STORE_MAP) {
+		StoreMapIterator iterator;
+		Store *value;
+		storeMapIteratorInit(&iterator, store);
+		while(storeMapIteratorNext(&iterator, NULL, &value)) {
+			storeSpanTableRemove(spans, value);
+			forgetSpans(spans, value);
+		}
+	}
 }
 
 /**
@@ -83,7 +328,7 @@ Store *storeParse(StoreParser *parser, const char *input)
  */
 static Store *parseStore(const char *input, StoreParseState *state)
 {
-	StoreParseState *storeState = createParseState(state->position, state->depth + 1);
+	StoreParseState *storeState = createParseState(state->position, state->depth + 1, state->spans);
 
 	Store *valueStore = parseValue(input, storeState);
 	if(valueStore != NULL) {
@@ -97,7 +342,7 @@ static Store *parseStore(const char *input, StoreParseState *state)
 			}
 		}
 
-		StoreParseState *valueState = createParseState(storeState->position, state->depth + 1);
+		StoreParseState *valueState = createParseState(storeState->position, state->depth + 1, state->spans);
 		reportAndFreeState(false, storeState, valueState, "value", "expected termination by end of input, but got '%c'", c);
 		storeFree(valueStore);
 	}
@@ -109,13 +354,14 @@ static Store *parseStore(const char *input, StoreParseState *state)
 		if(c == '\0') {
 			// make sure it's and actual EOF, not just a parseTerminal failure
 			if(input[storeState->position.index] == '\0') {
+				recordSpan(state, entriesStore, state->position.index, storeState->position.index);
 				state->position = storeState->position;
 				reportAndFreeState(true, state, storeState, "store", "parsed entries store");
 				return entriesStore;
 			}
 		}
 
-		StoreParseState *entriesState = createParseState(storeState->position, state->depth + 1);
+		StoreParseState *entriesState = createParseState(storeState->position, state->depth + 1, state->spans);
 		reportAndFreeState(false, storeState, entriesState, "entries", "expected termination by end of input, but got '%c'", c);
 		storeFree(entriesStore);
 	}
@@ -133,7 +379,7 @@ static Store *parseStore(const char *input, StoreParseState *state)
  */
 static Store *parseValue(const char *input, StoreParseState *state)
 {
-	StoreParseState *valueState = createParseState(state->position, state->depth + 1);
+	StoreParseState *valueState = createParseState(state->position, state->depth + 1, state->spans);
 
 	char c = parseTerminal(input, valueState);
 	if(c == '\0') {
@@ -146,12 +392,13 @@ static Store *parseValue(const char *input, StoreParseState *state)
 	Store *intStore = parseInt(input, valueState);
 	if(intStore != NULL) {
 		char c = input[valueState->position.index];
-		if(isSeparator(c)) {
+		if(storeIsSeparatorCharacter(c)) {
+			recordSpan(state, intStore, terminalPosition.index, valueState->position.index);
 			state->position = valueState->position;
 			reportAndFreeState(true, state, valueState, "value", "parsed int");
 			return intStore;
 		} else {
-			StoreParseState *intState = createParseState(valueState->position, state->depth + 1);
+			StoreParseState *intState = createParseState(valueState->position, state->depth + 1, state->spans);
 			reportAndFreeState(false, valueState, intState, "int", "expected termination by separator but got '%c'", c);
 			storeFree(intStore);
 		}
@@ -161,12 +408,13 @@ static Store *parseValue(const char *input, StoreParseState *state)
 	Store *floatStore = parseFloat(input, valueState);
 	if(floatStore != NULL) {
 		char c = input[valueState->position.index];
-		if(isSeparator(c)) {
+		if(storeIsSeparatorCharacter(c)) {
+			recordSpan(state, floatStore, terminalPosition.index, valueState->position.index);
 			state->position = valueState->position;
 			reportAndFreeState(true, state, valueState, "value", "parsed float");
 			return floatStore;
 		} else {
-			StoreParseState *floatState = createParseState(valueState->position, state->depth + 1);
+			StoreParseState *floatState = createParseState(valueState->position, state->depth + 1, state->spans);
 			reportAndFreeState(false, valueState, floatState, "float", "expected termination by separator but got '%c'", c);
 			storeFree(floatStore);
 		}
@@ -176,12 +424,13 @@ static Store *parseValue(const char *input, StoreParseState *state)
 	Store *stringStore = parseString(input, valueState);
 	if(stringStore != NULL) {
 		char c = input[valueState->position.index];
-		if(isSeparator(c)) {
+		if(storeIsSeparatorCharacter(c)) {
+			recordSpan(state, stringStore, terminalPosition.index, valueState->position.index);
 			state->position = valueState->position;
 			reportAndFreeState(true, state, valueState, "value", "parsed string");
 			return stringStore;
 		} else {
-			StoreParseState *stringState = createParseState(valueState->position, state->depth + 1);
+			StoreParseState *stringState = createParseState(valueState->position, state->depth + 1, state->spans);
 			reportAndFreeState(false, valueState, stringState, "string", "expected termination by separator but got '%c'", c);
 			storeFree(stringStore);
 		}
@@ -191,12 +440,13 @@ static Store *parseValue(const char *input, StoreParseState *state)
 	Store *listStore = parseList(input, valueState);
 	if(listStore != NULL) {
 		char c = input[valueState->position.index];
-		if(isSeparator(c)) {
+		if(storeIsSeparatorCharacter(c)) {
+			recordSpan(state, listStore, terminalPosition.index, valueState->position.index);
 			state->position = valueState->position;
 			reportAndFreeState(true, state, valueState, "value", "parsed list");
 			return listStore;
 		} else {
-			StoreParseState *listState = createParseState(valueState->position, state->depth + 1);
+			StoreParseState *listState = createParseState(valueState->position, state->depth + 1, state->spans);
 			reportAndFreeState(false, valueState, listState, "list", "expected termination by separator but got '%c'", c);
 			storeFree(listStore);
 		}
@@ -206,12 +456,13 @@ static Store *parseValue(const char *input, StoreParseState *state)
 	Store *mapStore = parseMap(input, valueState);
 	if(mapStore != NULL) {
 		char c = input[valueState->position.index];
-		if(isSeparator(c)) {
+		if(storeIsSeparatorCharacter(c)) {
+			recordSpan(state, mapStore, terminalPosition.index, valueState->position.index);
 			state->position = valueState->position;
 			reportAndFreeState(true, state, valueState, "value", "parsed map");
 			return mapStore;
 		} else {
-			StoreParseState *mapState = createParseState(valueState->position, state->depth + 1);
+			StoreParseState *mapState = createParseState(valueState->position, state->depth + 1, state->spans);
 			reportAndFreeState(false, valueState, mapState, "map", "expected termination by separator but got '%c'", c);
 			storeFree(mapStore);
 		}
@@ -227,7 +478,7 @@ static Store *parseValue(const char *input, StoreParseState *state)
  */
 static Store *parseString(const char *input, StoreParseState *state)
 {
-	StoreParseState *stringState = createParseState(state->position, state->depth + 1);
+	StoreParseState *stringState = createParseState(state->position, state->depth + 1, state->spans);
 
 	Store *stringStore = NULL;
 
@@ -257,7 +508,7 @@ static Store *parseString(const char *input, StoreParseState *state)
 		stringState->position.index++;
 		stringState->position.column++;
 
-		stringStore = storeCreateStringValue(longString->str);
+		stringStore = storeCreateStringValueLength(longString->str, longString->len);
 		g_string_free(longString, true);
 	} else {
 		GString *shortString = parseShortString(input, stringState);
@@ -266,7 +517,7 @@ static Store *parseString(const char *input, StoreParseState *state)
 			return NULL;
 		}
 
-		stringStore = storeCreateStringValue(shortString->str);
+		stringStore = storeCreateStringValueLength(shortString->str, shortString->len);
 		g_string_free(shortString, true);
 	}
 
@@ -280,31 +531,20 @@ static Store *parseString(const char *input, StoreParseState *state)
  */
 static Store *parseInt(const char *input, StoreParseState *state)
 {
-	StoreParseState *intState = createParseState(state->position, state->depth + 1);
-
-	GString *intString = g_string_new("");
-
-	bool isNegative = false;
-	char c = input[intState->position.index];
-	if(c == '-') {
-		g_string_append_printf(intString, "-");
-
-		// eat that character
-		intState->position.index++;
-		intState->position.column++;
-
-		isNegative = true;
-	}
+	StoreParseState *intState = createParseState(state->position, state->depth + 1, state->spans);
 
-	GString *digitsString = parseDigits(input, intState);
-	if(digitsString == NULL) {
+	// the input is null terminated, which ends the scan
+	size_t start = intState->position.index;
+	size_t end = storeScanInt(input, SIZE_MAX, start);
+	if(end == start) {
 		reportAndFreeState(false, state, intState, "int", "expected digits");
-		g_string_free(intString, true);
 		return NULL;
 	}
 
-	g_string_append_printf(intString, "%s", digitsString->str);
-	g_string_free(digitsString, true);
+	bool isNegative = input[start] == '-';
+	GString *intString = g_string_new_len(input + start, end - start);
+	intState->position.index += end - start;
+	intState->position.column += end - start;
 
 	state->position = intState->position;
 	reportAndFreeState(true, state, intState, "int", "parsed %s int", isNegative ? "negative" : "positive");
@@ -315,50 +555,29 @@ static Store *parseInt(const char *input, StoreParseState *state)
 
 /**
  * float	: '-'? digits floating? exponential?
+ *
+ * where
+ * floating		: '.' digits?
+ * exponential	: ('e'|'E') ('+'|'-')? digits
  */
 static Store *parseFloat(const char *input, StoreParseState *state)
 {
-	StoreParseState *floatState = createParseState(state->position, state->depth + 1);
-
-	GString *floatString = g_string_new("");
-
-	bool isNegative = false;
-	char c = input[floatState->position.index];
-	if(c == '-') {
-		g_string_append_printf(floatString, "-");
-
-		// eat that character
-		floatState->position.index++;
-		floatState->position.column++;
+	StoreParseState *floatState = createParseState(state->position, state->depth + 1, state->spans);
 
-		isNegative = true;
-	}
-
-	GString *digitsString = parseDigits(input, floatState);
-	if(digitsString == NULL) {
+	// the input is null terminated, which ends the scan
+	size_t start = floatState->position.index;
+	size_t end = storeScanFloat(input, SIZE_MAX, start);
+	if(end == start) {
 		reportAndFreeState(false, state, floatState, "float", "expected digits");
-		g_string_free(floatString, true);
 		return NULL;
 	}
 
-	g_string_append_printf(floatString, "%s", digitsString->str);
-	g_string_free(digitsString, true);
-
-	bool hasFloating = false;
-	GString *floatingString = parseFloating(input, floatState);
-	if(floatingString != NULL) {
-		g_string_append_printf(floatString, "%s", floatingString->str);
-		g_string_free(floatingString, true);
-		hasFloating = true;
-	}
-
-	bool hasExponential = false;
-	GString *exponentialString = parseExponential(input, floatState);
-	if(exponentialString != NULL) {
-		g_string_append_printf(floatString, "%s", exponentialString->str);
-		g_string_free(exponentialString, true);
-		hasExponential = true;
-	}
+	bool isNegative = input[start] == '-';
+	GString *floatString = g_string_new_len(input + start, end - start);
+	bool hasFloating = strchr(floatString->str, '.') != NULL;
+	bool hasExponential = strpbrk(floatString->str, "eE") != NULL;
+	floatState->position.index += end - start;
+	floatState->position.column += end - start;
 
 	state->position = floatState->position;
 	reportAndFreeState(true, state, floatState, "float", "parsed %s float %s floating part and %s exponential part", isNegative ? "negative" : "positive", hasFloating ? "with" : "without", hasExponential ? "with" : "without");
@@ -373,10 +592,10 @@ static Store *parseFloat(const char *input, StoreParseState *state)
  */
 static Store *parseList(const char *input, StoreParseState *state)
 {
-	StoreParseState *listState = createParseState(state->position, state->depth + 1);
+	StoreParseState *listState = createParseState(state->position, state->depth + 1, state->spans);
 
-	if(listState->depth >= maxDepth) {
-		reportAndFreeState(false, state, listState, "list", "reached maximum depth of %d", maxDepth);
+	if(listState->depth >= STORE_MAX_PARSE_DEPTH) {
+		reportAndFreeState(false, state, listState, "list", "reached maximum depth of %d", STORE_MAX_PARSE_DEPTH);
 		return NULL;
 	}
 
@@ -451,7 +670,7 @@ static Store *parseList(const char *input, StoreParseState *state)
  */
 static Store *parseElements(const char *input, StoreParseState *state)
 {
-	StoreParseState *elementsState = createParseState(state->position, state->depth + 1);
+	StoreParseState *elementsState = createParseState(state->position, state->depth + 1, state->spans);
 
 	int numElements = 0;
 	Store *listStore = storeCreateListValue();
@@ -475,10 +694,10 @@ static Store *parseElements(const char *input, StoreParseState *state)
  */
 static Store *parseMap(const char *input, StoreParseState *state)
 {
-	StoreParseState *mapState = createParseState(state->position, state->depth + 1);
+	StoreParseState *mapState = createParseState(state->position, state->depth + 1, state->spans);
 
-	if(mapState->depth >= maxDepth) {
-		reportAndFreeState(false, state, mapState, "map", "reached maximum depth of %d", maxDepth);
+	if(mapState->depth >= STORE_MAX_PARSE_DEPTH) {
+		reportAndFreeState(false, state, mapState, "map", "reached maximum depth of %d", STORE_MAX_PARSE_DEPTH);
 		return NULL;
 	}
 
@@ -523,7 +742,7 @@ static Store *parseMap(const char *input, StoreParseState *state)
  */
 static Store *parseEntries(const char *input, StoreParseState *state)
 {
-	StoreParseState *entriesState = createParseState(state->position, state->depth + 1);
+	StoreParseState *entriesState = createParseState(state->position, state->depth + 1, state->spans);
 
 	int numEntries = 0;
 	Store *entriesStore = storeCreateMapValue();
@@ -533,7 +752,8 @@ static Store *parseEntries(const char *input, StoreParseState *state)
 			break;
 		}
 
-		g_hash_table_insert(entriesStore->content.mapValue, entry->key, entry->value);
+		storeMapInsert(entriesStore, entry->key, entry->value);
+		free(entry->key);
 		storeFreeMemory(entry);
 		numEntries++;
 	}
@@ -549,7 +769,7 @@ static Store *parseEntries(const char *input, StoreParseState *state)
  */
 static Entry *parseEntry(const char *input, StoreParseState *state)
 {
-	StoreParseState *entryState = createParseState(state->position, state->depth + 1);
+	StoreParseState *entryState = createParseState(state->position, state->depth + 1, state->spans);
 
 	char c = parseTerminal(input, entryState);
 	if(c == '\0') {
@@ -595,135 +815,6 @@ static Entry *parseEntry(const char *input, StoreParseState *state)
 	return entry;
 }
 
-/**
- * digits	: digit+
- */
-static GString *parseDigits(const char *input, StoreParseState *state)
-{
-	StoreParseState *digitsState = createParseState(state->position, state->depth + 1);
-
-	GString *digitsString = g_string_new("");
-
-	int numDigits = 0;
-	while(true) {
-		char c = input[digitsState->position.index];
-
-		if(!isdigit(c)) {
-			break;
-		}
-
-		digitsState->position.index++;
-		digitsState->position.column++;
-		g_string_append_printf(digitsString, "%c", c);
-
-		numDigits++;
-	}
-
-	if(numDigits == 0) {
-		reportAndFreeState(false, state, digitsState, "digits", "no digits parsed");
-		g_string_free(digitsString, true);
-		return NULL;
-	}
-
-	state->position = digitsState->position;
-	reportAndFreeState(true, state, digitsState, "digits", "parsed %d digits", numDigits);
-	return digitsString;
-}
-
-/**
- * floating	: '.' digits?
- */
-static GString *parseFloating(const char *input, StoreParseState *state)
-{
-	StoreParseState *floatingState = createParseState(state->position, state->depth + 1);
-
-	GString *floatingString = g_string_new("");
-
-	char c = input[floatingState->position.index];
-	if(c == '\0') {
-		reportAndFreeState(false, state, floatingState, "floating", "unexpected end of input");
-		g_string_free(floatingString, true);
-		return NULL;
-	} else if(c == '.') {
-		g_string_append_printf(floatingString, ".");
-
-		// eat that character
-		floatingState->position.index++;
-		floatingState->position.column++;
-	}
-
-	bool hasDigits = false;
-	GString *digitsString = parseDigits(input, floatingState);
-	if(digitsString != NULL) {
-		g_string_append_printf(floatingString, "%s", digitsString->str);
-		g_string_free(digitsString, true);
-		hasDigits = true;
-	}
-
-	state->position = floatingState->position;
-	reportAndFreeState(true, state, floatingState, "floating", "parsed floating %s digits", hasDigits ? "with" : "without");
-	return floatingString;
-}
-
-/**
- * exponential : ('e'|'E') ('+'|'-')? digits
- */
-static GString *parseExponential(const char *input, StoreParseState *state)
-{
-	StoreParseState *exponentialState = createParseState(state->position, state->depth + 1);
-
-	GString *exponentialString = g_string_new("");
-
-	char c = input[exponentialState->position.index];
-	if(c == '\0') {
-		reportAndFreeState(false, state, exponentialState, "exponential", "unexpected end of input");
-		g_string_free(exponentialString, true);
-		return NULL;
-	} else if(c != 'e' && c != 'E') {
-		reportAndFreeState(false, state, exponentialState, "exponential", "expected 'e' or 'E'");
-		g_string_free(exponentialString, true);
-		return NULL;
-	}
-
-	g_string_append_printf(exponentialString, "%c", c);
-
-	// eat that character
-	exponentialState->position.index++;
-	exponentialState->position.column++;
-
-	bool isNegative = false;
-	c = input[exponentialState->position.index];
-	if(c == '\0') {
-		reportAndFreeState(false, state, exponentialState, "exponential", "unexpected end of input");
-		g_string_free(exponentialString, true);
-		return NULL;
-	} else if(c == '+' || c == '-') {
-		g_string_append_printf(exponentialString, "%c", c);
-
-		// eat that character
-		exponentialState->position.index++;
-		exponentialState->position.column++;
-
-		if(c == '-') {
-			isNegative = true;
-		}
-	}
-
-	GString *digitsString = parseDigits(input, exponentialState);
-	if(digitsString == NULL) {
-		reportAndFreeState(false, state, exponentialState, "exponential", "expected digits");
-		g_string_free(exponentialString, true);
-		return NULL;
-	}
-
-	g_string_append_printf(exponentialString, "%s", digitsString->str);
-	g_string_free(digitsString, true);
-
-	state->position = exponentialState->position;
-	reportAndFreeState(true, state, exponentialState, "exponential", "parsed %s exponential", isNegative ? "negative" : "positive");
-	return exponentialString;
-}
-
 /**
  * shortstring		: shortstringchar+
  *
@@ -732,13 +823,13 @@ static GString *parseExponential(const char *input, StoreParseState *state)
  */
 static GString *parseShortString(const char *input, StoreParseState *state)
 {
-	StoreParseState *shortStringState = createParseState(state->position, state->depth + 1);
+	StoreParseState *shortStringState = createParseState(state->position, state->depth + 1, state->spans);
 
 	int numChars = 0;
 	GString *shortString = g_string_new("");
 	while(true) {
 		char c = input[shortStringState->position.index];
-		if(isSeparator(c)) {
+		if(storeIsSeparatorCharacter(c)) {
 			break;
 		}
 
@@ -770,102 +861,30 @@ static GString *parseShortString(const char *input, StoreParseState *state)
  */
 static GString *parseLongString(const char *input, StoreParseState *state)
 {
-	StoreParseState *longStringState = createParseState(state->position, state->depth + 1);
+	StoreParseState *longStringState = createParseState(state->position, state->depth + 1, state->spans);
 
 	int numChars = 0;
 	GString *longString = g_string_new("");
 	while(true) {
 		char c = input[longStringState->position.index];
 		if(c == '\\') {
-			longStringState->position.index++;
-			longStringState->position.column++;
-
-			c = input[longStringState->position.index];
-			longStringState->position.index++;
-			longStringState->position.column++;
-
-			switch(c) {
-				case '"':
-					g_string_append_printf(longString, "\"");
-				break;
-				case '\\':
-					g_string_append_printf(longString, "\\");
-				break;
-				case '/':
-					g_string_append_printf(longString, "/");
-				break;
-				case 'b':
-					g_string_append_printf(longString, "\b");
-				break;
-				case 'f':
-					g_string_append_printf(longString, "\f");
-				break;
-				case 'n':
-					g_string_append_printf(longString, "\n");
-				break;
-				case 'r':
-					g_string_append_printf(longString, "\r");
-				break;
-				case 't':
-					g_string_append_printf(longString, "\t");
-				break;
-				case 'u':
-				{
-					char u1 = input[longStringState->position.index];
-					if(!isHex(u1)) {
-						reportAndFreeState(false, state, longStringState, "long string", "expected first hex number of escaped unicode character, but got '%c'", u1);
-						g_string_free(longString, true);
-						return NULL;
-					}
-					longStringState->position.index++;
-					longStringState->position.column++;
-
-					char u2 = input[longStringState->position.index];
-					if(!isHex(u2)) {
-						reportAndFreeState(false, state, longStringState, "long string", "expected second hex number of escaped unicode character, but got '%c'", u2);
-						g_string_free(longString, true);
-						return NULL;
-					}
-					longStringState->position.index++;
-					longStringState->position.column++;
-
-					char u3 = input[longStringState->position.index];
-					if(!isHex(u3)) {
-						reportAndFreeState(false, state, longStringState, "long string", "expected third hex number of escaped unicode character, but got '%c'", u3);
-						g_string_free(longString, true);
-						return NULL;
-					}
-					longStringState->position.index++;
-					longStringState->position.column++;
-
-					char u4 = input[longStringState->position.index];
-					if(!isHex(u4)) {
-						reportAndFreeState(false, state, longStringState, "long string", "expected fourth hex number of escaped unicode character, but got '%c'", u4);
-						g_string_free(longString, true);
-						return NULL;
-					}
-					longStringState->position.index++;
-					longStringState->position.column++;
-
-					char conversion[5] = {u1, u2, u3, u4, '\0'};
-					uint32_t codepoint = strtol(conversion, NULL, 16);
-					GString *utf8 = storeConvertUnicodeToUtf8(codepoint);
-					if(utf8 == NULL) {
-						reportAndFreeState(false, state, longStringState, "long string", "failed to convert unicode code point %x to UTF-8", codepoint);
-						g_string_free(longString, true);
-						return NULL;
-					}
-
-					g_string_append_printf(longString, "%s", utf8->str);
-					g_string_free(utf8, true);
-				}
-				break;
-				default:
-					reportAndFreeState(false, state, longStringState, "long string", "expected escaped character, but got '%c'", c);
-					g_string_free(longString, true);
-					return NULL;
-				break;
+			// the input is null terminated, which ends the scan
+			size_t position = longStringState->position.index;
+			uint32_t codepoint;
+			bool scanned = storeScanEscapeSequence(input, SIZE_MAX, &position, &codepoint);
+			longStringState->position.column += position - longStringState->position.index;
+			longStringState->position.index = position;
+
+			if(!scanned) {
+				reportAndFreeState(false, state, longStringState, "long string", "invalid escape sequence at '%c'", input[position]);
+				g_string_free(longString, true);
+				return NULL;
 			}
+
+			// escaped surrogates were rejected, so every escaped code point can be converted
+			GString *utf8 = storeConvertUnicodeToUtf8(codepoint);
+			g_string_append_printf(longString, "%s", utf8->str);
+			g_string_free(utf8, true);
 		} else if(c == '"' || c == '\0') {
 			break;
 		} else {
@@ -890,13 +909,13 @@ static GString *parseLongString(const char *input, StoreParseState *state)
 
 static char parseTerminal(const char *input, StoreParseState *state)
 {
-	StoreParseState *terminalState = createParseState(state->position, state->depth + 1);
+	StoreParseState *terminalState = createParseState(state->position, state->depth + 1, state->spans);
 
 	int numDelimiters = 0;
 	while(true) {
 		char c = input[terminalState->position.index];
 
-		if(!isspace(c) && c != ',' && c != ';') {
+		if(!storeIsTerminalCharacter(c)) {
 			break;
 		}
 
@@ -917,15 +936,29 @@ static char parseTerminal(const char *input, StoreParseState *state)
 	return terminal;
 }
 
-static StoreParseState *createParseState(StoreParseStatePosition position, int depth)
+static StoreParseState *createParseState(StoreParseStatePosition position, int depth, StoreSpanTable *spans)
 {
 	StoreParseState *state = storeAllocateMemoryType(StoreParseState);
 	state->position = position;
 	state->depth = depth;
 	state->reports = g_queue_new();
+	state->spans = spans;
 	return state;
 }
 
+/**
+ * Records the source span of a parsed store if the parse state records spans, replacing the span of any store
+ * previously parsed and freed at the same address
+ */
+static void recordSpan(StoreParseState *state, Store *store, int start, int end)
+{
+	if(state->spans == NULL) {
+		return;
+	}
+
+	storeSpanTableSet(state->spans, store, start, end);
+}
+
 static void freeParseState(StoreParseState *state)
 {
 	g_queue_free_full(state->reports, freeParseReportPointer);
@@ -974,13 +1007,3 @@ static void freeParseReport(StoreParseReport *parseReport)
 	g_queue_free_full(parseReport->subreports, freeParseReportPointer);
 	storeFreeMemory(parseReport);
 }
-
-static bool isHex(char c)
-{
-	return isdigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
-}
-
-static bool isSeparator(char c)
-{
-	return isspace(c) || c == ',' || c == ';' || c == '"' || c == '(' || c == '[' || c == '{' || c == ')' || c == ']' || c == '}' || c == ':' || c == '=' || c == '\0';
-}
@@ -5,6 +5,7 @@
 
 extern "C" {
 	#include <store/report.h>
+	#include <store/syntax.h>
 }
 
 #include "encoding.c"
@@ -20,6 +21,7 @@ public:
 		state.position.column = 1;
 		state.depth = 0;
 		state.reports = g_queue_new();
+		state.spans = NULL;
 	}
 
 	virtual void TearDown() {
@@ -58,3 +60,4 @@ protected:
 #include "parser_test_parseFloat.h"
 #include "parser_test_parseList.h"
 #include "parser_test_parseMap.h"
+#include "parser_test_storeReparse.h"
@@ -1,6 +1,7 @@
 #include <glib.h>
 #include <gtest/gtest.h>
 
+#include "store/map.h"
 #include "store/store.h"
 
 TEST_F(Parser, parseMapEmpty)
@@ -10,7 +11,7 @@ TEST_F(Parser, parseMapEmpty)
 	Store *result = parseMap(input, &state);
 	ASSERT_TRUE(result != NULL) << "parseMap should not return NULL";
 	ASSERT_EQ(result->type, STORE_MAP) << "parseMap should return a store of type map";
-	ASSERT_EQ(g_hash_table_size(result->content.mapValue), 0) << "parsed map should be empty";
+	ASSERT_EQ(storeMapGetSize(result), 0) << "parsed map should be empty";
 	storeFree(result);
 
 	assertReportSuccess("map");
@@ -23,7 +24,7 @@ TEST_F(Parser, parseMapEmptyGap)
 	Store *result = parseMap(input, &state);
 	ASSERT_TRUE(result != NULL) << "parseMap should not return NULL";
 	ASSERT_EQ(result->type, STORE_MAP) << "parseMap should return a store of type map";
-	ASSERT_EQ(g_hash_table_size(result->content.mapValue), 0) << "parsed map should be empty";
+	ASSERT_EQ(storeMapGetSize(result), 0) << "parsed map should be empty";
 	storeFree(result);
 
 	assertReportSuccess("map");
@@ -38,14 +39,14 @@ TEST_F(Parser, parseMapSimple)
 	Store *result = parseMap(input, &state);
 	ASSERT_TRUE(result != NULL) << "parseMap should not return NULL";
 	ASSERT_EQ(result->type, STORE_MAP) << "parseMap should return a store of type map";
-	ASSERT_EQ(g_hash_table_size(result->content.mapValue), 1) << "parsed map should have one entry";
+	ASSERT_EQ(storeMapGetSize(result), 1) << "parsed map should have one entry";
 
-	GHashTableIter iter;
-	g_hash_table_iter_init(&iter, result->content.mapValue);
+	StoreMapIterator iter;
+	storeMapIteratorInit(&iter, result);
 
 	const char *key;
 	Store *value;
-	bool firstIteration = g_hash_table_iter_next(&iter, (gpointer *) &key, (gpointer *) &value);
+	bool firstIteration = storeMapIteratorNext(&iter, &key, &value);
 	ASSERT_TRUE(firstIteration) << "store map iterator should be valid";
 	ASSERT_TRUE(key != NULL) << "StoreGetCurrentMapIteratorKey should not return NULL when iterator is still valid";
 	ASSERT_STREQ(key, solution_key) << "key of map entry should have been parsed correctly";
@@ -53,7 +54,7 @@ TEST_F(Parser, parseMapSimple)
 	ASSERT_EQ(value->type, STORE_STRING) << "value of map entry should be a store of type string";
 	ASSERT_STREQ(value->content.stringValue, solution_value) << "value of map entry should have been parsed to the correct string value";
 
-	bool secondIteration = g_hash_table_iter_next(&iter, (gpointer *) &key, (gpointer *) &value);
+	bool secondIteration = storeMapIteratorNext(&iter, &key, &value);
 	ASSERT_FALSE(secondIteration) << "forwarding map iterator should reach the end";
 
 	storeFree(result);
@@ -73,15 +74,15 @@ TEST_F(Parser, parseMapMultiple)
 	Store *result = parseMap(input, &state);
 	ASSERT_TRUE(result != NULL) << "parseMap should not return NULL";
 	ASSERT_EQ(result->type, STORE_MAP) << "parseMap should return a store of type map";
-	ASSERT_EQ(g_hash_table_size(result->content.mapValue), 3) << "parsed map should have three entries";
+	ASSERT_EQ(storeMapGetSize(result), 3) << "parsed map should have three entries";
 
-	GHashTableIter iter;
-	g_hash_table_iter_init(&iter, result->content.mapValue);
+	StoreMapIterator iter;
+	storeMapIteratorInit(&iter, result);
 
 	int hits = 0;
 	const char *key;
 	Store *value;
-	while(g_hash_table_iter_next(&iter, (gpointer *) &key, (gpointer *) &value)) {
+	while(storeMapIteratorNext(&iter, &key, &value)) {
 		ASSERT_TRUE(key != NULL) << "iterator key should not be NULL when iterator is still valid";
 		ASSERT_TRUE(value != NULL) << "iterator key should not be NULL when iterator is still valid";
 
@@ -96,7 +97,7 @@ TEST_F(Parser, parseMapMultiple)
 			hits++;
 		} else if(stdStringKey == solution_key3) {
 			ASSERT_EQ(value->type, STORE_MAP) << "value of third map entry should be a store of type map";
-			ASSERT_EQ(g_hash_table_size(value->content.mapValue), 0) << "value of third map entry should have been parsed to an empty map value";
+			ASSERT_EQ(storeMapGetSize(value), 0) << "value of third map entry should have been parsed to an empty map value";
 			hits++;
 		} else {
 			ASSERT_TRUE(false) << "invalid parsed entry with key: " << stdStringKey;
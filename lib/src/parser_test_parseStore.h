@@ -1,6 +1,7 @@
 #include <glib.h>
 #include <gtest/gtest.h>
 
+#include "store/map.h"
 #include "store/store.h"
 
 TEST_F(Parser, parseStoreValue)
@@ -30,17 +31,17 @@ TEST_F(Parser, parseStoreEntries)
 	Store *result = parseStore(input, &state);
 	ASSERT_TRUE(result != NULL) << "StoreParse should not return NULL";
 	ASSERT_EQ(result->type, STORE_MAP) << "StoreParse should return a store of type map";
-	ASSERT_EQ(g_hash_table_size(result->content.mapValue), 2) << "parsed map should have two entries";
+	ASSERT_EQ(storeMapGetSize(result), 2) << "parsed map should have two entries";
 	ASSERT_EQ(state.position.index, 32) << "state position index should have moved to end of input";
 	ASSERT_EQ(state.position.column, 33) << "state position column should have moved to end of input";
 
-	GHashTableIter iter;
-	g_hash_table_iter_init(&iter, result->content.mapValue);
+	StoreMapIterator iter;
+	storeMapIteratorInit(&iter, result);
 
 	int hits = 0;
 	const char *key;
 	Store *value;
-	while(g_hash_table_iter_next(&iter, (gpointer *) &key, (gpointer *) &value)) {
+	while(storeMapIteratorNext(&iter, &key, &value)) {
 		ASSERT_TRUE(key != NULL) << "iterator key should not be NULL when iterator is still valid";
 		ASSERT_TRUE(value != NULL) << "iterator key should not be NULL when iterator is still valid";
 
@@ -12,6 +12,7 @@ TEST_F(Parser, parseStringSimple)
 	ASSERT_TRUE(result != NULL) << "parseString should not return NULL";
 	ASSERT_EQ(result->type, STORE_STRING) << "parseString should return a store of type string";
 	ASSERT_STREQ(result->content.stringValue, solution) << "parseString should parse the correct string value";
+	ASSERT_EQ(storeGetStringLength(result), strlen(solution)) << "parsed string should have the correct length";
 	storeFree(result);
 
 	assertReportSuccess("string");
@@ -146,6 +147,7 @@ TEST_F(Parser, parseStringLongEmpty)
 	ASSERT_TRUE(result != NULL) << "parseString should not return NULL";
 	ASSERT_EQ(result->type, STORE_STRING) << "parseString should return a store of type string";
 	ASSERT_STREQ(result->content.stringValue, solution) << "parseString should parse the correct string value";
+	ASSERT_EQ(storeGetStringLength(result), 0) << "parsed empty string should have zero length";
 	storeFree(result);
 
 	assertReportSuccess("string");
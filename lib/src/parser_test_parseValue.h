@@ -1,6 +1,7 @@
 #include <glib.h>
 #include <gtest/gtest.h>
 
+#include "store/map.h"
 #include "store/store.h"
 
 TEST_F(Parser, parseValuePrefixInt)
@@ -137,7 +138,7 @@ TEST_F(Parser, parseValueEmptyMap)
 	Store *result = parseValue(input, &state);
 	ASSERT_TRUE(result != NULL) << "parseValue should not return NULL";
 	ASSERT_EQ(result->type, STORE_MAP) << "parseValue should return a store of type map";
-	ASSERT_EQ(g_hash_table_size(result->content.mapValue), 0) << "parseValue map should be empty";
+	ASSERT_EQ(storeMapGetSize(result), 0) << "parseValue map should be empty";
 	storeFree(result);
 
 	assertReportSuccess("value");
@@ -0,0 +1,108 @@
+#include <string>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "store/list.h"
+#include "store/map.h"
+#include "store/store.h"
+
+static StoreSpan *getSpan(StoreParser *parser, Store *store)
+{
+	static StoreSpan span;
+	EXPECT_TRUE(storeSpanTableLookup(parser->spans, store, &span)) << "store should have a span";
+	return &span;
+}
+
+TEST(Reparse, spans)
+{
+	std::string input = "a = {b = [1 2 3], c = x}; d = [4]";
+	StoreParser *parser = storeCreateParser();
+	storeSetParserFlags(parser, STORE_PARSE_SPANS);
+	Store *store = storeParse(parser, input.c_str());
+	ASSERT_TRUE(store != NULL) << "input should parse successfully";
+
+	Store *a = storeMapLookup(store, "a");
+	Store *b = storeMapLookup(a, "b");
+	ASSERT_EQ(getSpan(parser, store)->start, 0) << "entries store should start at the beginning of the input";
+	ASSERT_EQ(getSpan(parser, store)->end, (int) input.size()) << "entries store should end at the end of the input";
+	ASSERT_EQ(getSpan(parser, a)->start, (int) input.find('{')) << "map should start at its opening bracket";
+	ASSERT_EQ(getSpan(parser, a)->end, (int) input.find('}') + 1) << "map should end after its closing bracket";
+	ASSERT_EQ(getSpan(parser, b)->start, (int) input.find('[')) << "list should start at its opening bracket";
+	ASSERT_EQ(getSpan(parser, storeListGet(b, 1))->start, (int) input.find('2')) << "element should start at its first character";
+	ASSERT_EQ(getSpan(parser, storeListGet(b, 1))->end, (int) input.find('2') + 1) << "element should end after its last character";
+	ASSERT_EQ(storeSpanTableGetSize(parser->spans), 9) << "only the spans of the parsed stores should be retained";
+
+	storeFree(store);
+	storeFreeParser(parser);
+}
+
+TEST(Reparse, inPlace)
+{
+	std::string input = "a = {b = [1 2 3], c = x}; d = [4]";
+	StoreParser *parser = storeCreateParser();
+	storeSetParserFlags(parser, STORE_PARSE_SPANS);
+	Store *store = storeParse(parser, input.c_str());
+	Store *a = storeMapLookup(store, "a");
+	Store *b = storeMapLookup(a, "b");
+	Store *d = storeMapLookup(store, "d");
+	int dStart = getSpan(parser, d)->start;
+
+	// replace "2" by "22"
+	int editStart = input.find('2');
+	input.replace(editStart, 1, "22");
+	Store *reparsed = storeReparse(parser, store, input.c_str(), editStart, 1, 2);
+	ASSERT_EQ(reparsed, store) << "edit within a list should be re-parsed in place";
+	ASSERT_EQ(storeMapLookup(store, "a"), a) << "enclosing map should be kept";
+	ASSERT_EQ(storeMapLookup(a, "b"), b) << "re-parsed list should be modified in place";
+	ASSERT_EQ(storeMapLookup(store, "d"), d) << "stores following the edit should be kept";
+	ASSERT_EQ(storeListGet(b, 1)->content.intValue, 22) << "re-parsed list should contain the edited element";
+	ASSERT_EQ(getSpan(parser, d)->start, dStart + 1) << "spans following the edit should be shifted";
+	ASSERT_EQ(getSpan(parser, b)->end, (int) input.find(']') + 1) << "span of the re-parsed list should be updated";
+	ASSERT_EQ(getSpan(parser, storeListGet(b, 2))->start, (int) input.find('3')) << "re-parsed elements should have spans in the edited input";
+
+	// insert a new entry into the map
+	editStart = input.find('}');
+	input.insert(editStart, ", e = [5 6]");
+	reparsed = storeReparse(parser, store, input.c_str(), editStart, 0, 11);
+	ASSERT_EQ(reparsed, store) << "edit within a map should be re-parsed in place";
+	ASSERT_EQ(storeMapLookup(store, "a"), a) << "re-parsed map should be modified in place";
+	ASSERT_EQ(storeListGetLength(storeMapLookup(a, "e")), 2) << "re-parsed map should contain the inserted entry";
+	ASSERT_EQ(getSpan(parser, d)->start, (int) input.rfind('[')) << "spans following both edits should be shifted";
+
+	storeFree(store);
+	storeFreeParser(parser);
+}
+
+TEST(Reparse, fallback)
+{
+	std::string input = "a = {b = [1 2 3]}; c = x";
+	StoreParser *parser = storeCreateParser();
+	storeSetParserFlags(parser, STORE_PARSE_SPANS);
+	Store *store = storeParse(parser, input.c_str());
+
+	// an edit outside of any list or map re-parses the whole input
+	int editStart = input.find('x');
+	input.replace(editStart, 1, "y");
+	store = storeReparse(parser, store, input.c_str(), editStart, 1, 1);
+	ASSERT_TRUE(store != NULL) << "edited input should parse";
+	ASSERT_STREQ(storeMapLookup(store, "c")->content.stringValue, "y") << "edited entry should be parsed";
+
+	// an edit breaking the brackets of the enclosing list re-parses the whole input
+	editStart = input.find('2');
+	input.replace(editStart, 1, "] d = [");
+	store = storeReparse(parser, store, input.c_str(), editStart, 1, 7);
+	ASSERT_TRUE(store != NULL) << "edited input should parse";
+	ASSERT_EQ(storeListGetLength(storeMapLookup(storeMapLookup(store, "a"), "b")), 1) << "list should be split by the edit";
+	ASSERT_EQ(storeListGetLength(storeMapLookup(storeMapLookup(store, "a"), "d")), 1) << "list should be split by the edit";
+
+	// an edit resulting in invalid input leaves the store unchanged
+	editStart = input.find('{');
+	std::string invalid = input;
+	invalid.erase(editStart, 1);
+	ASSERT_TRUE(storeReparse(parser, store, invalid.c_str(), editStart, 1, 0) == NULL) << "invalid input should not parse";
+	ASSERT_STREQ(storeMapLookup(store, "c")->content.stringValue, "y") << "store should be unchanged";
+
+	storeFree(store);
+	storeFreeParser(parser);
+}
@@ -0,0 +1,618 @@
+#include <ctype.h> // isdigit
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL
+#include <stdlib.h> // strtol
+#include <string.h> // memcpy
+
+#include <glib.h>
+
+#include "store/list.h"
+#include "store/map.h"
+#include "store/memory.h"
+#include "store/path.h"
+
+typedef enum {
+	/** Selects the value of a key in a map */
+	SEGMENT_KEY,
+	/** Selects the element at an index in a list, negative indices count from the end */
+	SEGMENT_INDEX,
+	/** Selects every value of a map or every element of a list */
+	SEGMENT_WILDCARD
+} SegmentType;
+
+typedef struct {
+	SegmentType type;
+	/** The key to select for key segments */
+	StoreKey *key;
+	/** The index to select for index segments */
+	int index;
+} Segment;
+
+struct StorePathStruct {
+	int numSegments;
+	Segment *segments;
+	bool hasWildcard;
+	/** Buffer for returning an element of a packed array from a lookup */
+	Store element;
+};
+
+typedef struct {
+	/** The store reached at this depth */
+	Store *store;
+	/** The number of children already visited at this depth */
+	int position;
+	/** The next list element to visit at this depth if iterating over a list */
+	GList *link;
+	/** Buffer for the child at this depth if it is an element of a packed array */
+	Store element;
+} IteratorLevel;
+
+struct StorePathIteratorStruct {
+	StorePath *path;
+	/** The iteration state for each depth, with the root at depth zero */
+	IteratorLevel *levels;
+	/** The current depth, or -1 if the iteration has finished */
+	int depth;
+};
+
+static const char *compileSegment(const char *input, Segment *segment);
+static const char *compileBracketSegment(const char *input, Segment *segment);
+static void appendSegment(StorePath *path, int *capacity, Segment *segment);
+static Store *selectChild(Store *store, Segment *segment, Store *element);
+static Store *selectNextChild(IteratorLevel *level);
+static Store *withValue(Store *store, Segment *segments, int numSegments, Store *value);
+static Store *withArrayElement(Store *store, int index, Store *value);
+static Store *selectParent(Store *store, StorePath *path);
+static bool isModifiable(Store *store);
+static int resolveIndex(Store *store, Segment *segment);
+
+StorePath *storeCompilePath(const char *pathString)
+{
+	StorePath *path = storeAllocateMemoryType(StorePath);
+	path->numSegments = 0;
+	path->segments = NULL;
+	path->hasWildcard = false;
+
+	int capacity = 0;
+	const char *input = pathString;
+	while(*input != '\0') {
+		Segment segment;
+		if(*input == '[') {
+			input = compileBracketSegment(input + 1, &segment);
+		} else {
+			input = compileSegment(input, &segment);
+		}
+
+		if(input == NULL) {
+			storeFreePath(path);
+			return NULL;
+		}
+
+		appendSegment(path, &capacity, &segment);
+
+		if(*input == '.') {
+			input++;
+
+			// a dot must be followed by a key
+			if(*input == '\0' || *input == '.' || *input == '[') {
+				storeFreePath(path);
+				return NULL;
+			}
+		} else if(*input != '[' && *input != '\0') {
+			storeFreePath(path);
+			return NULL;
+		}
+	}
+
+	return path;
+}
+
+void storeFreePath(StorePath *path)
+{
+	for(int i = 0; i < path->numSegments; i++) {
+		if(path->segments[i].key != NULL) {
+			storeFreeKey(path->segments[i].key);
+		}
+	}
+
+	storeFreeMemory(path->segments);
+	storeFreeMemory(path);
+}
+
+Store *storeGetPath(Store *store, StorePath *path)
+{
+	if(path->hasWildcard) {
+		StorePathIterator *iterator = storeCreatePathIterator(store, path);
+		Store *result = storePathIteratorNext(iterator);
+
+		// move a packed array element out of the iterator's buffers before freeing them
+		if(result != NULL && path->numSegments > 0 && result == &iterator->levels[path->numSegments - 1].element) {
+			path->element = *result;
+			result = &path->element;
+		}
+
+		storeFreePathIterator(iterator);
+		return result;
+	}
+
+	return storeGetPathFrom(store, path, 0);
+}
+
+int storePathGetNumSegments(StorePath *path)
+{
+	return path->numSegments;
+}
+
+bool storePathHasWildcard(StorePath *path)
+{
+	return path->hasWildcard;
+}
+
+StoreKey *storePathGetKey(StorePath *path, int segment)
+{
+	return path->segments[segment].type == SEGMENT_KEY ? path->segments[segment].key : NULL;
+}
+
+Store *storeGetPathFrom(Store *store, StorePath *path, int firstSegment)
+{
+	for(int i = firstSegment; i < path->numSegments && store != NULL; i++) {
+		store = selectChild(store, &path->segments[i], &path->element);
+	}
+
+	return store;
+}
+
+Store *storeWith(Store *store, StorePath *path, Store *value)
+{
+	if(path->hasWildcard) {
+		return NULL;
+	}
+
+	return withValue(store, path->segments, path->numSegments, value);
+}
+
+bool storeSetPath(Store *store, StorePath *path, Store *value)
+{
+	if(path->numSegments == 0) {
+		if(!isModifiable(store) || value->references > 1) {
+			return false;
+		}
+
+		storeReplaceContent(store, value);
+		return true;
+	}
+
+	Store *parent = selectParent(store, path);
+	if(parent == NULL) {
+		return false;
+	}
+
+	Segment *segment = &path->segments[path->numSegments - 1];
+	if(segment->type == SEGMENT_KEY) {
+		if(parent->type != STORE_MAP) {
+			return false;
+		}
+
+		storeMapInsert(parent, segment->key->string, value);
+		return true;
+	}
+
+	int index = resolveIndex(parent, segment);
+	if(index < 0 || index >= storeListGetLength(parent)) {
+		return false;
+	}
+
+	if(parent->type == STORE_INT_ARRAY && value->type == STORE_INT) {
+		parent->content.arrayValue->intValues[index] = value->content.intValue;
+		storeFree(value);
+		return true;
+	} else if(parent->type == STORE_FLOAT_ARRAY && value->type == STORE_FLOAT) {
+		parent->content.arrayValue->floatValues[index] = value->content.floatValue;
+		storeFree(value);
+		return true;
+	}
+
+	// removing first keeps the indexes maintained over the list up to date
+	return storeListRemove(parent, index) && storeListInsert(parent, index, value);
+}
+
+bool storeInsertPath(Store *store, StorePath *path, Store *value)
+{
+	Store *parent = selectParent(store, path);
+	if(parent == NULL) {
+		return false;
+	}
+
+	Segment *segment = &path->segments[path->numSegments - 1];
+	if(segment->type == SEGMENT_KEY) {
+		return storeMapGet(parent, segment->key) == NULL && storeMapInsert(parent, segment->key->string, value);
+	}
+
+	return storeListInsert(parent, segment->index, value);
+}
+
+bool storeRemovePath(Store *store, StorePath *path)
+{
+	Store *parent = selectParent(store, path);
+	if(parent == NULL) {
+		return false;
+	}
+
+	Segment *segment = &path->segments[path->numSegments - 1];
+	if(segment->type == SEGMENT_KEY) {
+		return storeMapRemove(parent, segment->key->string);
+	}
+
+	return storeListRemove(parent, resolveIndex(parent, segment));
+}
+
+StorePathIterator *storeCreatePathIterator(Store *store, StorePath *path)
+{
+	StorePathIterator *iterator = storeAllocateMemoryType(StorePathIterator);
+	iterator->path = path;
+	iterator->levels = (IteratorLevel *) storeAllocateMemory((path->numSegments + 1) * sizeof(IteratorLevel));
+	iterator->levels[0].store = store;
+	iterator->levels[0].position = 0;
+	iterator->levels[0].link = NULL;
+	iterator->depth = 0;
+	return iterator;
+}
+
+Store *storePathIteratorNext(StorePathIterator *iterator)
+{
+	StorePath *path = iterator->path;
+
+	while(iterator->depth >= 0) {
+		int depth = iterator->depth;
+		IteratorLevel *level = &iterator->levels[depth];
+
+		if(depth == path->numSegments) {
+			// full match, backtrack for the next call
+			iterator->depth--;
+			return level->store;
+		}
+
+		Segment *segment = &path->segments[depth];
+		Store *child = NULL;
+		if(segment->type == SEGMENT_WILDCARD) {
+			child = selectNextChild(level);
+		} else if(level->position == 0) {
+			child = selectChild(level->store, segment, &level->element);
+			level->position++;
+		}
+
+		if(child == NULL) {
+			iterator->depth--;
+			continue;
+		}
+
+		IteratorLevel *childLevel = &iterator->levels[depth + 1];
+		childLevel->store = child;
+		childLevel->position = 0;
+		childLevel->link = NULL;
+		iterator->depth++;
+	}
+
+	return NULL;
+}
+
+void storeFreePathIterator(StorePathIterator *iterator)
+{
+	storeFreeMemory(iterator->levels);
+	storeFreeMemory(iterator);
+}
+
+/**
+ * Compiles a dot separated segment, which is either a key or a '*' wildcard
+ *
+ * @param input		the input to compile from
+ * @param segment	the segment to fill in
+ * @result			the remaining input after the segment, or NULL if the segment is malformed
+ */
+static const char *compileSegment(const char *input, Segment *segment)
+{
+	const char *end = input;
+	while(*end != '\0' && *end != '.' && *end != '[' && *end != ']') {
+		end++;
+	}
+
+	int length = end - input;
+	if(length == 0 || *end == ']') {
+		return NULL;
+	}
+
+	if(length == 1 && *input == '*') {
+		segment->type = SEGMENT_WILDCARD;
+		segment->key = NULL;
+		segment->index = 0;
+		return end;
+	}
+
+	GString *key = g_string_new_len(input, length);
+	segment->type = SEGMENT_KEY;
+	segment->key = storeCreateKey(key->str);
+	segment->index = 0;
+	g_string_free(key, true);
+	return end;
+}
+
+/**
+ * Compiles a segment in square brackets, which is either an index, a '*' wildcard or a quoted key
+ *
+ * @param input		the input after the opening bracket to compile from
+ * @param segment	the segment to fill in
+ * @result			the remaining input after the closing bracket, or NULL if the segment is malformed
+ */
+static const char *compileBracketSegment(const char *input, Segment *segment)
+{
+	segment->key = NULL;
+	segment->index = 0;
+
+	if(*input == '*') {
+		segment->type = SEGMENT_WILDCARD;
+		input++;
+	} else if(*input == '"') {
+		input++;
+
+		GString *key = g_string_new("");
+		while(*input != '"') {
+			if(*input == '\\' && (input[1] == '"' || input[1] == '\\')) {
+				input++;
+			} else if(*input == '\0') {
+				g_string_free(key, true);
+				return NULL;
+			}
+
+			g_string_append_c(key, *input);
+			input++;
+		}
+		input++;
+
+		segment->type = SEGMENT_KEY;
+		segment->key = storeCreateKey(key->str);
+		g_string_free(key, true);
+	} else {
+		const char *digits = *input == '-' ? input + 1 : input;
+		if(!isdigit(*digits)) {
+			return NULL;
+		}
+
+		char *end;
+		segment->type = SEGMENT_INDEX;
+		segment->index = strtol(input, &end, 10);
+		input = end;
+	}
+
+	if(*input != ']') {
+		if(segment->key != NULL) {
+			storeFreeKey(segment->key);
+		}
+		return NULL;
+	}
+
+	return input + 1;
+}
+
+static void appendSegment(StorePath *path, int *capacity, Segment *segment)
+{
+	if(path->numSegments == *capacity) {
+		int newCapacity = *capacity == 0 ? 4 : 2 * *capacity;
+		Segment *segments = (Segment *) storeAllocateMemory(newCapacity * sizeof(Segment));
+		if(path->segments != NULL) {
+			memcpy(segments, path->segments, path->numSegments * sizeof(Segment));
+			storeFreeMemory(path->segments);
+		}
+
+		path->segments = segments;
+		*capacity = newCapacity;
+	}
+
+	path->segments[path->numSegments] = *segment;
+	path->numSegments++;
+
+	if(segment->type == SEGMENT_WILDCARD) {
+		path->hasWildcard = true;
+	}
+}
+
+/**
+ * Selects the child of a store at a key or index segment
+ *
+ * @param store		the store to select the child of
+ * @param segment	the segment to select
+ * @param element	the buffer to return the child in if it is an element of a packed array
+ * @result			the selected child, or NULL if there is no such child
+ */
+static Store *selectChild(Store *store, Segment *segment, Store *element)
+{
+	switch(segment->type) {
+		case SEGMENT_KEY:
+			return storeMapGet(store, segment->key);
+		case SEGMENT_INDEX:
+		{
+			int length = storeListGetLength(store);
+			int index = segment->index < 0 ? length + segment->index : segment->index;
+			if(store->type == STORE_LIST) {
+				return storeListGet(store, index);
+			} else if(storeListGetElement(store, index, element)) {
+				return element;
+			}
+
+			return NULL;
+		}
+		default:
+			return NULL;
+	}
+}
+
+/**
+ * Selects the next child of a store at a wildcard segment
+ *
+ * @param level		the iteration state of the wildcard segment's depth
+ * @result			the next child, or NULL if all children have been visited
+ */
+static Store *selectNextChild(IteratorLevel *level)
+{
+	Store *store = level->store;
+
+	if(store->type == STORE_LIST) {
+		GList *link = level->position == 0 ? store->content.listValue->head : level->link;
+		if(link == NULL) {
+			return NULL;
+		}
+
+		level->link = link->next;
+		level->position++;
+		return (Store *) link->data;
+	} else if(store->type == STORE_MAP) {
+		StoreMapIterator mapIterator;
+		storeMapIteratorInit(&mapIterator, store);
+		mapIterator.index = level->position;
+
+		Store *value;
+		if(!storeMapIteratorNext(&mapIterator, NULL, &value)) {
+			return NULL;
+		}
+
+		level->position = mapIterator.index;
+		return value;
+	} else if(storeListGetElement(store, level->position, &level->element)) {
+		level->position++;
+		return &level->element;
+	}
+
+	return NULL;
+}
+
+/**
+ * Copies a store with the value at the given segments replaced, sharing all subtrees off the path
+ *
+ * @param store			the store to copy
+ * @param segments		the remaining segments of the path
+ * @param numSegments	the number of remaining segments
+ * @param value			the value to put at the end of the path, ownership is transferred unless NULL is returned
+ * @result				the copy of the store, or NULL if the segments don't lead to a replaceable value
+ */
+static Store *withValue(Store *store, Segment *segments, int numSegments, Store *value)
+{
+	if(numSegments == 0) {
+		return value;
+	}
+
+	Segment *segment = &segments[0];
+	if(segment->type == SEGMENT_KEY && store->type == STORE_MAP) {
+		Store *child = storeMapGet(store, segment->key);
+		if(child == NULL && numSegments > 1) {
+			return NULL;
+		}
+
+		Store *replacement = child == NULL ? value : withValue(child, segments + 1, numSegments - 1, value);
+		if(replacement == NULL) {
+			return NULL;
+		}
+
+		// the copy releases its reference to the replaced child
+		Store *copy = storeCopyShallow(store);
+		storeMapInsert(copy, segment->key->string, replacement);
+		return copy;
+	} else if(segment->type == SEGMENT_INDEX) {
+		int length = storeListGetLength(store);
+		int index = segment->index < 0 ? length + segment->index : segment->index;
+		if(index < 0 || index >= length) {
+			return NULL;
+		}
+
+		if(store->type != STORE_LIST) {
+			return numSegments == 1 ? withArrayElement(store, index, value) : NULL;
+		}
+
+		Store *replacement = withValue(storeListGet(store, index), segments + 1, numSegments - 1, value);
+		if(replacement == NULL) {
+			return NULL;
+		}
+
+		Store *copy = storeCopyShallow(store);
+		GList *link = g_queue_peek_nth_link(copy->content.listValue, index);
+		storeFree((Store *) link->data);
+		link->data = replacement;
+		return copy;
+	}
+
+	return NULL;
+}
+
+/**
+ * Copies a packed array with one element replaced
+ *
+ * @param store			the packed array store to copy
+ * @param index			the index of the element to replace, must be in bounds
+ * @param value			the new element, which is freed if the array is copied
+ * @result				the copy of the array, or NULL if the value is not of the array's element type
+ */
+static Store *withArrayElement(Store *store, int index, Store *value)
+{
+	if(store->type == STORE_INT_ARRAY && value->type == STORE_INT) {
+		Store *copy = storeCopyShallow(store);
+		copy->content.arrayValue->intValues[index] = value->content.intValue;
+		storeFree(value);
+		return copy;
+	} else if(store->type == STORE_FLOAT_ARRAY && value->type == STORE_FLOAT) {
+		Store *copy = storeCopyShallow(store);
+		copy->content.arrayValue->floatValues[index] = value->content.floatValue;
+		storeFree(value);
+		return copy;
+	}
+
+	return NULL;
+}
+
+/**
+ * Selects the store containing the value at a path, to be modified in place
+ *
+ * @param store			the store to query
+ * @param path			the path to select the parent of
+ * @result				the parent, or NULL if the path is empty, contains wildcards, doesn't lead to a map or list, or
+ *						passes through a store that is frozen or shared, since modifying any descendant of such a store
+ *						would modify it for all of its owners
+ */
+static Store *selectParent(Store *store, StorePath *path)
+{
+	if(path->hasWildcard || path->numSegments == 0) {
+		return NULL;
+	}
+
+	for(int i = 0; i < path->numSegments - 1 && store != NULL; i++) {
+		if(!isModifiable(store)) {
+			return NULL;
+		}
+
+		store = selectChild(store, &path->segments[i], &path->element);
+	}
+
+	// elements of packed arrays are only copies in the path's buffer
+	if(store == NULL || store == &path->element || !isModifiable(store)) {
+		return NULL;
+	}
+
+	return store;
+}
+
+/**
+ * Returns whether a store may be modified in place, i.e. it is neither frozen nor shared with other owners
+ */
+static bool isModifiable(Store *store)
+{
+	if(store->references > 1 || storeMapIsFrozen(store) || storeListIsFrozen(store)) {
+		return false;
+	}
+
+	return (store->type != STORE_INT_ARRAY && store->type != STORE_FLOAT_ARRAY) || !store->content.arrayValue->frozen;
+}
+
+/**
+ * Resolves the index of an index segment in a list, counting negative indices from its end
+ */
+static int resolveIndex(Store *store, Segment *segment)
+{
+	return segment->index < 0 ? storeListGetLength(store) + segment->index : segment->index;
+}
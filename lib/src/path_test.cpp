@@ -0,0 +1,296 @@
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/dedup.h>
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "path.c"
+
+class Path: public ::testing::Test {
+public:
+	virtual void SetUp() {
+		parser = storeCreateParser();
+		store = storeParse(parser, "servers = [{name = alpha, tls = {cert = \"a.pem\"}} {name = beta, tls = {cert = \"b.pem\"}} {name = gamma}]; \"dotted.key\" = 42; items = {x = {id = 1}, y = {id = 2}}; series = [1 2 3]");
+		ASSERT_TRUE(store != NULL) << "test store should parse successfully";
+	}
+
+	virtual void TearDown() {
+		storeFree(store);
+		storeFreeParser(parser);
+	}
+
+protected:
+	Store *getPath(const char *pathString) {
+		StorePath *path = storeCompilePath(pathString);
+		EXPECT_TRUE(path != NULL) << "path '" << pathString << "' should compile";
+		if(path == NULL) {
+			return NULL;
+		}
+
+		Store *result = storeGetPath(store, path);
+		storeFreePath(path);
+		return result;
+	}
+
+	StoreParser *parser;
+	Store *store;
+};
+
+TEST_F(Path, compileInvalid)
+{
+	const char *invalid[] = {".a", "a.", "a..b", "a.[0]", "a[", "a[x]", "a[0", "a]", "a[\"unterminated]", "a[0]b"};
+
+	for(const char *pathString : invalid) {
+		StorePath *path = storeCompilePath(pathString);
+		ASSERT_TRUE(path == NULL) << "path '" << pathString << "' should fail to compile";
+	}
+}
+
+TEST_F(Path, getEmpty)
+{
+	ASSERT_EQ(getPath(""), store) << "empty path should select the root store";
+}
+
+TEST_F(Path, getKeys)
+{
+	Store *result = getPath("servers[1].tls.cert");
+	ASSERT_TRUE(result != NULL) << "existing path should be found";
+	ASSERT_EQ(result->type, STORE_STRING) << "selected value should be a string";
+	ASSERT_STREQ(result->content.stringValue, "b.pem") << "selected value should be correct";
+}
+
+TEST_F(Path, getNegativeIndex)
+{
+	Store *result = getPath("servers[-1].name");
+	ASSERT_TRUE(result != NULL) << "negative index should select from the end of the list";
+	ASSERT_STREQ(result->content.stringValue, "gamma") << "selected value should be correct";
+}
+
+TEST_F(Path, getQuotedKey)
+{
+	Store *result = getPath("[\"dotted.key\"]");
+	ASSERT_TRUE(result != NULL) << "quoted key should be found";
+	ASSERT_EQ(result->type, STORE_INT) << "selected value should be an int";
+	ASSERT_EQ(result->content.intValue, 42) << "selected value should be correct";
+}
+
+TEST_F(Path, getMissing)
+{
+	ASSERT_TRUE(getPath("servers[3].name") == NULL) << "out of bounds index should not be found";
+	ASSERT_TRUE(getPath("servers[2].tls.cert") == NULL) << "missing key should not be found";
+	ASSERT_TRUE(getPath("servers.name") == NULL) << "key in a list should not be found";
+	ASSERT_TRUE(getPath("[\"dotted.key\"][0]") == NULL) << "index in an int should not be found";
+}
+
+TEST_F(Path, iterateListWildcard)
+{
+	StorePath *path = storeCompilePath("servers[*].tls.cert");
+	ASSERT_TRUE(path != NULL) << "wildcard path should compile";
+
+	const char *solution[] = {"a.pem", "b.pem"};
+
+	int i = 0;
+	StorePathIterator *iterator = storeCreatePathIterator(store, path);
+	for(Store *result = storePathIteratorNext(iterator); result != NULL; result = storePathIteratorNext(iterator)) {
+		ASSERT_LT(i, 2) << "wildcard path should match exactly two values";
+		ASSERT_STREQ(result->content.stringValue, solution[i]) << "wildcard matches should be returned in document order";
+		i++;
+	}
+	ASSERT_EQ(i, 2) << "wildcard path should match exactly two values";
+	ASSERT_TRUE(storePathIteratorNext(iterator) == NULL) << "finished iterator should keep returning NULL";
+
+	storeFreePathIterator(iterator);
+	storeFreePath(path);
+}
+
+TEST_F(Path, iterateMapWildcard)
+{
+	StorePath *path = storeCompilePath("items.*.id");
+	ASSERT_TRUE(path != NULL) << "wildcard path should compile";
+
+	int i = 0;
+	StorePathIterator *iterator = storeCreatePathIterator(store, path);
+	for(Store *result = storePathIteratorNext(iterator); result != NULL; result = storePathIteratorNext(iterator)) {
+		i++;
+		ASSERT_EQ(result->content.intValue, i) << "wildcard matches should be returned in insertion order";
+	}
+	ASSERT_EQ(i, 2) << "wildcard path should match exactly two values";
+
+	storeFreePathIterator(iterator);
+
+	Store *first = storeGetPath(store, path);
+	ASSERT_TRUE(first != NULL) << "looking up a wildcard path should return the first match";
+	ASSERT_EQ(first->content.intValue, 1) << "looking up a wildcard path should return the first match";
+
+	storeFreePath(path);
+}
+
+TEST_F(Path, packedArray)
+{
+	ASSERT_TRUE(storeListPack(storeMapLookup(store, "series"))) << "int list should be packed";
+
+	StorePath *path = storeCompilePath("series[-1]");
+	Store *result = storeGetPath(store, path);
+	ASSERT_TRUE(result != NULL) << "packed array element should be found";
+	ASSERT_EQ(result->type, STORE_INT) << "packed array element should be an int";
+	ASSERT_EQ(result->content.intValue, 3) << "packed array element should be correct";
+	storeFreePath(path);
+
+	ASSERT_TRUE(getPath("series[3]") == NULL) << "out of bounds packed array element should not be found";
+
+	path = storeCompilePath("series[*]");
+	ASSERT_TRUE(path != NULL) << "wildcard path should compile";
+
+	int i = 0;
+	StorePathIterator *iterator = storeCreatePathIterator(store, path);
+	for(Store *result = storePathIteratorNext(iterator); result != NULL; result = storePathIteratorNext(iterator)) {
+		i++;
+		ASSERT_EQ(result->content.intValue, i) << "wildcard matches should be returned in array order";
+	}
+	ASSERT_EQ(i, 3) << "wildcard path should match every array element";
+	storeFreePathIterator(iterator);
+
+	Store *first = storeGetPath(store, path);
+	ASSERT_TRUE(first != NULL) << "looking up a wildcard path should return the first match";
+	ASSERT_EQ(first->content.intValue, 1) << "looking up a wildcard path should return the first match";
+
+	storeFreePath(path);
+}
+
+TEST_F(Path, with)
+{
+	StorePath *path = storeCompilePath("servers[1].tls.cert");
+	Store *version = storeWith(store, path, storeCreateStringValue("c.pem"));
+	ASSERT_TRUE(version != NULL) << "replacing an existing value should succeed";
+	ASSERT_STREQ(storeGetPath(version, path)->content.stringValue, "c.pem") << "new version should contain the new value";
+	ASSERT_STREQ(storeGetPath(store, path)->content.stringValue, "b.pem") << "old version should be unchanged";
+	storeFreePath(path);
+
+	Store *servers = storeMapLookup(store, "servers");
+	Store *newServers = storeMapLookup(version, "servers");
+	ASSERT_NE(servers, newServers) << "stores along the path should be copied";
+	ASSERT_EQ(storeListGet(servers, 0), storeListGet(newServers, 0)) << "stores off the path should be shared";
+	ASSERT_EQ(storeMapLookup(store, "items"), storeMapLookup(version, "items")) << "stores off the path should be shared";
+	ASSERT_EQ(storeMapLookup(store, "items")->references, 2u) << "shared stores should be referenced by both versions";
+	ASSERT_FALSE(storeMapRemove(storeMapLookup(version, "items"), "x")) << "shared stores should not be modifiable";
+	ASSERT_TRUE(storeMapRemove(storeListGet(newServers, 1), "name")) << "copied stores should be modifiable";
+
+	path = storeCompilePath("servers[2].tls");
+	Store *inserted = storeWith(version, path, storeCreateMapValue());
+	ASSERT_TRUE(inserted != NULL) << "inserting a missing key should succeed";
+	ASSERT_EQ(storeGetPath(inserted, path)->type, STORE_MAP) << "new version should contain the inserted value";
+	ASSERT_TRUE(storeGetPath(version, path) == NULL) << "old version should not contain the inserted value";
+	storeFreePath(path);
+
+	Store *value = storeCreateIntValue(1);
+	path = storeCompilePath("servers[2].tls.cert");
+	ASSERT_TRUE(storeWith(version, path, value) == NULL) << "inserting below a missing key should fail";
+	storeFreePath(path);
+	path = storeCompilePath("servers[3]");
+	ASSERT_TRUE(storeWith(version, path, value) == NULL) << "replacing an out of bounds element should fail";
+	storeFreePath(path);
+	storeFree(value);
+
+	storeFree(version);
+	storeFree(inserted);
+	ASSERT_EQ(storeMapLookup(store, "items")->references, 1u) << "freeing the other versions should release their references";
+}
+
+TEST_F(Path, withPackedArray)
+{
+	storeListPack(storeMapLookup(store, "series"));
+
+	StorePath *path = storeCompilePath("series[0]");
+	Store *value = storeCreateFloatValue(1.5);
+	ASSERT_TRUE(storeWith(store, path, value) == NULL) << "replacing an int array element with a float should fail";
+	storeFree(value);
+
+	Store *version = storeWith(store, path, storeCreateIntValue(7));
+	ASSERT_TRUE(version != NULL) << "replacing an int array element with an int should succeed";
+	ASSERT_EQ(storeListGetInt(storeMapLookup(version, "series"), 0, 0), 7) << "new version should contain the new element";
+	ASSERT_EQ(storeListGetInt(storeMapLookup(store, "series"), 0, 0), 1) << "old version should be unchanged";
+
+	storeFree(version);
+	storeFreePath(path);
+}
+
+TEST_F(Path, modifyInPlace)
+{
+	StorePath *path = storeCompilePath("servers[1].tls.cert");
+	ASSERT_TRUE(storeSetPath(store, path, storeCreateStringValue("c.pem"))) << "replacing an existing value should succeed";
+	ASSERT_STREQ(getPath("servers[1].tls.cert")->content.stringValue, "c.pem") << "store should contain the new value";
+	storeFreePath(path);
+
+	path = storeCompilePath("servers[1]");
+	ASSERT_TRUE(storeInsertPath(store, path, storeCreateMapValue())) << "inserting a list element should succeed";
+	ASSERT_EQ(storeMapGetSize(getPath("servers[1]")), 0) << "store should contain the inserted element";
+	ASSERT_STREQ(getPath("servers[2].name")->content.stringValue, "beta") << "following elements should be shifted";
+	ASSERT_TRUE(storeRemovePath(store, path)) << "removing a list element should succeed";
+	ASSERT_STREQ(getPath("servers[1].name")->content.stringValue, "beta") << "following elements should be shifted back";
+	storeFreePath(path);
+
+	path = storeCompilePath("servers[2].tls");
+	ASSERT_TRUE(storeInsertPath(store, path, storeCreateMapValue())) << "inserting a missing key should succeed";
+	Store *value = storeCreateMapValue();
+	ASSERT_FALSE(storeInsertPath(store, path, value)) << "inserting an existing key should fail";
+	ASSERT_TRUE(storeRemovePath(store, path)) << "removing an existing key should succeed";
+	ASSERT_FALSE(storeRemovePath(store, path)) << "removing a missing key should fail";
+	storeFree(value);
+	storeFreePath(path);
+
+	path = storeCompilePath("");
+	ASSERT_TRUE(storeSetPath(store, path, storeCreateStringValue("replaced"))) << "replacing the root should succeed";
+	ASSERT_STREQ(store->content.stringValue, "replaced") << "root should contain the new value";
+	storeFreePath(path);
+}
+
+TEST_F(Path, modifyFrozen)
+{
+	storeFreeze(store);
+
+	StorePath *path = storeCompilePath("series[1]");
+	Store *value = storeCreateIntValue(7);
+	ASSERT_FALSE(storeSetPath(store, path, value)) << "replacing an element of a frozen packed array should fail";
+	ASSERT_EQ(getPath("series[1]")->content.intValue, 2) << "frozen packed array should be unchanged";
+	storeFreePath(path);
+
+	path = storeCompilePath("items.x.id");
+	ASSERT_FALSE(storeSetPath(store, path, value)) << "replacing a value below a frozen map should fail";
+	ASSERT_EQ(getPath("items.x.id")->content.intValue, 1) << "frozen map should be unchanged";
+	storeFreePath(path);
+
+	path = storeCompilePath("");
+	ASSERT_FALSE(storeSetPath(store, path, value)) << "replacing the content of a frozen root should fail";
+	ASSERT_EQ(store->type, STORE_MAP) << "frozen root should be unchanged";
+	storeFreePath(path);
+
+	storeFree(value);
+}
+
+TEST_F(Path, modifyShared)
+{
+	Store *shared = storeParse(parser, "a = {x = {v = 1}, y = 0}; b = {x = {v = 1}}");
+	ASSERT_TRUE(shared != NULL) << "test store should parse successfully";
+	storeDeduplicate(shared);
+
+	StorePath *path = storeCompilePath("a.x.v");
+	Store *value = storeCreateIntValue(9);
+	ASSERT_FALSE(storeSetPath(shared, path, value)) << "replacing a value below a shared map should fail";
+	ASSERT_FALSE(storeInsertPath(shared, path, value)) << "inserting below a shared map should fail";
+	ASSERT_FALSE(storeRemovePath(shared, path)) << "removing below a shared map should fail";
+	storeFree(value);
+	storeFreePath(path);
+
+	path = storeCompilePath("b.x.v");
+	ASSERT_EQ(storeGetPath(shared, path)->content.intValue, 1) << "other owner of the shared map should be unchanged";
+	storeFreePath(path);
+
+	path = storeCompilePath("a.y");
+	ASSERT_TRUE(storeSetPath(shared, path, storeCreateIntValue(2))) << "modifying an unshared map should still succeed";
+	storeFreePath(path);
+
+	storeFree(shared);
+}
@@ -0,0 +1,521 @@
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL size_t
+#include <stdint.h> // uint32_t
+#include <stdlib.h> // atof atoi
+#include <string.h> // memcpy
+
+#include <glib.h>
+
+#include "store/encoding.h"
+#include "store/memory.h"
+#include "store/reader.h"
+#include "store/syntax.h"
+
+/**
+ * The maximum number of nested lists and maps, see STORE_MAX_PARSE_DEPTH
+ */
+static const int maxContainers = STORE_MAX_PARSE_DEPTH / 3 + 1;
+
+typedef struct {
+	/** The character closing the list or map, or '\0' for the entries of the input that are closed by its end */
+	char closing;
+	/** The depth of the parse state the parser would parse the list or map with, see parseList and parseMap */
+	int depth;
+} Container;
+
+struct StoreReaderStruct {
+	const char *data;
+	size_t length;
+	/** The position after the last token read */
+	size_t position;
+	/** The lists and maps enclosing the position, the innermost one last */
+	Container *containers;
+	int numContainers;
+	bool started;
+	/** Whether the next token begins the value of an entry whose key was read last */
+	bool expectingValue;
+	bool finished;
+	bool failed;
+	size_t errorOffset;
+};
+
+static bool readStart(StoreReader *reader, StoreToken *token);
+static bool readKey(StoreReader *reader, StoreToken *token);
+static bool readValue(StoreReader *reader, StoreToken *token);
+static bool readEnd(StoreReader *reader, StoreToken *token, size_t position);
+static bool skipContainer(StoreReader *reader);
+static bool finish(StoreReader *reader);
+static void pushContainer(StoreReader *reader, char closing, int depth);
+static int getNestedDepth(StoreReader *reader);
+static bool scanShortString(StoreReader *reader, size_t *position, StoreToken *token);
+static bool scanLongString(StoreReader *reader, size_t *position, StoreToken *token);
+static void classifyShortString(StoreToken *token);
+static void initToken(StoreToken *token, StoreTokenType type, size_t offset);
+static size_t skipTerminals(StoreReader *reader, size_t position);
+static char peek(StoreReader *reader, size_t position);
+static bool fail(StoreReader *reader, size_t position);
+
+StoreReader *storeCreateReader(const char *data, size_t length)
+{
+	StoreReader *reader = storeAllocateMemoryType(StoreReader);
+	reader->data = data;
+	reader->length = length;
+	reader->position = 0;
+	reader->containers = (Container *) storeAllocateMemory(maxContainers * sizeof(Container));
+	reader->numContainers = 0;
+	reader->started = false;
+	reader->expectingValue = false;
+	reader->finished = false;
+	reader->failed = false;
+	reader->errorOffset = 0;
+	return reader;
+}
+
+void storeFreeReader(StoreReader *reader)
+{
+	storeFreeMemory(reader->containers);
+	storeFreeMemory(reader);
+}
+
+bool storeReaderNext(StoreReader *reader, StoreToken *token)
+{
+	if(reader->failed || reader->finished) {
+		return false;
+	}
+
+	if(!reader->started) {
+		reader->started = true;
+		return readStart(reader, token);
+	}
+
+	if(reader->expectingValue) {
+		reader->expectingValue = false;
+		return readValue(reader, token);
+	}
+
+	if(reader->numContainers == 0) {
+		// the value making up the whole input was read
+		return finish(reader);
+	}
+
+	Container *container = &reader->containers[reader->numContainers - 1];
+	size_t position = skipTerminals(reader, reader->position);
+	if(container->closing == '\0' && position == reader->length) {
+		reader->numContainers--;
+		reader->position = position;
+		reader->finished = true;
+		initToken(token, STORE_TOKEN_MAP_END, position);
+		return true;
+	} else if(container->closing != '\0' && peek(reader, position) == container->closing) {
+		return readEnd(reader, token, position);
+	}
+
+	if(container->closing == '}' || container->closing == '\0') {
+		return readKey(reader, token);
+	} else {
+		return readValue(reader, token);
+	}
+}
+
+bool storeReaderSkipValue(StoreReader *reader)
+{
+	if(reader->failed || reader->finished) {
+		return false;
+	}
+
+	// don't consume the end of the enclosing list or map
+	if(reader->started && !reader->expectingValue) {
+		if(reader->numContainers == 0) {
+			return false;
+		}
+
+		Container *container = &reader->containers[reader->numContainers - 1];
+		size_t position = skipTerminals(reader, reader->position);
+		if(container->closing == '\0' ? position == reader->length : peek(reader, position) == container->closing) {
+			return false;
+		}
+	}
+
+	StoreToken token;
+	if(!storeReaderNext(reader, &token)) {
+		return false;
+	}
+
+	switch(token.type) {
+		case STORE_TOKEN_KEY:
+			return storeReaderSkipValue(reader);
+		case STORE_TOKEN_MAP_BEGIN:
+		case STORE_TOKEN_LIST_BEGIN:
+			return skipContainer(reader);
+		default:
+			return true;
+	}
+}
+
+bool storeReaderHasFailed(StoreReader *reader, size_t *errorOffset)
+{
+	if(reader->failed && errorOffset != NULL) {
+		*errorOffset = reader->errorOffset;
+	}
+
+	return reader->failed;
+}
+
+char *storeCopyTokenString(const StoreToken *token)
+{
+	if(!token->escaped) {
+		GString *copy = g_string_new_len(token->string, token->length);
+		return g_string_free(copy, false);
+	}
+
+	GString *copy = g_string_new("");
+	for(size_t i = 0; i < token->length; i++) {
+		char c = token->string[i];
+		if(c != '\\') {
+			g_string_append_c(copy, c);
+			continue;
+		}
+
+		// the escape sequences were checked while reading the token
+		size_t position = i;
+		uint32_t codepoint;
+		storeScanEscapeSequence(token->string, token->length, &position, &codepoint);
+		i = position - 1;
+
+		GString *utf8 = storeConvertUnicodeToUtf8(codepoint);
+		g_string_append(copy, utf8->str);
+		g_string_free(utf8, true);
+	}
+
+	return g_string_free(copy, false);
+}
+
+/**
+ * Reads the first token of the input. Like the parser, the input is read as a single value if that value makes up the
+ * whole input, and as entries otherwise. Only a string can be both the first key and the whole input, so it is scanned
+ * ahead to see whether an entry separator follows.
+ */
+static bool readStart(StoreReader *reader, StoreToken *token)
+{
+	size_t position = skipTerminals(reader, 0);
+	char c = peek(reader, position);
+	bool isEntries = position == reader->length;
+
+	if(!isEntries && (c == '"' || !storeIsSeparatorCharacter(c))) {
+		StoreToken key;
+		size_t end = position;
+		bool scanned = c == '"' ? scanLongString(reader, &end, &key) : scanShortString(reader, &end, &key);
+		if(scanned) {
+			char next = peek(reader, skipTerminals(reader, end));
+			isEntries = next == ':' || next == '=';
+		}
+	}
+
+	if(isEntries) {
+		// the parser parses the entries of the input two parse states deeper than its initial one
+		pushContainer(reader, '\0', 1);
+		initToken(token, STORE_TOKEN_MAP_BEGIN, 0);
+		return true;
+	}
+
+	return readValue(reader, token);
+}
+
+/**
+ * Reads the key of an entry and the entry separator following it, see parseEntry
+ */
+static bool readKey(StoreReader *reader, StoreToken *token)
+{
+	size_t position = skipTerminals(reader, reader->position);
+	char c = peek(reader, position);
+	if(c == '\0') {
+		return fail(reader, position);
+	}
+
+	initToken(token, STORE_TOKEN_KEY, position);
+	bool scanned = c == '"' ? scanLongString(reader, &position, token) : scanShortString(reader, &position, token);
+	if(!scanned) {
+		return fail(reader, position);
+	}
+
+	position = skipTerminals(reader, position);
+	c = peek(reader, position);
+	if(c != ':' && c != '=') {
+		return fail(reader, position);
+	}
+
+	reader->position = position + 1;
+	reader->expectingValue = true;
+	return true;
+}
+
+/**
+ * Reads a value, or the beginning of it if it is a list or map, see parseValue
+ */
+static bool readValue(StoreReader *reader, StoreToken *token)
+{
+	size_t position = skipTerminals(reader, reader->position);
+	char c = peek(reader, position);
+	if(c == '\0') {
+		return fail(reader, position);
+	}
+
+	if(c == '(' || c == '[' || c == '{') {
+		int depth = getNestedDepth(reader);
+		if(depth >= STORE_MAX_PARSE_DEPTH) {
+			return fail(reader, position);
+		}
+
+		pushContainer(reader, c == '(' ? ')' : c == '[' ? ']' : '}', depth);
+		reader->position = position + 1;
+		initToken(token, c == '{' ? STORE_TOKEN_MAP_BEGIN : STORE_TOKEN_LIST_BEGIN, position);
+		return true;
+	}
+
+	initToken(token, STORE_TOKEN_STRING, position);
+	if(c == '"') {
+		if(!scanLongString(reader, &position, token)) {
+			return fail(reader, position);
+		}
+	} else {
+		if(!scanShortString(reader, &position, token)) {
+			return fail(reader, position);
+		}
+
+		classifyShortString(token);
+	}
+
+	if(!storeIsSeparatorCharacter(peek(reader, position))) {
+		return fail(reader, position);
+	}
+
+	reader->position = position;
+	return true;
+}
+
+/**
+ * Reads the closing character of the innermost list or map at a position
+ */
+static bool readEnd(StoreReader *reader, StoreToken *token, size_t position)
+{
+	char closing = reader->containers[reader->numContainers - 1].closing;
+	if(!storeIsSeparatorCharacter(peek(reader, position + 1))) {
+		return fail(reader, position + 1);
+	}
+
+	reader->numContainers--;
+	reader->position = position + 1;
+	initToken(token, closing == '}' ? STORE_TOKEN_MAP_END : STORE_TOKEN_LIST_END, position);
+	return true;
+}
+
+/**
+ * Skips the rest of the innermost list or map including its end by balancing brackets
+ */
+static bool skipContainer(StoreReader *reader)
+{
+	char closing = reader->containers[reader->numContainers - 1].closing;
+	int balance = 0;
+
+	for(size_t position = reader->position; position < reader->length; position++) {
+		switch(reader->data[position]) {
+			case '"':
+				for(position++; position < reader->length && reader->data[position] != '"'; position++) {
+					if(reader->data[position] == '\\') {
+						position++;
+					}
+				}
+
+				if(position >= reader->length) {
+					return fail(reader, reader->length);
+				}
+			break;
+			case '(':
+			case '[':
+			case '{':
+				balance++;
+			break;
+			case ')':
+			case ']':
+			case '}':
+				if(balance > 0) {
+					balance--;
+				} else if(reader->data[position] == closing) {
+					StoreToken token;
+					return readEnd(reader, &token, position);
+				} else {
+					return fail(reader, position);
+				}
+			break;
+			case '\0':
+				return fail(reader, position);
+			break;
+		}
+	}
+
+	if(closing != '\0' || balance > 0) {
+		return fail(reader, reader->length);
+	}
+
+	reader->numContainers--;
+	reader->position = reader->length;
+	reader->finished = true;
+	return true;
+}
+
+/**
+ * Checks that nothing but terminals follows the value making up the whole input
+ *
+ * @result				always false
+ */
+static bool finish(StoreReader *reader)
+{
+	size_t position = skipTerminals(reader, reader->position);
+	if(position != reader->length) {
+		return fail(reader, position);
+	}
+
+	reader->position = position;
+	reader->finished = true;
+	return false;
+}
+
+static void pushContainer(StoreReader *reader, char closing, int depth)
+{
+	Container *container = &reader->containers[reader->numContainers++];
+	container->closing = closing;
+	container->depth = depth;
+}
+
+/**
+ * Returns the depth of the parse state the parser would parse a list or map at the position with
+ */
+static int getNestedDepth(StoreReader *reader)
+{
+	if(reader->numContainers == 0) {
+		// store, value, list or map
+		return 3;
+	}
+
+	Container *container = &reader->containers[reader->numContainers - 1];
+	if(container->closing == '}' || container->closing == '\0') {
+		// entries, entry, value, list or map
+		return container->depth + 4;
+	} else {
+		// elements, value, list or map
+		return container->depth + 3;
+	}
+}
+
+/**
+ * Scans a short string, see parseShortString
+ *
+ * @param reader		the reader to scan with
+ * @param position		pointer to the position of the string, which is advanced past it on success or set to the
+ *						position of the error on failure
+ * @param token			the token to point to the characters of the string
+ * @result				true if a string was scanned
+ */
+static bool scanShortString(StoreReader *reader, size_t *position, StoreToken *token)
+{
+	size_t start = *position;
+	if(!storeScanShortString(reader->data, reader->length, position)) {
+		return false;
+	}
+
+	token->string = reader->data + start;
+	token->length = *position - start;
+	token->escaped = false;
+	return true;
+}
+
+/**
+ * Scans a long string including its delimiters and checks its escape sequences, see parseLongString
+ *
+ * @param reader		the reader to scan with
+ * @param position		pointer to the position of the opening delimiter, which is advanced past the closing one on
+ *						success or set to the position of the error on failure
+ * @param token			the token to point to the characters of the string
+ * @result				true if a string was scanned
+ */
+static bool scanLongString(StoreReader *reader, size_t *position, StoreToken *token)
+{
+	size_t start = *position;
+	if(!storeScanLongString(reader->data, reader->length, position, &token->escaped)) {
+		return false;
+	}
+
+	// without the delimiters
+	token->string = reader->data + start + 1;
+	token->length = *position - start - 2;
+	return true;
+}
+
+/**
+ * Turns a short string value token into an int or float token if the parser would parse it as one, see parseInt and
+ * parseFloat
+ */
+static void classifyShortString(StoreToken *token)
+{
+	const char *string = token->string;
+	size_t length = token->length;
+
+	StoreTokenType type;
+	if(storeScanInt(string, length, 0) == length) {
+		type = STORE_TOKEN_INT;
+	} else if(storeScanFloat(string, length, 0) == length) {
+		type = STORE_TOKEN_FLOAT;
+	} else {
+		return;
+	}
+
+	// the input doesn't have to be null terminated, so convert a copy like the parser does
+	char buffer[64];
+	char *number = length < sizeof(buffer) ? buffer : (char *) storeAllocateMemory((int) length + 1);
+	memcpy(number, string, length);
+	number[length] = '\0';
+
+	token->type = type;
+	if(type == STORE_TOKEN_INT) {
+		token->intValue = atoi(number);
+	} else {
+		token->floatValue = atof(number);
+	}
+
+	if(number != buffer) {
+		storeFreeMemory(number);
+	}
+}
+
+static void initToken(StoreToken *token, StoreTokenType type, size_t offset)
+{
+	token->type = type;
+	token->offset = offset;
+	token->string = NULL;
+	token->length = 0;
+	token->escaped = false;
+	token->intValue = 0;
+	token->floatValue = 0.0;
+}
+
+static size_t skipTerminals(StoreReader *reader, size_t position)
+{
+	return storeSkipTerminalCharacters(reader->data, reader->length, position);
+}
+
+static char peek(StoreReader *reader, size_t position)
+{
+	return storePeekCharacter(reader->data, reader->length, position);
+}
+
+/**
+ * Stops reading because the input is malformed at a position
+ *
+ * @result				always false
+ */
+static bool fail(StoreReader *reader, size_t position)
+{
+	reader->failed = true;
+	reader->errorOffset = position;
+	return false;
+}
@@ -0,0 +1,277 @@
+#include <cstring>
+#include <string>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/compare.h>
+	#include <store/list.h>
+	#include <store/map.h>
+	#include <store/parser.h>
+	#include <store/store.h>
+	#include <store/syntax.h>
+}
+
+#include "reader.c"
+
+static const char *inputs[] = {
+	"",
+	"   ,; ",
+	"1",
+	"-1",
+	"-",
+	"1.",
+	"1.5e-3",
+	"1e",
+	"1e+",
+	"12ab",
+	"hello",
+	"\"long \\\"string\\\" with \\u00e4, \\/ and \\n\"",
+	"\"unterminated",
+	"\"bad \\x escape\"",
+	"\"surrogate \\ud800\"",
+	"\"a\"b",
+	"a = 1",
+	"a : 1; b = 2, c = three; a = 4",
+	"a = 1 }",
+	"a = 1 b",
+	"a =",
+	"= 1",
+	"a b",
+	"\"quoted key\" = [1 2 (3 4)]",
+	"[1 2 3",
+	"[1 2 3)",
+	"[1 2 3] x",
+	"[1 2 3]x",
+	"{a = {b = {}}}",
+	"{a = 1",
+	"{a 1}",
+	"a = {b = [1 {c = \"d\"}]}; e = []",
+	"[{] }",
+	")",
+	"a = 1]",
+};
+
+static Store *readStore(StoreReader *reader, StoreToken *token);
+
+/**
+ * Builds the store of the value starting with the given token from the following tokens
+ */
+static Store *readStore(StoreReader *reader, StoreToken *token)
+{
+	switch(token->type) {
+		case STORE_TOKEN_INT:
+			return storeCreateIntValue(token->intValue);
+		case STORE_TOKEN_FLOAT:
+			return storeCreateFloatValue(token->floatValue);
+		case STORE_TOKEN_STRING:
+		{
+			char *string = storeCopyTokenString(token);
+			Store *store = storeCreateStringValue(string);
+			free(string);
+			return store;
+		}
+		case STORE_TOKEN_LIST_BEGIN:
+		{
+			Store *list = storeCreateListValue();
+			StoreToken element;
+			while(storeReaderNext(reader, &element) && element.type != STORE_TOKEN_LIST_END) {
+				Store *value = readStore(reader, &element);
+				if(value == NULL) {
+					break;
+				}
+
+				storeListAppend(list, value);
+			}
+
+			if(storeReaderHasFailed(reader, NULL)) {
+				storeFree(list);
+				return NULL;
+			}
+
+			return list;
+		}
+		case STORE_TOKEN_MAP_BEGIN:
+		{
+			Store *map = storeCreateMapValue();
+			StoreToken key;
+			while(storeReaderNext(reader, &key) && key.type == STORE_TOKEN_KEY) {
+				char *keyString = storeCopyTokenString(&key);
+				StoreToken valueToken;
+				Store *value = storeReaderNext(reader, &valueToken) ? readStore(reader, &valueToken) : NULL;
+				if(value == NULL) {
+					free(keyString);
+					break;
+				}
+
+				storeMapInsert(map, keyString, value);
+				free(keyString);
+			}
+
+			if(storeReaderHasFailed(reader, NULL)) {
+				storeFree(map);
+				return NULL;
+			}
+
+			return map;
+		}
+		default:
+			return NULL;
+	}
+}
+
+static Store *readAll(const std::string& input)
+{
+	StoreReader *reader = storeCreateReader(input.data(), input.size());
+	StoreToken token;
+	Store *store = storeReaderNext(reader, &token) ? readStore(reader, &token) : NULL;
+	if(store != NULL && (storeReaderNext(reader, &token) || storeReaderHasFailed(reader, NULL))) {
+		storeFree(store);
+		store = NULL;
+	}
+
+	storeFreeReader(reader);
+	return store;
+}
+
+static std::string nest(const char *opening, const char *inner, const char *closing, int levels)
+{
+	std::string result = inner;
+	for(int i = 0; i < levels; i++) {
+		result = opening + result + closing;
+	}
+
+	return result;
+}
+
+static void expectReadLikeParsed(const std::string& input)
+{
+	StoreParser *parser = storeCreateParser();
+	Store *parsed = storeParse(parser, input.c_str());
+	Store *read = readAll(input);
+
+	ASSERT_EQ(read != NULL, parsed != NULL) << "reading '" << input.substr(0, 100) << "' should succeed exactly if parsing it does";
+	if(parsed != NULL) {
+		ASSERT_TRUE(storeEquals(read, parsed)) << "reading '" << input.substr(0, 100) << "' should yield the parsed store";
+		storeFree(read);
+		storeFree(parsed);
+	}
+
+	storeFreeParser(parser);
+}
+
+TEST(Reader, tokens)
+{
+	const char *input = "a = [1 2.5 x]; \"b\\n\" = {c = \"d\"}";
+	StoreReader *reader = storeCreateReader(input, strlen(input));
+
+	StoreTokenType expectedTypes[] = {STORE_TOKEN_MAP_BEGIN, STORE_TOKEN_KEY, STORE_TOKEN_LIST_BEGIN, STORE_TOKEN_INT, STORE_TOKEN_FLOAT, STORE_TOKEN_STRING, STORE_TOKEN_LIST_END, STORE_TOKEN_KEY, STORE_TOKEN_MAP_BEGIN, STORE_TOKEN_KEY, STORE_TOKEN_STRING, STORE_TOKEN_MAP_END, STORE_TOKEN_MAP_END};
+	StoreToken tokens[13];
+	for(int i = 0; i < 13; i++) {
+		ASSERT_TRUE(storeReaderNext(reader, &tokens[i])) << "token " << i << " should be read";
+		ASSERT_EQ(tokens[i].type, expectedTypes[i]) << "token " << i << " should have the expected type";
+	}
+
+	StoreToken token;
+	ASSERT_FALSE(storeReaderNext(reader, &token)) << "reading should end after the last token";
+	ASSERT_FALSE(storeReaderHasFailed(reader, NULL)) << "reading should not have failed";
+
+	ASSERT_EQ(std::string(tokens[1].string, tokens[1].length), "a") << "key should point to its characters";
+	ASSERT_EQ(tokens[2].offset, 4) << "list should start at its bracket";
+	ASSERT_EQ(tokens[3].intValue, 1) << "int should have its value";
+	ASSERT_EQ(tokens[4].floatValue, 2.5) << "float should have its value";
+	ASSERT_EQ(std::string(tokens[5].string, tokens[5].length), "x") << "string should point to its characters";
+	ASSERT_EQ(std::string(tokens[7].string, tokens[7].length), "b\\n") << "long key should point to its escaped characters";
+	ASSERT_TRUE(tokens[7].escaped) << "long key with escape sequence should be marked as escaped";
+
+	char *key = storeCopyTokenString(&tokens[7]);
+	ASSERT_STREQ(key, "b\n") << "copied key should have its escape sequences resolved";
+	free(key);
+
+	storeFreeReader(reader);
+}
+
+TEST(Reader, matchesParser)
+{
+	for(const char *input : inputs) {
+		expectReadLikeParsed(input);
+	}
+
+	for(int levels = 330; levels < 340; levels++) {
+		expectReadLikeParsed(nest("[", "1", "]", levels));
+		expectReadLikeParsed(nest("{a = ", "1", "}", levels / 4 * 3));
+		expectReadLikeParsed("a = " + nest("(", "{b = 1}", ")", levels));
+	}
+}
+
+TEST(Reader, errors)
+{
+	const char *input = "a = [1 2 3}";
+	StoreReader *reader = storeCreateReader(input, strlen(input));
+
+	int numTokens = 0;
+	StoreToken token;
+	while(storeReaderNext(reader, &token)) {
+		numTokens++;
+	}
+
+	size_t errorOffset = 0;
+	ASSERT_EQ(numTokens, 6) << "tokens before the error should be read";
+	ASSERT_TRUE(storeReaderHasFailed(reader, &errorOffset)) << "reading mismatched brackets should fail";
+	ASSERT_EQ(errorOffset, 10) << "error should be at the mismatched bracket";
+	ASSERT_FALSE(storeReaderNext(reader, &token)) << "reading should not continue after an error";
+	storeFreeReader(reader);
+
+	reader = storeCreateReader("a = 1\0b = 2", 11);
+	while(storeReaderNext(reader, &token)) {
+		// keep reading
+	}
+
+	ASSERT_TRUE(storeReaderHasFailed(reader, &errorOffset)) << "null character within the input should fail";
+	ASSERT_EQ(errorOffset, 5) << "error should be at the null character";
+	storeFreeReader(reader);
+}
+
+TEST(Reader, skipValue)
+{
+	const char *input = "skipped = {a = [1 (2 \"]\" 3)] b = x}; list = [[1 2] 3 {c = 4}]; last = 5";
+	StoreReader *reader = storeCreateReader(input, strlen(input));
+
+	StoreToken token;
+	ASSERT_TRUE(storeReaderNext(reader, &token)) << "map should begin";
+	ASSERT_TRUE(storeReaderSkipValue(reader)) << "first entry should be skipped";
+
+	ASSERT_TRUE(storeReaderNext(reader, &token)) << "second key should be read";
+	ASSERT_EQ(std::string(token.string, token.length), "list") << "second key should follow the skipped entry";
+	ASSERT_TRUE(storeReaderNext(reader, &token)) << "list should begin";
+	ASSERT_TRUE(storeReaderSkipValue(reader)) << "nested list should be skipped";
+	ASSERT_TRUE(storeReaderSkipValue(reader)) << "int should be skipped";
+	ASSERT_TRUE(storeReaderNext(reader, &token)) << "map element should begin";
+	ASSERT_EQ(token.type, STORE_TOKEN_MAP_BEGIN) << "map element should follow the skipped elements";
+	ASSERT_TRUE(storeReaderSkipValue(reader)) << "map entry should be skipped";
+	ASSERT_FALSE(storeReaderSkipValue(reader)) << "end of the map should not be skipped";
+	ASSERT_FALSE(storeReaderHasFailed(reader, NULL)) << "not skipping the end of the map should not fail";
+	ASSERT_TRUE(storeReaderNext(reader, &token)) << "map end should be read";
+	ASSERT_EQ(token.type, STORE_TOKEN_MAP_END) << "map should end after its skipped entry";
+	ASSERT_TRUE(storeReaderNext(reader, &token)) << "list end should be read";
+	ASSERT_EQ(token.type, STORE_TOKEN_LIST_END) << "list should end after the map";
+
+	ASSERT_TRUE(storeReaderNext(reader, &token)) << "last key should be read";
+	ASSERT_TRUE(storeReaderNext(reader, &token)) << "last value should be read";
+	ASSERT_EQ(token.intValue, 5) << "last value should be read correctly";
+	storeFreeReader(reader);
+
+	reader = storeCreateReader(input, strlen(input));
+	ASSERT_TRUE(storeReaderSkipValue(reader)) << "whole input should be skipped";
+	ASSERT_FALSE(storeReaderNext(reader, &token)) << "nothing should follow the skipped input";
+	ASSERT_FALSE(storeReaderHasFailed(reader, NULL)) << "skipping the whole input should not fail";
+	storeFreeReader(reader);
+
+	const char *unbalanced = "a = {b = [1 2}; c = 3";
+	reader = storeCreateReader(unbalanced, strlen(unbalanced));
+	ASSERT_TRUE(storeReaderNext(reader, &token)) << "map should begin";
+	ASSERT_FALSE(storeReaderSkipValue(reader)) << "unbalanced entry should not be skipped";
+	ASSERT_TRUE(storeReaderHasFailed(reader, NULL)) << "skipping an unbalanced entry should fail";
+	storeFreeReader(reader);
+}
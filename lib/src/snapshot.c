@@ -0,0 +1,273 @@
+#include <pthread.h>
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL
+#include <stdint.h> // uint64_t
+
+#include <glib.h>
+
+#include "store/memory.h"
+#include "store/snapshot.h"
+
+/**
+ * The epoch announced by readers outside of a read section
+ */
+static const uint64_t inactiveEpoch = 0;
+
+struct StoreSnapshotStruct {
+	Store *store;
+	/** The number of handles to the snapshot, including the publisher's own while it is published or awaiting reclamation */
+	unsigned int references;
+	/** The publisher epoch at which the snapshot was replaced, readers that announced a later one can't be reading it */
+	uint64_t retireEpoch;
+	StorePublisher *publisher;
+	/** The next snapshot in the publisher's list of replaced or garbage snapshots */
+	StoreSnapshot *next;
+};
+
+struct StoreSnapshotReaderStruct {
+	StorePublisher *publisher;
+	/** The publisher epoch announced when entering the current read section, or inactiveEpoch outside of one */
+	uint64_t epoch;
+	/** The snapshot read in the current read section */
+	StoreSnapshot *snapshot;
+};
+
+struct StorePublisherStruct {
+	/** The currently published snapshot */
+	StoreSnapshot *current;
+	/** The current epoch, advanced whenever a snapshot is replaced */
+	uint64_t epoch;
+	bool deferFree;
+	/** Lock serializing publishing, reclamation and reader registration, never taken by readers */
+	pthread_mutex_t lock;
+	/** list of (StoreSnapshotReader *) registered readers */
+	GList *readers;
+	/** The replaced snapshots whose publisher reference awaits the end of all read sections that may see them */
+	StoreSnapshot *retired;
+	/** Lock-free stack of unreferenced snapshots to be freed by storePublisherReclaim if freeing is deferred */
+	StoreSnapshot *garbage;
+};
+
+static StoreSnapshot *createSnapshot(StorePublisher *publisher, Store *store);
+static void disposeSnapshot(StoreSnapshot *snapshot);
+static void freeSnapshot(StoreSnapshot *snapshot);
+static int releaseRetiredSnapshots(StorePublisher *publisher);
+static int freeGarbage(StorePublisher *publisher);
+
+StorePublisher *storeCreatePublisher(Store *store, bool deferFree)
+{
+	StorePublisher *publisher = storeAllocateMemoryType(StorePublisher);
+	publisher->epoch = 1;
+	publisher->deferFree = deferFree;
+	pthread_mutex_init(&publisher->lock, NULL);
+	publisher->readers = NULL;
+	publisher->retired = NULL;
+	publisher->garbage = NULL;
+
+	storeFreeze(store);
+	publisher->current = createSnapshot(publisher, store);
+	return publisher;
+}
+
+void storeFreePublisher(StorePublisher *publisher)
+{
+	// without readers, every replaced snapshot can be released right away
+	pthread_mutex_lock(&publisher->lock);
+	releaseRetiredSnapshots(publisher);
+	pthread_mutex_unlock(&publisher->lock);
+
+	storeReleaseSnapshot(publisher->current);
+	freeGarbage(publisher);
+
+	g_list_free(publisher->readers);
+	pthread_mutex_destroy(&publisher->lock);
+	storeFreeMemory(publisher);
+}
+
+void storePublish(StorePublisher *publisher, Store *store)
+{
+	storeFreeze(store);
+	StoreSnapshot *snapshot = createSnapshot(publisher, store);
+
+	pthread_mutex_lock(&publisher->lock);
+
+	StoreSnapshot *replaced = __atomic_exchange_n(&publisher->current, snapshot, __ATOMIC_SEQ_CST);
+
+	// readers entering with a later epoch are guaranteed to see the new snapshot
+	replaced->retireEpoch = __atomic_fetch_add(&publisher->epoch, 1, __ATOMIC_SEQ_CST);
+	replaced->next = publisher->retired;
+	publisher->retired = replaced;
+
+	releaseRetiredSnapshots(publisher);
+
+	pthread_mutex_unlock(&publisher->lock);
+}
+
+int storePublisherReclaim(StorePublisher *publisher)
+{
+	pthread_mutex_lock(&publisher->lock);
+	int count = releaseRetiredSnapshots(publisher);
+	pthread_mutex_unlock(&publisher->lock);
+
+	return count + freeGarbage(publisher);
+}
+
+StoreSnapshotReader *storeRegisterSnapshotReader(StorePublisher *publisher)
+{
+	StoreSnapshotReader *reader = storeAllocateMemoryType(StoreSnapshotReader);
+	reader->publisher = publisher;
+	reader->epoch = inactiveEpoch;
+	reader->snapshot = NULL;
+
+	pthread_mutex_lock(&publisher->lock);
+	publisher->readers = g_list_prepend(publisher->readers, reader);
+	pthread_mutex_unlock(&publisher->lock);
+
+	return reader;
+}
+
+void storeUnregisterSnapshotReader(StoreSnapshotReader *reader)
+{
+	StorePublisher *publisher = reader->publisher;
+
+	pthread_mutex_lock(&publisher->lock);
+	publisher->readers = g_list_remove(publisher->readers, reader);
+	pthread_mutex_unlock(&publisher->lock);
+
+	storeFreeMemory(reader);
+}
+
+Store *storeReadBegin(StoreSnapshotReader *reader)
+{
+	StorePublisher *publisher = reader->publisher;
+
+	// announce the epoch before loading the snapshot, the fence orders the announcement before the load so that
+	// a publisher either sees the announcement or this reader sees the publisher's new snapshot
+	uint64_t epoch = __atomic_load_n(&publisher->epoch, __ATOMIC_ACQUIRE);
+	__atomic_store_n(&reader->epoch, epoch, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	reader->snapshot = __atomic_load_n(&publisher->current, __ATOMIC_ACQUIRE);
+	return reader->snapshot->store;
+}
+
+void storeReadEnd(StoreSnapshotReader *reader)
+{
+	reader->snapshot = NULL;
+	__atomic_store_n(&reader->epoch, inactiveEpoch, __ATOMIC_RELEASE);
+}
+
+StoreSnapshot *storeAcquireSnapshot(StoreSnapshotReader *reader)
+{
+	storeReadBegin(reader);
+	StoreSnapshot *snapshot = reader->snapshot;
+	__atomic_add_fetch(&snapshot->references, 1, __ATOMIC_RELAXED);
+	storeReadEnd(reader);
+
+	return snapshot;
+}
+
+void storeReleaseSnapshot(StoreSnapshot *snapshot)
+{
+	if(__atomic_sub_fetch(&snapshot->references, 1, __ATOMIC_ACQ_REL) == 0) {
+		disposeSnapshot(snapshot);
+	}
+}
+
+Store *storeSnapshotGetStore(StoreSnapshot *snapshot)
+{
+	return snapshot->store;
+}
+
+static StoreSnapshot *createSnapshot(StorePublisher *publisher, Store *store)
+{
+	StoreSnapshot *snapshot = storeAllocateMemoryType(StoreSnapshot);
+	snapshot->store = store;
+	snapshot->references = 1;
+	snapshot->retireEpoch = 0;
+	snapshot->publisher = publisher;
+	snapshot->next = NULL;
+	return snapshot;
+}
+
+/**
+ * Frees an unreferenced snapshot, or pushes it onto its publisher's garbage stack if freeing is deferred
+ */
+static void disposeSnapshot(StoreSnapshot *snapshot)
+{
+	StorePublisher *publisher = snapshot->publisher;
+	if(!publisher->deferFree) {
+		freeSnapshot(snapshot);
+		return;
+	}
+
+	snapshot->next = __atomic_load_n(&publisher->garbage, __ATOMIC_RELAXED);
+	while(!__atomic_compare_exchange_n(&publisher->garbage, &snapshot->next, snapshot, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+		// snapshot->next was updated to the current top of the stack
+	}
+}
+
+static void freeSnapshot(StoreSnapshot *snapshot)
+{
+	storeFree(snapshot->store);
+	storeFreeMemory(snapshot);
+}
+
+/**
+ * Drops the publisher's reference to every replaced snapshot that no reader in a read section can be reading
+ *
+ * @param publisher		the publisher whose replaced snapshots to release, whose lock must be held
+ * @result				the number of snapshots freed right away because freeing isn't deferred
+ */
+static int releaseRetiredSnapshots(StorePublisher *publisher)
+{
+	int count = 0;
+
+	// readers that announced an epoch up to the oldest one still in a read section may be reading a snapshot retired since
+	uint64_t oldestEpoch = UINT64_MAX;
+	for(GList *iter = publisher->readers; iter != NULL; iter = iter->next) {
+		uint64_t epoch = __atomic_load_n(&((StoreSnapshotReader *) iter->data)->epoch, __ATOMIC_SEQ_CST);
+		if(epoch != inactiveEpoch && epoch < oldestEpoch) {
+			oldestEpoch = epoch;
+		}
+	}
+
+	StoreSnapshot **link = &publisher->retired;
+	while(*link != NULL) {
+		StoreSnapshot *snapshot = *link;
+		if(snapshot->retireEpoch < oldestEpoch) {
+			*link = snapshot->next;
+			snapshot->next = NULL;
+
+			if(__atomic_sub_fetch(&snapshot->references, 1, __ATOMIC_ACQ_REL) == 0) {
+				disposeSnapshot(snapshot);
+				count += publisher->deferFree ? 0 : 1;
+			}
+		} else {
+			link = &snapshot->next;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * Frees the snapshots on a publisher's garbage stack
+ *
+ * @param publisher		the publisher whose garbage to free
+ * @result				the number of snapshots freed
+ */
+static int freeGarbage(StorePublisher *publisher)
+{
+	StoreSnapshot *snapshot = __atomic_exchange_n(&publisher->garbage, NULL, __ATOMIC_ACQUIRE);
+
+	int count = 0;
+	while(snapshot != NULL) {
+		StoreSnapshot *next = snapshot->next;
+		freeSnapshot(snapshot);
+		snapshot = next;
+		count++;
+	}
+
+	return count;
+}
@@ -0,0 +1,89 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/store.h>
+}
+
+#include "snapshot.c"
+
+TEST(Snapshot, readSection)
+{
+	StorePublisher *publisher = storeCreatePublisher(storeCreateIntValue(1), false);
+	StoreSnapshotReader *reader = storeRegisterSnapshotReader(publisher);
+
+	Store *store = storeReadBegin(reader);
+	ASSERT_EQ(store->content.intValue, 1) << "read section should see the initial store";
+
+	storePublish(publisher, storeCreateIntValue(2));
+	ASSERT_EQ(store->content.intValue, 1) << "replaced store should stay valid until the read section ends";
+	ASSERT_EQ(storePublisherReclaim(publisher), 0) << "store being read should not be freed";
+	storeReadEnd(reader);
+
+	ASSERT_EQ(storePublisherReclaim(publisher), 1) << "replaced store should be freed after the read section ended";
+	ASSERT_EQ(storeReadBegin(reader)->content.intValue, 2) << "new read section should see the new store";
+	storeReadEnd(reader);
+
+	storeUnregisterSnapshotReader(reader);
+	storeFreePublisher(publisher);
+}
+
+TEST(Snapshot, handles)
+{
+	StorePublisher *publisher = storeCreatePublisher(storeCreateIntValue(1), true);
+	StoreSnapshotReader *reader = storeRegisterSnapshotReader(publisher);
+
+	StoreSnapshot *snapshot = storeAcquireSnapshot(reader);
+	storePublish(publisher, storeCreateIntValue(2));
+	storePublish(publisher, storeCreateIntValue(3));
+	ASSERT_EQ(storePublisherReclaim(publisher), 1) << "replaced store without a handle should be freed";
+	ASSERT_EQ(storeSnapshotGetStore(snapshot)->content.intValue, 1) << "replaced store with a handle should stay valid";
+
+	storeReleaseSnapshot(snapshot);
+	ASSERT_EQ(storePublisherReclaim(publisher), 1) << "deferred store should be freed after its handle was released";
+
+	snapshot = storeAcquireSnapshot(reader);
+	ASSERT_EQ(storeSnapshotGetStore(snapshot)->content.intValue, 3) << "acquired snapshot should be the published store";
+	storeReleaseSnapshot(snapshot);
+
+	storeUnregisterSnapshotReader(reader);
+	storeFreePublisher(publisher);
+}
+
+TEST(Snapshot, concurrentReaders)
+{
+	StorePublisher *publisher = storeCreatePublisher(storeCreateIntValue(0), false);
+
+	std::atomic<bool> done(false);
+	std::atomic<int> errors(0);
+	std::vector<std::thread> readers;
+	for(int i = 0; i < 4; i++) {
+		readers.push_back(std::thread([&]() {
+			StoreSnapshotReader *reader = storeRegisterSnapshotReader(publisher);
+			while(!done) {
+				Store *store = storeReadBegin(reader);
+				if(store->type != STORE_INT || store->content.intValue < 0) {
+					errors++;
+				}
+				storeReadEnd(reader);
+			}
+			storeUnregisterSnapshotReader(reader);
+		}));
+	}
+
+	for(int i = 1; i <= 1000; i++) {
+		storePublish(publisher, storeCreateIntValue(i));
+	}
+
+	done = true;
+	for(std::thread& thread : readers) {
+		thread.join();
+	}
+
+	ASSERT_EQ(errors, 0) << "readers should always see a valid store";
+	storeFreePublisher(publisher);
+}
@@ -0,0 +1,253 @@
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL size_t
+#include <stdint.h> // uint64_t uintptr_t
+
+#include "store/memory.h"
+#include "store/spans.h"
+
+/**
+ * The number of slots of a newly created span table, which must be a power of two
+ */
+static const int initialCapacity = 64;
+
+/**
+ * The number of shifts recorded before they are applied to all spans, which bounds the work of a lookup
+ */
+#define MAX_PENDING_SHIFTS 64
+
+struct StoreSpanTableStruct {
+	/** The number of slots, a power of two */
+	int capacity;
+	/** The number of occupied slots */
+	int size;
+	/** The store of each slot, or NULL if the slot is free */
+	Store **stores;
+	/** The start offset of the span of each slot's store */
+	int *starts;
+	/** The end offset of the span of each slot's store */
+	int *ends;
+	/** The number of recorded shifts that were already applied to the offsets of each slot */
+	int *epochs;
+	/** The number of shifts recorded since they were last applied to all spans */
+	int numShifts;
+	/** The offset of each recorded shift, in the offsets after the shifts before it */
+	int shiftPositions[MAX_PENDING_SHIFTS];
+	/** The number of bytes each recorded shift moves the offsets beyond its position by */
+	int shiftDeltas[MAX_PENDING_SHIFTS];
+};
+
+static void allocateSlots(StoreSpanTable *table, int capacity);
+static void grow(StoreSpanTable *table);
+static int findSlot(StoreSpanTable *table, Store *store);
+static int getHomeSlot(StoreSpanTable *table, Store *store);
+static void applyShifts(StoreSpanTable *table, int slot);
+static int shiftOffset(StoreSpanTable *table, int offset, int epoch);
+
+StoreSpanTable *storeCreateSpanTable()
+{
+	StoreSpanTable *table = storeAllocateMemoryType(StoreSpanTable);
+	allocateSlots(table, initialCapacity);
+	return table;
+}
+
+void storeFreeSpanTable(StoreSpanTable *table)
+{
+	storeFreeMemory(table->stores);
+	storeFreeMemory(table->starts);
+	storeFreeMemory(table->ends);
+	storeFreeMemory(table->epochs);
+	storeFreeMemory(table);
+}
+
+void storeSpanTableSet(StoreSpanTable *table, Store *store, int start, int end)
+{
+	// keep at most three quarters of the slots occupied so that probe sequences stay short
+	if(4 * (table->size + 1) > 3 * table->capacity) {
+		grow(table);
+	}
+
+	int slot = findSlot(table, store);
+	if(table->stores[slot] == NULL) {
+		table->stores[slot] = store;
+		table->size++;
+	}
+
+	table->starts[slot] = start;
+	table->ends[slot] = end;
+	table->epochs[slot] = table->numShifts;
+}
+
+void storeSpanTableRemove(StoreSpanTable *table, Store *store)
+{
+	int slot = findSlot(table, store);
+	if(table->stores[slot] == NULL) {
+		return;
+	}
+
+	table->stores[slot] = NULL;
+	table->size--;
+
+	// move back the following stores of the probe sequence that would no longer be found past the freed slot
+	int mask = table->capacity - 1;
+	int vacant = slot;
+	for(int next = (slot + 1) & mask; table->stores[next] != NULL; next = (next + 1) & mask) {
+		int home = getHomeSlot(table, table->stores[next]);
+		if(((next - home) & mask) >= ((next - vacant) & mask)) {
+			table->stores[vacant] = table->stores[next];
+			table->starts[vacant] = table->starts[next];
+			table->ends[vacant] = table->ends[next];
+			table->epochs[vacant] = table->epochs[next];
+			table->stores[next] = NULL;
+			vacant = next;
+		}
+	}
+}
+
+void storeSpanTableShift(StoreSpanTable *table, int position, int delta)
+{
+	if(table->numShifts == MAX_PENDING_SHIFTS) {
+		for(int slot = 0; slot < table->capacity; slot++) {
+			if(table->stores[slot] != NULL) {
+				applyShifts(table, slot);
+			}
+			table->epochs[slot] = 0;
+		}
+
+		table->numShifts = 0;
+	}
+
+	// the spans are only shifted once they are looked up, so that an edit doesn't touch every span
+	table->shiftPositions[table->numShifts] = position;
+	table->shiftDeltas[table->numShifts] = delta;
+	table->numShifts++;
+}
+
+bool storeSpanTableLookup(StoreSpanTable *table, Store *store, StoreSpan *span)
+{
+	if(table == NULL) {
+		return false;
+	}
+
+	int slot = findSlot(table, store);
+	if(table->stores[slot] == NULL) {
+		return false;
+	}
+
+	span->start = shiftOffset(table, table->starts[slot], table->epochs[slot]);
+	span->end = shiftOffset(table, table->ends[slot], table->epochs[slot]);
+	return true;
+}
+
+int storeSpanTableGetSize(StoreSpanTable *table)
+{
+	return table->size;
+}
+
+size_t storeGetSpanTableMemorySize(StoreSpanTable *table)
+{
+	return sizeof(StoreSpanTable) + (size_t) table->capacity * (sizeof(Store *) + 3 * sizeof(int));
+}
+
+/**
+ * Allocates the given number of free slots for a span table, whose previous slots and recorded shifts are discarded
+ */
+static void allocateSlots(StoreSpanTable *table, int capacity)
+{
+	table->capacity = capacity;
+	table->size = 0;
+	table->stores = (Store **) storeAllocateMemory(capacity * sizeof(Store *));
+	table->starts = (int *) storeAllocateMemory(capacity * sizeof(int));
+	table->ends = (int *) storeAllocateMemory(capacity * sizeof(int));
+	table->epochs = (int *) storeAllocateMemory(capacity * sizeof(int));
+	table->numShifts = 0;
+
+	for(int slot = 0; slot < capacity; slot++) {
+		table->stores[slot] = NULL;
+		table->starts[slot] = 0;
+		table->ends[slot] = 0;
+		table->epochs[slot] = 0;
+	}
+}
+
+/**
+ * Doubles the number of slots of a span table, reinserting its spans
+ */
+static void grow(StoreSpanTable *table)
+{
+	int capacity = table->capacity;
+	Store **stores = table->stores;
+	int *starts = table->starts;
+	int *ends = table->ends;
+	int *epochs = table->epochs;
+	int numShifts = table->numShifts;
+
+	allocateSlots(table, 2 * capacity);
+	table->numShifts = numShifts;
+	for(int slot = 0; slot < capacity; slot++) {
+		if(stores[slot] != NULL) {
+			int newSlot = findSlot(table, stores[slot]);
+			table->stores[newSlot] = stores[slot];
+			table->starts[newSlot] = starts[slot];
+			table->ends[newSlot] = ends[slot];
+			table->epochs[newSlot] = epochs[slot];
+			table->size++;
+		}
+	}
+
+	storeFreeMemory(stores);
+	storeFreeMemory(starts);
+	storeFreeMemory(ends);
+	storeFreeMemory(epochs);
+}
+
+/**
+ * Finds the slot of a store by linear probing, or the free slot where it would be inserted
+ */
+static int findSlot(StoreSpanTable *table, Store *store)
+{
+	int mask = table->capacity - 1;
+	int slot = getHomeSlot(table, store);
+	while(table->stores[slot] != NULL && table->stores[slot] != store) {
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+/**
+ * Returns the slot at which the probe sequence of a store starts, by Fibonacci hashing its address
+ */
+static int getHomeSlot(StoreSpanTable *table, Store *store)
+{
+	uint64_t hash = (uint64_t) (uintptr_t) store * 0x9e3779b97f4a7c15ull;
+	return (int) (hash >> 32) & (table->capacity - 1);
+}
+
+/**
+ * Applies the recorded shifts that are still pending for a slot to its offsets
+ */
+static void applyShifts(StoreSpanTable *table, int slot)
+{
+	table->starts[slot] = shiftOffset(table, table->starts[slot], table->epochs[slot]);
+	table->ends[slot] = shiftOffset(table, table->ends[slot], table->epochs[slot]);
+	table->epochs[slot] = table->numShifts;
+}
+
+/**
+ * Moves an offset by the recorded shifts from an epoch on, in the order they were recorded
+ *
+ * @param table			the span table whose shifts to apply
+ * @param offset		the offset after the shifts before the epoch
+ * @param epoch			the number of recorded shifts that were already applied to the offset
+ * @result				the offset after all recorded shifts
+ */
+static int shiftOffset(StoreSpanTable *table, int offset, int epoch)
+{
+	for(int i = epoch; i < table->numShifts; i++) {
+		if(offset > table->shiftPositions[i]) {
+			offset += table->shiftDeltas[i];
+		}
+	}
+
+	return offset;
+}
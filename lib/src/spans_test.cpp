@@ -0,0 +1,123 @@
+#include <map>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "spans.c"
+
+TEST(Spans, setAndRemove)
+{
+	StoreSpanTable *table = storeCreateSpanTable();
+
+	std::vector<Store *> stores;
+	std::map<Store *, int> expected;
+	for(int i = 0; i < 1000; i++) {
+		Store *store = storeCreateIntValue(i);
+		stores.push_back(store);
+		storeSpanTableSet(table, store, i, i + 1);
+		expected[store] = i;
+	}
+
+	// remove every third store to exercise moving back the stores of probe sequences
+	for(int i = 0; i < 1000; i += 3) {
+		storeSpanTableRemove(table, stores[i]);
+		expected.erase(stores[i]);
+	}
+
+	ASSERT_EQ(storeSpanTableGetSize(table), (int) expected.size()) << "table should contain the remaining spans";
+	for(int i = 0; i < 1000; i++) {
+		StoreSpan span;
+		bool found = storeSpanTableLookup(table, stores[i], &span);
+		ASSERT_EQ(found, expected.count(stores[i]) > 0) << "only remaining stores should have a span";
+		if(found) {
+			ASSERT_EQ(span.start, i) << "span should start at the set offset";
+			ASSERT_EQ(span.end, i + 1) << "span should end at the set offset";
+		}
+	}
+
+	storeSpanTableSet(table, stores[1], 7, 8);
+	StoreSpan span;
+	ASSERT_TRUE(storeSpanTableLookup(table, stores[1], &span)) << "replaced span should be found";
+	ASSERT_EQ(span.start, 7) << "setting a span again should replace it";
+	ASSERT_EQ(storeSpanTableGetSize(table), (int) expected.size()) << "replacing a span should not add one";
+	ASSERT_GE(storeGetSpanTableMemorySize(table), expected.size() * (sizeof(Store *) + 2 * sizeof(int))) << "memory size should cover all spans";
+
+	for(Store *store : stores) {
+		storeFree(store);
+	}
+	storeFreeSpanTable(table);
+}
+
+TEST(Spans, shift)
+{
+	StoreSpanTable *table = storeCreateSpanTable();
+	Store *before = storeCreateIntValue(0);
+	Store *enclosing = storeCreateIntValue(1);
+	Store *after = storeCreateIntValue(2);
+	storeSpanTableSet(table, before, 0, 5);
+	storeSpanTableSet(table, enclosing, 5, 20);
+	storeSpanTableSet(table, after, 20, 25);
+
+	storeSpanTableShift(table, 10, 3);
+
+	StoreSpan span;
+	storeSpanTableLookup(table, before, &span);
+	ASSERT_EQ(span.start, 0) << "span before the edit should be unchanged";
+	ASSERT_EQ(span.end, 5) << "span before the edit should be unchanged";
+	storeSpanTableLookup(table, enclosing, &span);
+	ASSERT_EQ(span.start, 5) << "start of the span enclosing the edit should be unchanged";
+	ASSERT_EQ(span.end, 23) << "end of the span enclosing the edit should be shifted";
+	storeSpanTableLookup(table, after, &span);
+	ASSERT_EQ(span.start, 23) << "span after the edit should be shifted";
+	ASSERT_EQ(span.end, 28) << "span after the edit should be shifted";
+
+	storeFree(before);
+	storeFree(enclosing);
+	storeFree(after);
+	storeFreeSpanTable(table);
+}
+
+TEST(Spans, pendingShifts)
+{
+	StoreSpanTable *table = storeCreateSpanTable();
+	std::vector<Store *> stores;
+	for(int i = 0; i < 100; i++) {
+		Store *store = storeCreateIntValue(i);
+		stores.push_back(store);
+		storeSpanTableSet(table, store, 10 * i, 10 * i + 5);
+	}
+
+	// insert a byte after every span, more often than shifts are kept pending and while the table grows
+	std::vector<Store *> added;
+	for(int i = 0; i < 100; i++) {
+		storeSpanTableShift(table, 10 * i + 5 + i, 1);
+
+		Store *store = storeCreateIntValue(-i);
+		added.push_back(store);
+		storeSpanTableSet(table, store, 10 * i + 5 + i, 10 * i + 6 + i);
+	}
+
+	for(int i = 0; i < 100; i++) {
+		StoreSpan span;
+		ASSERT_TRUE(storeSpanTableLookup(table, stores[i], &span)) << "shifted span should be found";
+		ASSERT_EQ(span.start, 11 * i) << "span should be moved by the shifts before it";
+		ASSERT_EQ(span.end, 11 * i + 5) << "span should be moved by the shifts before it";
+		ASSERT_TRUE(storeSpanTableLookup(table, added[i], &span)) << "span set between shifts should be found";
+		ASSERT_EQ(span.start, 11 * i + 5) << "span set between shifts should only be moved by later shifts";
+		ASSERT_EQ(span.end, 11 * i + 6) << "span set between shifts should only be moved by later shifts";
+	}
+
+	for(Store *store : stores) {
+		storeFree(store);
+	}
+	for(Store *store : added) {
+		storeFree(store);
+	}
+	storeFreeSpanTable(table);
+}
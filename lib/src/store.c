@@ -1,24 +1,47 @@
 #include <stdlib.h> // free
-#include <string.h>
+#include <string.h> // strlen memcpy
 
+#include "store/list.h"
+#include "store/map.h"
 #include "store/memory.h"
 #include "store/store.h"
+#include "store/table.h"
 
-static void freeStore(void *storePointer);
+typedef struct {
+	Store store;
+	/** The length of the string, whose characters follow directly after this struct in the same allocation */
+	int length;
+} StringStore;
+
+static Store *retainChild(Store *store, void *userData);
+static size_t getMemorySize(Store *store, GHashTable *visited);
+static char *getInlineString(Store *store);
+static void freeContent(Store *store);
 
 Store *storeCreateStringValue(const char *stringValue)
 {
-	Store *store = storeAllocateMemoryType(Store);
-	store->type = STORE_STRING;
-	store->content.stringValue = strdup(stringValue);
+	return storeCreateStringValueLength(stringValue, strlen(stringValue));
+}
 
-	return store;
+Store *storeCreateStringValueLength(const char *stringValue, int length)
+{
+	// allocate the characters together with the store to save an allocation and keep them close to the store
+	StringStore *stringStore = (StringStore *) storeAllocateMemory(sizeof(StringStore) + length + 1);
+	stringStore->store.type = STORE_STRING;
+	stringStore->store.references = 1;
+	stringStore->store.content.stringValue = getInlineString(&stringStore->store);
+	stringStore->length = length;
+	memcpy(stringStore->store.content.stringValue, stringValue, length);
+	stringStore->store.content.stringValue[length] = '\0';
+
+	return &stringStore->store;
 }
 
 Store *storeCreateIntValue(int intValue)
 {
 	Store *store = storeAllocateMemoryType(Store);
 	store->type = STORE_INT;
+	store->references = 1;
 	store->content.intValue = intValue;
 
 	return store;
@@ -28,6 +51,7 @@ Store *storeCreateFloatValue(double floatValue)
 {
 	Store *store = storeAllocateMemoryType(Store);
 	store->type = STORE_FLOAT;
+	store->references = 1;
 	store->content.floatValue = floatValue;
 
 	return store;
@@ -37,7 +61,46 @@ Store *storeCreateListValue()
 {
 	Store *store = storeAllocateMemoryType(Store);
 	store->type = STORE_LIST;
-	store->content.listValue = g_queue_new();
+	store->references = 1;
+	store->content.listValue = storeCreateList();
+
+	return store;
+}
+
+Store *storeCreateIntArrayValue(const int *intValues, int length)
+{
+	StoreArray *array = storeAllocateMemoryType(StoreArray);
+	array->length = length;
+	array->intValues = (int *) storeAllocateMemory(length * sizeof(int));
+	array->floatValues = NULL;
+	array->frozen = false;
+	if(length > 0) {
+		memcpy(array->intValues, intValues, length * sizeof(int));
+	}
+
+	Store *store = storeAllocateMemoryType(Store);
+	store->type = STORE_INT_ARRAY;
+	store->references = 1;
+	store->content.arrayValue = array;
+
+	return store;
+}
+
+Store *storeCreateFloatArrayValue(const double *floatValues, int length)
+{
+	StoreArray *array = storeAllocateMemoryType(StoreArray);
+	array->length = length;
+	array->intValues = NULL;
+	array->floatValues = (double *) storeAllocateMemory(length * sizeof(double));
+	array->frozen = false;
+	if(length > 0) {
+		memcpy(array->floatValues, floatValues, length * sizeof(double));
+	}
+
+	Store *store = storeAllocateMemoryType(Store);
+	store->type = STORE_FLOAT_ARRAY;
+	store->references = 1;
+	store->content.arrayValue = array;
 
 	return store;
 }
@@ -46,11 +109,58 @@ Store *storeCreateMapValue()
 {
 	Store *store = storeAllocateMemoryType(Store);
 	store->type = STORE_MAP;
-	store->content.mapValue = g_hash_table_new_full(g_str_hash, g_str_equal, free, freeStore);
+	store->references = 1;
+	store->content.mapValue = storeCreateMap();
 
 	return store;
 }
 
+int storeGetStringLength(Store *store)
+{
+	if(store->type != STORE_STRING) {
+		return -1;
+	}
+
+	if(store->content.stringValue == getInlineString(store)) {
+		return ((StringStore *) store)->length;
+	}
+
+	return strlen(store->content.stringValue);
+}
+
+size_t storeGetMemorySize(Store *store)
+{
+	GHashTable *visited = g_hash_table_new(g_direct_hash, g_direct_equal);
+	size_t size = getMemorySize(store, visited);
+	g_hash_table_destroy(visited);
+	return size;
+}
+
+size_t storeGetNodeMemorySize(Store *store)
+{
+	switch(store->type) {
+		case STORE_STRING:
+			if(store->content.stringValue == getInlineString(store)) {
+				// the characters are allocated together with the store, behind its length
+				return sizeof(StringStore) + ((StringStore *) store)->length + 1;
+			}
+
+			return sizeof(Store) + strlen(store->content.stringValue) + 1;
+		case STORE_LIST:
+			return sizeof(Store) + storeGetListMemorySize(store->content.listValue);
+		case STORE_MAP:
+			return sizeof(Store) + storeGetMapMemorySize(store->content.mapValue);
+		case STORE_INT_ARRAY:
+			return sizeof(Store) + sizeof(StoreArray) + store->content.arrayValue->length * sizeof(int);
+		case STORE_FLOAT_ARRAY:
+			return sizeof(Store) + sizeof(StoreArray) + store->content.arrayValue->length * sizeof(double);
+		case STORE_TABLE:
+			return sizeof(Store) + storeGetTableMemorySize(store->content.tableValue);
+		default:
+			return sizeof(Store);
+	}
+}
+
 const char *storeGetTypeName(Store *store)
 {
 	switch(store->type) {
@@ -64,33 +174,196 @@ const char *storeGetTypeName(Store *store)
 			return "list";
 		case STORE_MAP:
 			return "map";
+		case STORE_INT_ARRAY:
+			return "int array";
+		case STORE_FLOAT_ARRAY:
+			return "float array";
+		case STORE_TABLE:
+			return "table";
 		default:
 			return "<invalid store type>";
 	}
 }
 
-void storeFree(Store *store)
+void storeFreeze(Store *store)
 {
 	switch(store->type) {
-		case STORE_STRING:
-			free(store->content.stringValue);
-		break;
 		case STORE_LIST:
-			g_queue_free_full(store->content.listValue, freeStore);
+			for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+				storeFreeze((Store *) iter->data);
+			}
+
+			storeFreezeList(store->content.listValue);
 		break;
 		case STORE_MAP:
-			g_hash_table_destroy(store->content.mapValue);
+		{
+			StoreMapIterator iterator;
+			Store *value;
+			storeMapIteratorInit(&iterator, store);
+			while(storeMapIteratorNext(&iterator, NULL, &value)) {
+				storeFreeze(value);
+			}
+
+			storeFreezeMap(store->content.mapValue);
+		}
+		break;
+		case STORE_INT_ARRAY:
+		case STORE_FLOAT_ARRAY:
+			// the elements of packed arrays can be replaced in place by storeSetPath
+			store->content.arrayValue->frozen = true;
 		break;
 		default:
-			// No need to free ints or doubles
+			// Scalars and tables are never modified in place
 		break;
 	}
+}
+
+Store *storeCopyNode(Store *store, StoreCopyFunction copyChild, void *userData)
+{
+	Store *copy;
+	switch(store->type) {
+		case STORE_STRING:
+			return storeCreateStringValueLength(store->content.stringValue, storeGetStringLength(store));
+		case STORE_INT:
+			return storeCreateIntValue(store->content.intValue);
+		case STORE_FLOAT:
+			return storeCreateFloatValue(store->content.floatValue);
+		case STORE_LIST:
+			copy = storeAllocateMemoryType(Store);
+			copy->type = STORE_LIST;
+			copy->references = 1;
+			copy->content.listValue = storeCopyList(store->content.listValue, copyChild, userData);
+			return copy;
+		case STORE_MAP:
+			copy = storeAllocateMemoryType(Store);
+			copy->type = STORE_MAP;
+			copy->references = 1;
+			copy->content.mapValue = storeCopyMap(store->content.mapValue, copyChild, userData);
+			return copy;
+		case STORE_INT_ARRAY:
+			return storeCreateIntArrayValue(store->content.arrayValue->intValues, store->content.arrayValue->length);
+		case STORE_FLOAT_ARRAY:
+			return storeCreateFloatArrayValue(store->content.arrayValue->floatValues, store->content.arrayValue->length);
+		default:
+			return NULL;
+	}
+}
+
+Store *storeCopyShallow(Store *store)
+{
+	return storeCopyNode(store, retainChild, NULL);
+}
+
+Store *storeRetain(Store *store)
+{
+	__atomic_add_fetch(&store->references, 1, __ATOMIC_RELAXED);
+	return store;
+}
+
+void storeFree(Store *store)
+{
+	if(__atomic_sub_fetch(&store->references, 1, __ATOMIC_ACQ_REL) > 0) {
+		// still shared with other owners
+		return;
+	}
 
+	freeContent(store);
 	storeFreeMemory(store);
 }
 
-static void freeStore(void *storePointer)
+void storeReplaceContent(Store *store, Store *value)
+{
+	freeContent(store);
+
+	store->type = value->type;
+	if(value->type == STORE_STRING) {
+		// the characters of the value may be allocated together with it
+		int length = storeGetStringLength(value);
+		store->content.stringValue = (char *) malloc(length + 1);
+		memcpy(store->content.stringValue, value->content.stringValue, length + 1);
+		storeFree(value);
+	} else {
+		store->content = value->content;
+		storeFreeMemory(value);
+	}
+}
+
+static Store *retainChild(Store *store, void *userData)
+{
+	(void) userData;
+	return storeRetain(store);
+}
+
+/**
+ * Sums up the sizes of a store and its descendants, skipping shared stores that were already visited
+ *
+ * @param store			the store to measure
+ * @param visited		set of (Store *) shared stores that were already counted
+ * @result				the size of the store in bytes, or zero if it was already counted
+ */
+static size_t getMemorySize(Store *store, GHashTable *visited)
+{
+	if(store->references > 1) {
+		if(g_hash_table_contains(visited, store)) {
+			return 0;
+		}
+
+		g_hash_table_add(visited, store);
+	}
+
+	size_t size = storeGetNodeMemorySize(store);
+	if(store->type == STORE_LIST) {
+		for(GList *iter = store->content.listValue->head; iter != NULL; iter = iter->next) {
+			size += getMemorySize((Store *) iter->data, visited);
+		}
+	} else if(store->type == STORE_MAP) {
+		StoreMapIterator iter;
+		storeMapIteratorInit(&iter, store);
+		Store *value;
+		while(storeMapIteratorNext(&iter, NULL, &value)) {
+			size += getMemorySize(value, visited);
+		}
+	}
+
+	return size;
+}
+
+/**
+ * Returns where the characters of a string store created by storeCreateStringValue are located
+ */
+static char *getInlineString(Store *store)
+{
+	return (char *) ((StringStore *) store + 1);
+}
+
+/**
+ * Frees the content of a store without freeing the store itself
+ */
+static void freeContent(Store *store)
 {
-	Store *store = (Store *) storePointer;
-	storeFree(store);
+	switch(store->type) {
+		case STORE_STRING:
+			if(store->content.stringValue != getInlineString(store)) {
+				free(store->content.stringValue);
+			}
+		break;
+		case STORE_LIST:
+			storeFreeList(store->content.listValue);
+		break;
+		case STORE_MAP:
+			storeFreeMap(store->content.mapValue);
+		break;
+		case STORE_INT_ARRAY:
+		case STORE_FLOAT_ARRAY:
+			storeFreeMemory(store->content.arrayValue->intValues);
+			storeFreeMemory(store->content.arrayValue->floatValues);
+			storeFreeMemory(store->content.arrayValue);
+		break;
+		case STORE_TABLE:
+			storeFreeTable(store->content.tableValue);
+		break;
+		default:
+			// No need to free ints or doubles
+		break;
+	}
 }
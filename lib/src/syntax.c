@@ -0,0 +1,230 @@
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL size_t
+#include <stdint.h> // uint32_t
+
+#include "store/syntax.h"
+
+static size_t skipDigits(const char *data, size_t length, size_t position);
+
+bool storeIsTerminalCharacter(char c)
+{
+	switch(c) {
+		case ' ':
+		case '\t':
+		case '\n':
+		case '\v':
+		case '\f':
+		case '\r':
+		case ',':
+		case ';':
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool storeIsSeparatorCharacter(char c)
+{
+	switch(c) {
+		case ' ':
+		case '\t':
+		case '\n':
+		case '\v':
+		case '\f':
+		case '\r':
+		case ',':
+		case ';':
+		case '"':
+		case '(':
+		case '[':
+		case '{':
+		case ')':
+		case ']':
+		case '}':
+		case ':':
+		case '=':
+		case '\0':
+			return true;
+		default:
+			return false;
+	}
+}
+
+int storeGetHexValue(char c)
+{
+	if(c >= '0' && c <= '9') {
+		return c - '0';
+	} else if(c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	} else if(c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+
+	return -1;
+}
+
+char storePeekCharacter(const char *data, size_t length, size_t position)
+{
+	return position < length ? data[position] : '\0';
+}
+
+size_t storeSkipTerminalCharacters(const char *data, size_t length, size_t position)
+{
+	while(position < length && storeIsTerminalCharacter(data[position])) {
+		position++;
+	}
+
+	return position;
+}
+
+bool storeScanShortString(const char *data, size_t length, size_t *position)
+{
+	size_t current = *position;
+	while(current < length && !storeIsSeparatorCharacter(data[current])) {
+		current++;
+	}
+
+	if(current == *position) {
+		return false;
+	}
+
+	*position = current;
+	return true;
+}
+
+size_t storeScanInt(const char *data, size_t length, size_t position)
+{
+	size_t digits = storePeekCharacter(data, length, position) == '-' ? position + 1 : position;
+	size_t end = skipDigits(data, length, digits);
+	return end > digits ? end : position;
+}
+
+size_t storeScanFloat(const char *data, size_t length, size_t position)
+{
+	size_t end = storeScanInt(data, length, position);
+	if(end == position) {
+		return position;
+	}
+
+	if(storePeekCharacter(data, length, end) == '.') {
+		end = skipDigits(data, length, end + 1);
+	}
+
+	// the exponential part is only taken if it has digits
+	char c = storePeekCharacter(data, length, end);
+	if(c == 'e' || c == 'E') {
+		size_t exponential = end + 1;
+		c = storePeekCharacter(data, length, exponential);
+		if(c == '+' || c == '-') {
+			exponential++;
+		}
+
+		size_t exponentialEnd = skipDigits(data, length, exponential);
+		if(exponentialEnd > exponential) {
+			end = exponentialEnd;
+		}
+	}
+
+	return end;
+}
+
+bool storeScanEscapeSequence(const char *data, size_t length, size_t *position, uint32_t *codepoint)
+{
+	size_t current = *position + 1;
+	char c = storePeekCharacter(data, length, current);
+	switch(c) {
+		case '"':
+		case '\\':
+		case '/':
+			*codepoint = c;
+		break;
+		case 'b':
+			*codepoint = '\b';
+		break;
+		case 'f':
+			*codepoint = '\f';
+		break;
+		case 'n':
+			*codepoint = '\n';
+		break;
+		case 'r':
+			*codepoint = '\r';
+		break;
+		case 't':
+			*codepoint = '\t';
+		break;
+		case 'u':
+		{
+			uint32_t value = 0;
+			for(int i = 0; i < 4; i++) {
+				int hexValue = storeGetHexValue(storePeekCharacter(data, length, current + 1 + i));
+				if(hexValue < 0) {
+					*position = current + 1 + i;
+					return false;
+				}
+
+				value = 16 * value + hexValue;
+			}
+
+			// surrogates can't be converted to UTF-8, see storeConvertUnicodeToUtf8
+			if(value >= 0xd800 && value <= 0xdfff) {
+				return false;
+			}
+
+			*codepoint = value;
+			current += 4;
+		}
+		break;
+		default:
+			*position = current;
+			return false;
+		break;
+	}
+
+	*position = current + 1;
+	return true;
+}
+
+bool storeScanLongString(const char *data, size_t length, size_t *position, bool *escaped)
+{
+	// skip the opening delimiter
+	size_t current = *position + 1;
+	bool hasEscapes = false;
+
+	while(true) {
+		char c = storePeekCharacter(data, length, current);
+		if(c == '"') {
+			break;
+		} else if(c == '\0') {
+			*position = current;
+			return false;
+		} else if(c != '\\') {
+			current++;
+			continue;
+		}
+
+		hasEscapes = true;
+		uint32_t codepoint;
+		if(!storeScanEscapeSequence(data, length, &current, &codepoint)) {
+			*position = current;
+			return false;
+		}
+	}
+
+	if(escaped != NULL) {
+		*escaped = hasEscapes;
+	}
+
+	// skip the closing delimiter
+	*position = current + 1;
+	return true;
+}
+
+static size_t skipDigits(const char *data, size_t length, size_t position)
+{
+	while(position < length && data[position] >= '0' && data[position] <= '9') {
+		position++;
+	}
+
+	return position;
+}
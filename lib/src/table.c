@@ -0,0 +1,463 @@
+#include <stdlib.h> // free
+#include <string.h> // strcmp strdup strlen memset
+
+#include <glib.h>
+
+#include "store/map.h"
+#include "store/memory.h"
+#include "store/table.h"
+
+typedef struct {
+	/** The key of the column */
+	char *name;
+	/** The value type of the column, only valid after all rows were inspected */
+	StoreColumnType type;
+	/** Whether int, float and string values were found while inferring the column type */
+	bool hasInts;
+	bool hasFloats;
+	bool hasStrings;
+	/** Bit mask with a set bit for each row that has a value in this column */
+	unsigned char *presentMask;
+	/** The packed values of an int column */
+	int *intValues;
+	/** The packed values of a float column */
+	double *floatValues;
+	/** The values of a string column, NULL for null rows */
+	char **stringValues;
+} StoreColumn;
+
+struct StoreTableStruct {
+	int numRows;
+	int numColumns;
+	int capacity;
+	StoreColumn *columns;
+};
+
+static int findColumn(StoreTable *table, const char *name, int hint);
+static int addColumn(StoreTable *table, const char *name);
+static bool inferColumns(StoreTable *table, GQueue *list);
+static void fillColumns(StoreTable *table, GQueue *list);
+static StoreColumn *getColumn(Store *store, int column);
+
+void storeFreeTable(StoreTable *table)
+{
+	for(int i = 0; i < table->numColumns; i++) {
+		StoreColumn *column = &table->columns[i];
+		if(column->stringValues != NULL) {
+			for(int row = 0; row < table->numRows; row++) {
+				free(column->stringValues[row]);
+			}
+		}
+
+		free(column->name);
+		storeFreeMemory(column->presentMask);
+		storeFreeMemory(column->intValues);
+		storeFreeMemory(column->floatValues);
+		storeFreeMemory(column->stringValues);
+	}
+
+	storeFreeMemory(table->columns);
+	storeFreeMemory(table);
+}
+
+size_t storeGetTableMemorySize(StoreTable *table)
+{
+	size_t size = sizeof(StoreTable) + table->capacity * sizeof(StoreColumn);
+	for(int i = 0; i < table->numColumns; i++) {
+		StoreColumn *column = &table->columns[i];
+		size += strlen(column->name) + 1 + (table->numRows + 7) / 8;
+
+		if(column->intValues != NULL) {
+			size += table->numRows * sizeof(int);
+		}
+
+		if(column->floatValues != NULL) {
+			size += table->numRows * sizeof(double);
+		}
+
+		if(column->stringValues != NULL) {
+			size += table->numRows * sizeof(char *);
+			for(int row = 0; row < table->numRows; row++) {
+				if(column->stringValues[row] != NULL) {
+					size += strlen(column->stringValues[row]) + 1;
+				}
+			}
+		}
+	}
+
+	return size;
+}
+
+Store *storeToColumns(Store *store)
+{
+	if(store->type != STORE_LIST) {
+		return NULL;
+	}
+
+	GQueue *list = store->content.listValue;
+
+	StoreTable *table = storeAllocateMemoryType(StoreTable);
+	table->numRows = g_queue_get_length(list);
+	table->numColumns = 0;
+	table->capacity = 0;
+	table->columns = NULL;
+
+	if(!inferColumns(table, list)) {
+		storeFreeTable(table);
+		return NULL;
+	}
+
+	fillColumns(table, list);
+
+	Store *tableStore = storeAllocateMemoryType(Store);
+	tableStore->type = STORE_TABLE;
+	tableStore->references = 1;
+	tableStore->content.tableValue = table;
+	return tableStore;
+}
+
+int storeTableGetNumRows(Store *store)
+{
+	if(store->type != STORE_TABLE) {
+		return -1;
+	}
+
+	return store->content.tableValue->numRows;
+}
+
+int storeTableGetNumColumns(Store *store)
+{
+	if(store->type != STORE_TABLE) {
+		return -1;
+	}
+
+	return store->content.tableValue->numColumns;
+}
+
+int storeTableFindColumn(Store *store, const char *name)
+{
+	if(store->type != STORE_TABLE) {
+		return -1;
+	}
+
+	return findColumn(store->content.tableValue, name, 0);
+}
+
+const char *storeTableGetColumnName(Store *store, int column)
+{
+	StoreColumn *tableColumn = getColumn(store, column);
+	if(tableColumn == NULL) {
+		return NULL;
+	}
+
+	return tableColumn->name;
+}
+
+StoreColumnType storeTableGetColumnType(Store *store, int column)
+{
+	StoreColumn *tableColumn = getColumn(store, column);
+	if(tableColumn == NULL) {
+		return STORE_COLUMN_INVALID;
+	}
+
+	return tableColumn->type;
+}
+
+bool storeTableIsNull(Store *store, int column, int row)
+{
+	StoreColumn *tableColumn = getColumn(store, column);
+	if(tableColumn == NULL || row < 0 || row >= store->content.tableValue->numRows) {
+		return true;
+	}
+
+	return (tableColumn->presentMask[row / 8] & (1 << (row % 8))) == 0;
+}
+
+const int *storeTableGetIntColumn(Store *store, int column)
+{
+	StoreColumn *tableColumn = getColumn(store, column);
+	if(tableColumn == NULL) {
+		return NULL;
+	}
+
+	return tableColumn->intValues;
+}
+
+const double *storeTableGetFloatColumn(Store *store, int column)
+{
+	StoreColumn *tableColumn = getColumn(store, column);
+	if(tableColumn == NULL) {
+		return NULL;
+	}
+
+	return tableColumn->floatValues;
+}
+
+bool storeTableGetValue(Store *store, int column, int row, Store *value)
+{
+	if(storeTableIsNull(store, column, row)) {
+		return false;
+	}
+
+	StoreColumn *tableColumn = &store->content.tableValue->columns[column];
+	switch(tableColumn->type) {
+		case STORE_COLUMN_INT:
+			value->type = STORE_INT;
+			value->content.intValue = tableColumn->intValues[row];
+		break;
+		case STORE_COLUMN_FLOAT:
+			value->type = STORE_FLOAT;
+			value->content.floatValue = tableColumn->floatValues[row];
+		break;
+		case STORE_COLUMN_STRING:
+			value->type = STORE_STRING;
+			value->content.stringValue = tableColumn->stringValues[row];
+		break;
+		default:
+		break;
+	}
+
+	return true;
+}
+
+int storeTableFilter(Store *store, int column, StoreTablePredicate predicate, void *userData, int *rows)
+{
+	StoreColumn *tableColumn = getColumn(store, column);
+	if(tableColumn == NULL) {
+		return -1;
+	}
+
+	int numMatches = 0;
+	int numRows = store->content.tableValue->numRows;
+
+	Store value;
+	switch(tableColumn->type) {
+		case STORE_COLUMN_INT:
+			value.type = STORE_INT;
+		break;
+		case STORE_COLUMN_FLOAT:
+			value.type = STORE_FLOAT;
+		break;
+		case STORE_COLUMN_STRING:
+			value.type = STORE_STRING;
+		break;
+		default:
+		break;
+	}
+
+	for(int row = 0; row < numRows; row++) {
+		if((tableColumn->presentMask[row / 8] & (1 << (row % 8))) == 0) {
+			continue;
+		}
+
+		switch(tableColumn->type) {
+			case STORE_COLUMN_INT:
+				value.content.intValue = tableColumn->intValues[row];
+			break;
+			case STORE_COLUMN_FLOAT:
+				value.content.floatValue = tableColumn->floatValues[row];
+			break;
+			case STORE_COLUMN_STRING:
+				value.content.stringValue = tableColumn->stringValues[row];
+			break;
+			default:
+			break;
+		}
+
+		if(predicate(&value, userData)) {
+			rows[numMatches] = row;
+			numMatches++;
+		}
+	}
+
+	return numMatches;
+}
+
+/**
+ * Finds a column by its key
+ *
+ * @param table			the table to search
+ * @param name			the key of the column to find
+ * @param hint			the index of the column to check first, since rows usually list their keys in the same order
+ * @result				the index of the column, or -1 if there is no such column
+ */
+static int findColumn(StoreTable *table, const char *name, int hint)
+{
+	if(hint < table->numColumns && strcmp(table->columns[hint].name, name) == 0) {
+		return hint;
+	}
+
+	for(int i = 0; i < table->numColumns; i++) {
+		if(strcmp(table->columns[i].name, name) == 0) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static int addColumn(StoreTable *table, const char *name)
+{
+	if(table->numColumns == table->capacity) {
+		int newCapacity = table->capacity == 0 ? 4 : 2 * table->capacity;
+		StoreColumn *columns = (StoreColumn *) storeAllocateMemory(newCapacity * sizeof(StoreColumn));
+		if(table->columns != NULL) {
+			memcpy(columns, table->columns, table->numColumns * sizeof(StoreColumn));
+			storeFreeMemory(table->columns);
+		}
+
+		table->columns = columns;
+		table->capacity = newCapacity;
+	}
+
+	StoreColumn *column = &table->columns[table->numColumns];
+	column->name = strdup(name);
+	column->type = STORE_COLUMN_INT;
+	column->hasInts = false;
+	column->hasFloats = false;
+	column->hasStrings = false;
+	column->presentMask = NULL;
+	column->intValues = NULL;
+	column->floatValues = NULL;
+	column->stringValues = NULL;
+
+	table->numColumns++;
+	return table->numColumns - 1;
+}
+
+/**
+ * Collects the columns of a list of maps and infers their types
+ *
+ * @param table			the table to add the columns to
+ * @param list			the list of maps to inspect
+ * @result				true if every row is a map and every column has a consistent type
+ */
+static bool inferColumns(StoreTable *table, GQueue *list)
+{
+	for(GList *iter = list->head; iter != NULL; iter = iter->next) {
+		Store *row = (Store *) iter->data;
+		if(row->type != STORE_MAP) {
+			return false;
+		}
+
+		int position = 0;
+		const char *key;
+		Store *value;
+		StoreMapIterator mapIterator;
+		storeMapIteratorInit(&mapIterator, row);
+		while(storeMapIteratorNext(&mapIterator, &key, &value)) {
+			int index = findColumn(table, key, position);
+			if(index < 0) {
+				index = addColumn(table, key);
+			}
+
+			StoreColumn *column = &table->columns[index];
+			switch(value->type) {
+				case STORE_INT:
+					column->hasInts = true;
+				break;
+				case STORE_FLOAT:
+					column->hasFloats = true;
+				break;
+				case STORE_STRING:
+					column->hasStrings = true;
+				break;
+				default:
+					return false;
+			}
+
+			position++;
+		}
+	}
+
+	for(int i = 0; i < table->numColumns; i++) {
+		StoreColumn *column = &table->columns[i];
+		if(column->hasStrings && (column->hasInts || column->hasFloats)) {
+			return false;
+		}
+
+		if(column->hasStrings) {
+			column->type = STORE_COLUMN_STRING;
+		} else if(column->hasFloats) {
+			column->type = STORE_COLUMN_FLOAT;
+		} else {
+			column->type = STORE_COLUMN_INT;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Allocates the columns of a table and copies the values of a list of maps into them
+ *
+ * @param table			the table to fill, whose columns were inferred from the list
+ * @param list			the list of maps to copy the values from
+ */
+static void fillColumns(StoreTable *table, GQueue *list)
+{
+	int maskSize = (table->numRows + 7) / 8;
+
+	for(int i = 0; i < table->numColumns; i++) {
+		StoreColumn *column = &table->columns[i];
+		column->presentMask = (unsigned char *) storeAllocateMemory(maskSize);
+		memset(column->presentMask, 0, maskSize);
+
+		switch(column->type) {
+			case STORE_COLUMN_INT:
+				column->intValues = (int *) storeAllocateMemory(table->numRows * sizeof(int));
+				memset(column->intValues, 0, table->numRows * sizeof(int));
+			break;
+			case STORE_COLUMN_FLOAT:
+				column->floatValues = (double *) storeAllocateMemory(table->numRows * sizeof(double));
+				memset(column->floatValues, 0, table->numRows * sizeof(double));
+			break;
+			case STORE_COLUMN_STRING:
+				column->stringValues = (char **) storeAllocateMemory(table->numRows * sizeof(char *));
+				memset(column->stringValues, 0, table->numRows * sizeof(char *));
+			break;
+			default:
+			break;
+		}
+	}
+
+	int row = 0;
+	for(GList *iter = list->head; iter != NULL; iter = iter->next) {
+		int position = 0;
+		const char *key;
+		Store *value;
+		StoreMapIterator mapIterator;
+		storeMapIteratorInit(&mapIterator, (Store *) iter->data);
+		while(storeMapIteratorNext(&mapIterator, &key, &value)) {
+			StoreColumn *column = &table->columns[findColumn(table, key, position)];
+			column->presentMask[row / 8] |= 1 << (row % 8);
+
+			switch(column->type) {
+				case STORE_COLUMN_INT:
+					column->intValues[row] = value->content.intValue;
+				break;
+				case STORE_COLUMN_FLOAT:
+					column->floatValues[row] = value->type == STORE_INT ? value->content.intValue : value->content.floatValue;
+				break;
+				case STORE_COLUMN_STRING:
+					column->stringValues[row] = strdup(value->content.stringValue);
+				break;
+				default:
+				break;
+			}
+
+			position++;
+		}
+
+		row++;
+	}
+}
+
+static StoreColumn *getColumn(Store *store, int column)
+{
+	if(store->type != STORE_TABLE || column < 0 || column >= store->content.tableValue->numColumns) {
+		return NULL;
+	}
+
+	return &store->content.tableValue->columns[column];
+}
@@ -0,0 +1,101 @@
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "table.c"
+
+class Table: public ::testing::Test {
+public:
+	virtual void SetUp() {
+		parser = storeCreateParser();
+	}
+
+	virtual void TearDown() {
+		storeFreeParser(parser);
+	}
+
+protected:
+	StoreParser *parser;
+};
+
+static bool isAbove(Store *value, void *userData)
+{
+	return value->content.floatValue > *(double *) userData;
+}
+
+TEST_F(Table, convert)
+{
+	Store *list = storeParse(parser, "[{host = a, cpu = 1, load = 0.5} {host = b, cpu = 2, load = 1} {host = c, load = 2.5, extra = x}]");
+	ASSERT_TRUE(list != NULL) << "test store should parse successfully";
+
+	Store *table = storeToColumns(list);
+	ASSERT_TRUE(table != NULL) << "list of maps should be converted";
+	ASSERT_EQ(table->type, STORE_TABLE) << "converted store should be a table";
+	ASSERT_EQ(storeTableGetNumRows(table), 3) << "table should have a row per map";
+	ASSERT_EQ(storeTableGetNumColumns(table), 4) << "table should have a column per key";
+	ASSERT_STREQ(storeTableGetColumnName(table, 3), "extra") << "columns should be in order of first appearance";
+
+	int host = storeTableFindColumn(table, "host");
+	int cpu = storeTableFindColumn(table, "cpu");
+	int load = storeTableFindColumn(table, "load");
+	ASSERT_EQ(storeTableGetColumnType(table, host), STORE_COLUMN_STRING) << "column of strings should be a string column";
+	ASSERT_EQ(storeTableGetColumnType(table, cpu), STORE_COLUMN_INT) << "column of ints should be an int column";
+	ASSERT_EQ(storeTableGetColumnType(table, load), STORE_COLUMN_FLOAT) << "column of ints and floats should be a float column";
+	ASSERT_EQ(storeTableGetColumnType(table, -1), STORE_COLUMN_INVALID) << "negative column should be invalid";
+	ASSERT_EQ(storeTableGetColumnType(table, 100), STORE_COLUMN_INVALID) << "column past the end should be invalid";
+	ASSERT_EQ(storeTableGetColumnType(list, 0), STORE_COLUMN_INVALID) << "column of a non table should be invalid";
+	ASSERT_EQ(storeTableFindColumn(table, "missing"), -1) << "missing column should not be found";
+
+	const int *cpuValues = storeTableGetIntColumn(table, cpu);
+	ASSERT_TRUE(cpuValues != NULL) << "int column should be accessible as an array";
+	ASSERT_EQ(cpuValues[1], 2) << "int column should hold the row values";
+	ASSERT_TRUE(storeTableIsNull(table, cpu, 2)) << "row missing a key should be null";
+	ASSERT_FALSE(storeTableIsNull(table, cpu, 0)) << "row with a key should not be null";
+	ASSERT_TRUE(storeTableGetFloatColumn(table, cpu) == NULL) << "int column should not be accessible as a float array";
+	ASSERT_EQ(storeTableGetFloatColumn(table, load)[1], 1.0) << "ints in a float column should be converted";
+
+	Store value;
+	ASSERT_TRUE(storeTableGetValue(table, host, 2, &value)) << "present cell should be read";
+	ASSERT_EQ(value.type, STORE_STRING) << "string cell should be read as a string";
+	ASSERT_STREQ(value.content.stringValue, "c") << "string cell should be correct";
+	ASSERT_FALSE(storeTableGetValue(table, cpu, 2, &value)) << "null cell should not be read";
+
+	storeFree(table);
+	storeFree(list);
+}
+
+TEST_F(Table, filter)
+{
+	Store *list = storeParse(parser, "[{load = 0.5} {load = 3} {other = 1} {load = 2.5}]");
+	ASSERT_TRUE(list != NULL) << "test store should parse successfully";
+
+	Store *table = storeToColumns(list);
+	ASSERT_TRUE(table != NULL) << "list of maps should be converted";
+
+	int rows[4];
+	double threshold = 1.0;
+	int numMatches = storeTableFilter(table, storeTableFindColumn(table, "load"), isAbove, &threshold, rows);
+	ASSERT_EQ(numMatches, 2) << "filter should match the rows above the threshold";
+	ASSERT_EQ(rows[0], 1) << "filter should return matching rows in order";
+	ASSERT_EQ(rows[1], 3) << "filter should return matching rows in order";
+	ASSERT_EQ(storeTableFilter(table, 5, isAbove, &threshold, rows), -1) << "filtering a missing column should fail";
+
+	storeFree(table);
+	storeFree(list);
+}
+
+TEST_F(Table, convertInvalid)
+{
+	const char *invalid[] = {"[{a = 1} 2]", "[{a = 1} {a = x}]", "[{a = [1 2]}]", "{a = 1}"};
+
+	for(const char *input : invalid) {
+		Store *store = storeParse(parser, input);
+		ASSERT_TRUE(store != NULL) << "test store '" << input << "' should parse successfully";
+		ASSERT_TRUE(storeToColumns(store) == NULL) << "store '" << input << "' should not be converted";
+		storeFree(store);
+	}
+}
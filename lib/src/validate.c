@@ -0,0 +1,268 @@
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL size_t
+
+#include "store/syntax.h"
+#include "store/validate.h"
+
+typedef struct {
+	const char *data;
+	size_t length;
+	/** The furthest position at which an expected character was missing */
+	size_t failure;
+} Validator;
+
+static bool validateStore(Validator *validator, size_t *position, int depth);
+static bool validateValue(Validator *validator, size_t *position, int depth);
+static bool validateString(Validator *validator, size_t *position);
+static bool validateShortString(Validator *validator, size_t *position);
+static bool validateLongString(Validator *validator, size_t *position);
+static bool validateList(Validator *validator, size_t *position, int depth);
+static bool validateMap(Validator *validator, size_t *position, int depth);
+static void validateEntries(Validator *validator, size_t *position, int depth);
+static bool validateEntry(Validator *validator, size_t *position, int depth);
+static bool validateEnd(Validator *validator, size_t position);
+static size_t skipTerminals(Validator *validator, size_t position);
+static char peek(Validator *validator, size_t position);
+static bool fail(Validator *validator, size_t position);
+
+bool storeValidate(const char *data, size_t length, size_t *errorOffset)
+{
+	Validator validator;
+	validator.data = data;
+	validator.length = length;
+	validator.failure = 0;
+
+	size_t position = 0;
+	if(validateStore(&validator, &position, 0)) {
+		return true;
+	}
+
+	if(errorOffset != NULL) {
+		*errorOffset = validator.failure;
+	}
+
+	return false;
+}
+
+/**
+ * Recognizes a store, see parseStore. All recognizers mirror the parse functions of the same name and take the depth
+ * of the calling parse state, so that nesting is limited at exactly the same point as when parsing.
+ *
+ * @param validator		the validator to use
+ * @param position		pointer to the position to start at, which is advanced past the recognized input on success
+ * @param depth			the depth of the parse state of the caller
+ * @result				true if the input could be recognized
+ */
+static bool validateStore(Validator *validator, size_t *position, int depth)
+{
+	size_t valuePosition = *position;
+	if(validateValue(validator, &valuePosition, depth + 1) && validateEnd(validator, skipTerminals(validator, valuePosition))) {
+		*position = validator->length;
+		return true;
+	}
+
+	size_t entriesPosition = *position;
+	validateEntries(validator, &entriesPosition, depth + 1);
+	if(validateEnd(validator, skipTerminals(validator, entriesPosition))) {
+		*position = validator->length;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * Recognizes a value, see parseValue. Every character that doesn't start a long string, list or map also can't start
+ * an int or float that wouldn't be a valid short string up to the same separator, so all of them are recognized by
+ * scanning for the next separator.
+ */
+static bool validateValue(Validator *validator, size_t *position, int depth)
+{
+	size_t current = skipTerminals(validator, *position);
+	char c = peek(validator, current);
+	if(c == '\0') {
+		return fail(validator, current);
+	}
+
+	bool valid;
+	if(c == '"') {
+		valid = validateLongString(validator, &current);
+	} else if(c == '(' || c == '[') {
+		valid = validateList(validator, &current, depth + 1);
+	} else if(c == '{') {
+		valid = validateMap(validator, &current, depth + 1);
+	} else {
+		valid = validateShortString(validator, &current);
+	}
+
+	if(!valid) {
+		return false;
+	}
+
+	if(!storeIsSeparatorCharacter(peek(validator, current))) {
+		return fail(validator, current);
+	}
+
+	*position = current;
+	return true;
+}
+
+/**
+ * Recognizes a string, see parseString
+ */
+static bool validateString(Validator *validator, size_t *position)
+{
+	if(peek(validator, *position) == '"') {
+		return validateLongString(validator, position);
+	} else {
+		return validateShortString(validator, position);
+	}
+}
+
+/**
+ * Recognizes a short string, see parseShortString
+ */
+static bool validateShortString(Validator *validator, size_t *position)
+{
+	if(!storeScanShortString(validator->data, validator->length, position)) {
+		return fail(validator, *position);
+	}
+
+	return true;
+}
+
+/**
+ * Recognizes a long string including its delimiters, see parseString and parseLongString
+ */
+static bool validateLongString(Validator *validator, size_t *position)
+{
+	size_t current = *position;
+	if(!storeScanLongString(validator->data, validator->length, &current, NULL)) {
+		return fail(validator, current);
+	}
+
+	*position = current;
+	return true;
+}
+
+/**
+ * Recognizes a list, see parseList and parseElements
+ */
+static bool validateList(Validator *validator, size_t *position, int depth)
+{
+	if(depth + 1 >= STORE_MAX_PARSE_DEPTH) {
+		return fail(validator, *position);
+	}
+
+	char closing = peek(validator, *position) == '(' ? ')' : ']';
+	size_t current = *position + 1;
+
+	// the elements are parsed by a nested parse state of the list's one
+	while(validateValue(validator, &current, depth + 2)) {
+		// keep recognizing elements
+	}
+
+	current = skipTerminals(validator, current);
+	if(peek(validator, current) != closing) {
+		return fail(validator, current);
+	}
+
+	*position = current + 1;
+	return true;
+}
+
+/**
+ * Recognizes a map, see parseMap
+ */
+static bool validateMap(Validator *validator, size_t *position, int depth)
+{
+	if(depth + 1 >= STORE_MAX_PARSE_DEPTH) {
+		return fail(validator, *position);
+	}
+
+	size_t current = *position + 1;
+	validateEntries(validator, &current, depth + 1);
+
+	current = skipTerminals(validator, current);
+	if(peek(validator, current) != '}') {
+		return fail(validator, current);
+	}
+
+	*position = current + 1;
+	return true;
+}
+
+/**
+ * Recognizes as many entries as possible, see parseEntries
+ */
+static void validateEntries(Validator *validator, size_t *position, int depth)
+{
+	while(validateEntry(validator, position, depth + 1)) {
+		// keep recognizing entries
+	}
+}
+
+/**
+ * Recognizes an entry, see parseEntry
+ */
+static bool validateEntry(Validator *validator, size_t *position, int depth)
+{
+	size_t current = skipTerminals(validator, *position);
+	if(peek(validator, current) == '\0') {
+		return fail(validator, current);
+	}
+
+	if(!validateString(validator, &current)) {
+		return false;
+	}
+
+	current = skipTerminals(validator, current);
+	char c = peek(validator, current);
+	if(c != ':' && c != '=') {
+		return fail(validator, current);
+	}
+
+	current++;
+	if(!validateValue(validator, &current, depth + 1)) {
+		return false;
+	}
+
+	*position = current;
+	return true;
+}
+
+/**
+ * Checks that a position is the actual end of the input rather than a null character within it
+ */
+static bool validateEnd(Validator *validator, size_t position)
+{
+	if(position != validator->length) {
+		return fail(validator, position);
+	}
+
+	return true;
+}
+
+static size_t skipTerminals(Validator *validator, size_t position)
+{
+	return storeSkipTerminalCharacters(validator->data, validator->length, position);
+}
+
+static char peek(Validator *validator, size_t position)
+{
+	return storePeekCharacter(validator->data, validator->length, position);
+}
+
+/**
+ * Records a failure to recognize the input at a position
+ *
+ * @result				always false
+ */
+static bool fail(Validator *validator, size_t position)
+{
+	if(position > validator->failure) {
+		validator->failure = position;
+	}
+
+	return false;
+}
@@ -0,0 +1,132 @@
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/parser.h>
+	#include <store/store.h>
+	#include <store/syntax.h>
+}
+
+#include "validate.c"
+
+static const char *inputs[] = {
+	"",
+	"   ,; ",
+	"1",
+	"-1",
+	"-",
+	"1.",
+	"1.5e-3",
+	"1e",
+	"12ab",
+	"hello",
+	"\"long \\\"string\\\" with \\u00e4 and \\n\"",
+	"\"unterminated",
+	"\"bad \\x escape\"",
+	"\"surrogate \\ud800\"",
+	"\"short hex \\u12\"",
+	"\"a\"b",
+	"a = 1",
+	"a : 1; b = 2, c = three",
+	"a = 1 }",
+	"a = 1 b",
+	"a =",
+	"= 1",
+	"\"quoted key\" = [1 2 (3 4)]",
+	"[1 2 3",
+	"[1 2 3)",
+	"(1 2 3]",
+	"[1 2 3] x",
+	"{a = {b = {}}}",
+	"{a = 1",
+	"{a 1}",
+	"a = {b = [1 {c = \"d\"}]}; e = []",
+	"[{] }",
+	")",
+	"a = 1]",
+};
+
+static bool parses(const std::string& input)
+{
+	StoreParser *parser = storeCreateParser();
+	Store *store = storeParse(parser, input.c_str());
+	bool success = store != NULL;
+	if(store != NULL) {
+		storeFree(store);
+	}
+
+	storeFreeParser(parser);
+	return success;
+}
+
+static std::string nest(const char *opening, const char *inner, const char *closing, int levels)
+{
+	std::string result = inner;
+	for(int i = 0; i < levels; i++) {
+		result = opening + result + closing;
+	}
+
+	return result;
+}
+
+TEST(Validate, matchesParser)
+{
+	for(const char *input : inputs) {
+		size_t errorOffset = 0;
+		bool valid = storeValidate(input, strlen(input), &errorOffset);
+		ASSERT_EQ(valid, parses(input)) << "validating '" << input << "' should agree with parsing it";
+
+		if(!valid) {
+			ASSERT_LE(errorOffset, strlen(input)) << "error offset of '" << input << "' should be within the input";
+		}
+	}
+}
+
+TEST(Validate, errorOffset)
+{
+	size_t errorOffset = 0;
+	ASSERT_FALSE(storeValidate("a = 1 }", 7, &errorOffset)) << "stray closing bracket should be invalid";
+	ASSERT_EQ(errorOffset, 6) << "error should be at the stray closing bracket";
+
+	ASSERT_FALSE(storeValidate("a = [1 2", 8, &errorOffset)) << "unclosed list should be invalid";
+	ASSERT_EQ(errorOffset, 8) << "error should be at the end of the input";
+
+	ASSERT_FALSE(storeValidate("a = \"x\\q\"", 9, &errorOffset)) << "invalid escape should be invalid";
+	ASSERT_EQ(errorOffset, 7) << "error should be at the escaped character";
+
+	ASSERT_FALSE(storeValidate("x = {a = 1; b 2}", 16, &errorOffset)) << "missing entry separator should be invalid";
+	ASSERT_EQ(errorOffset, 14) << "error should be where the entry separator is missing";
+
+	ASSERT_FALSE(storeValidate("a = ", 4, NULL)) << "error offset should be optional";
+	ASSERT_TRUE(storeValidate("a = 1", 5, NULL)) << "valid input should be valid without error offset";
+}
+
+TEST(Validate, length)
+{
+	const char *input = "a = 1; b = [2 3]; c";
+	ASSERT_TRUE(storeValidate(input, 16, NULL)) << "input should only be recognized up to its length";
+	ASSERT_FALSE(storeValidate(input, 14, NULL)) << "input cut within a list should be invalid";
+
+	size_t errorOffset = 0;
+	ASSERT_FALSE(storeValidate("a = 1\0b = 2", 11, &errorOffset)) << "null character within the input should be invalid";
+	ASSERT_EQ(errorOffset, 5) << "error should be at the null character";
+}
+
+TEST(Validate, depth)
+{
+	for(int levels = 330; levels < 340; levels++) {
+		std::string lists = nest("[", "1", "]", levels);
+		ASSERT_EQ(storeValidate(lists.c_str(), lists.size(), NULL), parses(lists)) << "validating " << levels << " nested lists should agree with parsing them";
+
+		std::string maps = nest("{a = ", "1", "}", levels / 4 * 3);
+		ASSERT_EQ(storeValidate(maps.c_str(), maps.size(), NULL), parses(maps)) << "validating " << levels / 4 * 3 << " nested maps should agree with parsing them";
+
+		std::string entries = "a = " + nest("(", "{b = 1}", ")", levels);
+		ASSERT_EQ(storeValidate(entries.c_str(), entries.size(), NULL), parses(entries)) << "validating " << levels << " nested lists in entries should agree with parsing them";
+	}
+
+	std::string deep = nest("[", "", "]", 100000);
+	ASSERT_FALSE(storeValidate(deep.c_str(), deep.size(), NULL)) << "excessive nesting should be invalid";
+}
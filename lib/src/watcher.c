@@ -0,0 +1,324 @@
+#include <errno.h> // errno EINTR
+#include <poll.h> // poll pollfd POLLIN
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL
+#include <stdlib.h> // free
+#include <string.h> // strcmp strdup strlen strncmp strrchr
+#include <sys/inotify.h> // inotify_init1 inotify_add_watch inotify_event IN_*
+#include <time.h> // clock_gettime timespec CLOCK_MONOTONIC
+#include <unistd.h> // close read
+
+#include <glib.h>
+
+#include "store/diff.h"
+#include "store/file.h"
+#include "store/list.h"
+#include "store/map.h"
+#include "store/memory.h"
+#include "store/parser.h"
+#include "store/watcher.h"
+
+typedef struct {
+	int id;
+	char *pathPrefix;
+	StoreWatchFunction callback;
+	void *userData;
+	/** Whether the subscription was cancelled while notifying subscribers, which deletes it afterwards */
+	bool cancelled;
+} Subscription;
+
+struct StoreWatcherStruct {
+	char *filename;
+	/** The name of the watched file within its directory, which inotify reports events of the directory by */
+	char *basename;
+	int fd;
+	int debounce;
+	StoreParser *parser;
+	Store *store;
+	/** list of (Subscription *) subscriptions in the order they were made */
+	GList *subscriptions;
+	int nextSubscription;
+	/** Whether subscribers are being notified, during which cancelled subscriptions are only marked */
+	bool notifying;
+};
+
+static bool waitForChange(StoreWatcher *watcher, int timeout);
+static bool readEvents(StoreWatcher *watcher);
+static int reload(StoreWatcher *watcher);
+static bool touchesPath(const char *pathPrefix, const char *path);
+static long long getMilliseconds();
+static void deleteCancelledSubscriptions(StoreWatcher *watcher);
+static void freeSubscription(void *subscriptionPointer);
+
+StoreWatcher *storeCreateWatcher(const char *filename, int parseFlags, int debounce)
+{
+	int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(fd < 0) {
+		return NULL;
+	}
+
+	const char *slash = strrchr(filename, '/');
+	GString *directory = slash == NULL ? g_string_new(".") : g_string_new_len(filename, slash == filename ? 1 : slash - filename);
+	int watch = inotify_add_watch(fd, directory->str, IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+	g_string_free(directory, true);
+	if(watch < 0) {
+		close(fd);
+		return NULL;
+	}
+
+	StoreWatcher *watcher = storeAllocateMemoryType(StoreWatcher);
+	watcher->filename = strdup(filename);
+	watcher->basename = strdup(slash == NULL ? filename : slash + 1);
+	watcher->fd = fd;
+	watcher->debounce = debounce;
+	watcher->parser = storeCreateParser();
+	storeSetParserFlags(watcher->parser, parseFlags);
+	watcher->store = NULL;
+	watcher->subscriptions = NULL;
+	watcher->nextSubscription = 0;
+	watcher->notifying = false;
+
+	if(reload(watcher) < 0) {
+		storeFreeWatcher(watcher);
+		return NULL;
+	}
+
+	return watcher;
+}
+
+void storeFreeWatcher(StoreWatcher *watcher)
+{
+	if(watcher->store != NULL) {
+		storeFree(watcher->store);
+	}
+
+	g_list_free_full(watcher->subscriptions, freeSubscription);
+	storeFreeParser(watcher->parser);
+	close(watcher->fd);
+	free(watcher->basename);
+	free(watcher->filename);
+	storeFreeMemory(watcher);
+}
+
+Store *storeWatcherGetStore(StoreWatcher *watcher)
+{
+	return watcher->store;
+}
+
+int storeWatcherGetFd(StoreWatcher *watcher)
+{
+	return watcher->fd;
+}
+
+int storeWatcherSubscribe(StoreWatcher *watcher, const char *pathPrefix, StoreWatchFunction callback, void *userData)
+{
+	Subscription *subscription = storeAllocateMemoryType(Subscription);
+	subscription->id = watcher->nextSubscription++;
+	subscription->pathPrefix = strdup(pathPrefix);
+	subscription->callback = callback;
+	subscription->userData = userData;
+	subscription->cancelled = false;
+
+	watcher->subscriptions = g_list_append(watcher->subscriptions, subscription);
+	return subscription->id;
+}
+
+void storeWatcherUnsubscribe(StoreWatcher *watcher, int subscription)
+{
+	for(GList *iter = watcher->subscriptions; iter != NULL; iter = iter->next) {
+		if(((Subscription *) iter->data)->id == subscription) {
+			if(watcher->notifying) {
+				// the list is being iterated, so only delete the subscription once notifying is done
+				((Subscription *) iter->data)->cancelled = true;
+			} else {
+				freeSubscription(iter->data);
+				watcher->subscriptions = g_list_delete_link(watcher->subscriptions, iter);
+			}
+			return;
+		}
+	}
+}
+
+int storeWatcherProcess(StoreWatcher *watcher, int timeout)
+{
+	if(!waitForChange(watcher, timeout)) {
+		return 0;
+	}
+
+	// writers often change a file in several steps, only re-parse once they are done
+	while(waitForChange(watcher, watcher->debounce)) {
+		// keep waiting
+	}
+
+	return reload(watcher);
+}
+
+/**
+ * Waits for an event about the watched file
+ *
+ * @param watcher		the watcher to wait with
+ * @param timeout		the maximum number of milliseconds to wait, or -1 to wait indefinitely
+ * @result				true if the watched file changed, false if the timeout expired or waiting failed
+ */
+static bool waitForChange(StoreWatcher *watcher, int timeout)
+{
+	long long deadline = getMilliseconds() + timeout;
+
+	while(true) {
+		int remaining = -1;
+		if(timeout >= 0) {
+			long long now = getMilliseconds();
+			remaining = now < deadline ? (int) (deadline - now) : 0;
+		}
+
+		struct pollfd pollFd;
+		pollFd.fd = watcher->fd;
+		pollFd.events = POLLIN;
+		pollFd.revents = 0;
+		int ready = poll(&pollFd, 1, remaining);
+		if(ready < 0 && errno == EINTR) {
+			continue;
+		} else if(ready <= 0) {
+			return false;
+		}
+
+		if(readEvents(watcher)) {
+			return true;
+		}
+	}
+}
+
+/**
+ * Reads all pending events of a watcher's directory
+ *
+ * @param watcher		the watcher to read the events of
+ * @result				true if any of the events was about the watched file
+ */
+static bool readEvents(StoreWatcher *watcher)
+{
+	bool changed = false;
+	char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+	while(true) {
+		ssize_t length = read(watcher->fd, buffer, sizeof(buffer));
+		if(length <= 0) {
+			return changed;
+		}
+
+		for(char *position = buffer; position < buffer + length; ) {
+			struct inotify_event *event = (struct inotify_event *) position;
+			// events were dropped if the queue overflowed, so any of them could have been about the watched file
+			if((event->mask & IN_Q_OVERFLOW) || (event->len > 0 && strcmp(event->name, watcher->basename) == 0)) {
+				changed = true;
+			}
+
+			position += sizeof(struct inotify_event) + event->len;
+		}
+	}
+}
+
+/**
+ * Parses the watched file and notifies the subscribers about the changes to the previous store
+ *
+ * @param watcher		the watcher to reload
+ * @result				the number of subscribers notified, or -1 if the file can't be read or parsed
+ */
+static int reload(StoreWatcher *watcher)
+{
+	char *contents = storeReadFile(watcher->filename, NULL);
+	if(contents == NULL) {
+		return -1;
+	}
+
+	Store *store = storeParse(watcher->parser, contents);
+	free(contents);
+	if(store == NULL) {
+		return -1;
+	}
+
+	Store *previous = watcher->store;
+	watcher->store = store;
+	if(previous == NULL) {
+		return 0;
+	}
+
+	int notified = 0;
+	Store *patch = storeDiff(previous, store);
+	watcher->notifying = true;
+	for(GList *iter = watcher->subscriptions; iter != NULL && storeListGetLength(patch) > 0; iter = iter->next) {
+		Subscription *subscription = (Subscription *) iter->data;
+		if(subscription->cancelled) {
+			continue;
+		}
+
+		Store *changes = storeCreateListValue();
+		for(GList *operationIter = patch->content.listValue->head; operationIter != NULL; operationIter = operationIter->next) {
+			Store *operation = (Store *) operationIter->data;
+			if(touchesPath(subscription->pathPrefix, storeMapLookup(operation, "path")->content.stringValue)) {
+				storeListAppend(changes, storeRetain(operation));
+			}
+		}
+
+		if(storeListGetLength(changes) > 0) {
+			subscription->callback(store, changes, subscription->userData);
+			notified++;
+		}
+
+		storeFree(changes);
+	}
+	watcher->notifying = false;
+	deleteCancelledSubscriptions(watcher);
+
+	storeFree(patch);
+	storeFree(previous);
+	return notified;
+}
+
+/**
+ * Returns whether an operation at a path touches a subscribed path, i.e. whether one of them is a prefix of the other
+ * consisting of whole segments
+ */
+static bool touchesPath(const char *pathPrefix, const char *path)
+{
+	size_t prefixLength = strlen(pathPrefix);
+	size_t pathLength = strlen(path);
+	const char *shorter = prefixLength < pathLength ? pathPrefix : path;
+	const char *longer = prefixLength < pathLength ? path : pathPrefix;
+	size_t length = prefixLength < pathLength ? prefixLength : pathLength;
+
+	if(strncmp(shorter, longer, length) != 0) {
+		return false;
+	}
+
+	char next = longer[length];
+	return length == 0 || next == '\0' || next == '.' || next == '[';
+}
+
+static long long getMilliseconds()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (long long) time.tv_sec * 1000 + time.tv_nsec / 1000000;
+}
+
+/**
+ * Deletes the subscriptions that were cancelled while notifying subscribers
+ */
+static void deleteCancelledSubscriptions(StoreWatcher *watcher)
+{
+	for(GList *iter = watcher->subscriptions; iter != NULL; ) {
+		GList *next = iter->next;
+		if(((Subscription *) iter->data)->cancelled) {
+			freeSubscription(iter->data);
+			watcher->subscriptions = g_list_delete_link(watcher->subscriptions, iter);
+		}
+		iter = next;
+	}
+}
+
+static void freeSubscription(void *subscriptionPointer)
+{
+	Subscription *subscription = (Subscription *) subscriptionPointer;
+	free(subscription->pathPrefix);
+	storeFreeMemory(subscription);
+}
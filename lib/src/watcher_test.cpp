@@ -0,0 +1,147 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "file.c"
+#include "watcher.c"
+
+typedef struct {
+	int numCalls;
+	int numChanges;
+} Notifications;
+
+static void notify(Store *store, Store *changes, void *userData)
+{
+	Notifications *notifications = (Notifications *) userData;
+	notifications->numCalls++;
+	notifications->numChanges += storeListGetLength(changes);
+}
+
+class Watcher: public ::testing::Test {
+public:
+	virtual void SetUp() {
+		char pattern[] = "/tmp/store_watcher_XXXXXX";
+		ASSERT_TRUE(mkdtemp(pattern) != NULL) << "temporary directory should be created";
+		directory = pattern;
+		filename = directory + "/config.store";
+	}
+
+	virtual void TearDown() {
+		unlink(filename.c_str());
+		unlink((directory + "/replacement").c_str());
+		rmdir(directory.c_str());
+	}
+
+protected:
+	void write(const std::string& name, const char *contents) {
+		FILE *file = fopen(name.c_str(), "wb");
+		ASSERT_TRUE(file != NULL) << "test file should be written";
+		fputs(contents, file);
+		fclose(file);
+	}
+
+	std::string directory;
+	std::string filename;
+};
+
+TEST_F(Watcher, notify)
+{
+	write(filename, "servers = [{name = alpha} {name = beta}]; timeout = 10");
+	StoreWatcher *watcher = storeCreateWatcher(filename.c_str(), 0, 50);
+	ASSERT_TRUE(watcher != NULL) << "watcher should be created";
+	ASSERT_EQ(storeMapGetSize(storeWatcherGetStore(watcher)), 2) << "watched file should be parsed initially";
+
+	Notifications servers = {0, 0};
+	Notifications timeout = {0, 0};
+	Notifications everything = {0, 0};
+	storeWatcherSubscribe(watcher, "servers", notify, &servers);
+	storeWatcherSubscribe(watcher, "timeout", notify, &timeout);
+	int subscription = storeWatcherSubscribe(watcher, "", notify, &everything);
+
+	ASSERT_EQ(storeWatcherProcess(watcher, 0), 0) << "nothing should be processed before the file changes";
+
+	// several writes in quick succession are debounced into a single re-parse
+	write(filename, "servers = [{name = alpha} {name = gamma}]; timeout = 10");
+	write(filename, "servers = [{name = alpha} {name = delta}]; timeout = 10");
+	ASSERT_EQ(storeWatcherProcess(watcher, 1000), 2) << "subscribers of changed paths should be notified";
+	ASSERT_EQ(servers.numCalls, 1) << "subscriber of the changed path should be notified once";
+	ASSERT_EQ(servers.numChanges, 1) << "subscriber should receive the changes below its path";
+	ASSERT_EQ(timeout.numCalls, 0) << "subscriber of an unchanged path should not be notified";
+	ASSERT_EQ(everything.numCalls, 1) << "subscriber of the whole store should be notified";
+	ASSERT_STREQ(storeMapLookup(storeListGet(storeMapLookup(storeWatcherGetStore(watcher), "servers"), 1), "name")->content.stringValue, "delta") << "store should be re-parsed";
+
+	// replacing the file by renaming another one over it is noticed as well
+	storeWatcherUnsubscribe(watcher, subscription);
+	write(directory + "/replacement", "servers = [{name = alpha} {name = delta}]; timeout = 20");
+	rename((directory + "/replacement").c_str(), filename.c_str());
+	ASSERT_EQ(storeWatcherProcess(watcher, 1000), 1) << "only the remaining subscriber of the changed path should be notified";
+	ASSERT_EQ(timeout.numCalls, 1) << "subscriber of the changed path should be notified";
+	ASSERT_EQ(everything.numCalls, 1) << "cancelled subscription should not be notified";
+
+	// a file that doesn't parse keeps the previous store
+	write(filename, "servers = [");
+	ASSERT_EQ(storeWatcherProcess(watcher, 1000), -1) << "unparseable file should be reported";
+	ASSERT_EQ(storeMapLookup(storeWatcherGetStore(watcher), "timeout")->content.intValue, 20) << "previous store should be kept";
+
+	storeFreeWatcher(watcher);
+}
+
+typedef struct {
+	StoreWatcher *watcher;
+	int subscription;
+	int numCalls;
+} Canceller;
+
+static void cancel(Store *store, Store *changes, void *userData)
+{
+	Canceller *canceller = (Canceller *) userData;
+	canceller->numCalls++;
+	storeWatcherUnsubscribe(canceller->watcher, canceller->subscription);
+}
+
+TEST_F(Watcher, unsubscribeWhileNotifying)
+{
+	write(filename, "timeout = 10");
+	StoreWatcher *watcher = storeCreateWatcher(filename.c_str(), 0, 50);
+	ASSERT_TRUE(watcher != NULL) << "watcher should be created";
+
+	Canceller first = {watcher, 0, 0};
+	Notifications second = {0, 0};
+	Canceller third = {watcher, 0, 0};
+	int firstSubscription = storeWatcherSubscribe(watcher, "", cancel, &first);
+	first.subscription = storeWatcherSubscribe(watcher, "", notify, &second);
+	third.subscription = storeWatcherSubscribe(watcher, "", cancel, &third);
+
+	write(filename, "timeout = 20");
+	ASSERT_EQ(storeWatcherProcess(watcher, 1000), 2) << "subscriber cancelled by an earlier one should not be notified";
+	ASSERT_EQ(first.numCalls, 1) << "cancelling subscriber should be notified";
+	ASSERT_EQ(second.numCalls, 0) << "cancelled subscription should not be notified";
+	ASSERT_EQ(third.numCalls, 1) << "subscriber cancelling itself should be notified";
+
+	storeWatcherUnsubscribe(watcher, firstSubscription);
+	write(filename, "timeout = 30");
+	ASSERT_EQ(storeWatcherProcess(watcher, 1000), 0) << "cancelled subscriptions should not be notified anymore";
+	ASSERT_EQ(third.numCalls, 1) << "subscriber that cancelled itself should not be notified again";
+
+	storeFreeWatcher(watcher);
+}
+
+TEST(WatcherPath, touchesPath)
+{
+	ASSERT_TRUE(touchesPath("servers", "servers[1].name")) << "change below the path should touch it";
+	ASSERT_TRUE(touchesPath("servers[1].name", "servers")) << "change above the path should touch it";
+	ASSERT_TRUE(touchesPath("servers", "")) << "change of the whole store should touch every path";
+	ASSERT_FALSE(touchesPath("servers", "serversBackup")) << "paths should only be matched by whole segments";
+	ASSERT_FALSE(touchesPath("servers[1]", "servers[10]")) << "indices should only be matched as a whole";
+}
@@ -0,0 +1,217 @@
+#include <stdbool.h> // bool true false
+#include <stddef.h> // NULL
+#include <stdio.h> // snprintf
+#include <string.h> // strlen strpbrk
+
+#include <glib.h>
+
+#include "store/list.h"
+#include "store/map.h"
+#include "store/table.h"
+#include "store/writer.h"
+
+static bool writeValue(GString *string, Store *store);
+static bool writeList(GString *string, Store *store);
+static bool writeMap(GString *string, Store *store);
+static bool writeTable(GString *string, Store *store);
+static bool writeFloat(GString *string, double value);
+static void writeString(GString *string, const char *value, int length);
+
+char *storeWrite(Store *store)
+{
+	GString *string = g_string_new("");
+	if(!writeValue(string, store)) {
+		g_string_free(string, true);
+		return NULL;
+	}
+
+	char *result = string->str;
+	g_string_free(string, false);
+	return result;
+}
+
+static bool writeValue(GString *string, Store *store)
+{
+	switch(store->type) {
+		case STORE_STRING:
+			writeString(string, store->content.stringValue, storeGetStringLength(store));
+			return true;
+		case STORE_INT:
+			g_string_append_printf(string, "%d", store->content.intValue);
+			return true;
+		case STORE_FLOAT:
+			return writeFloat(string, store->content.floatValue);
+		case STORE_MAP:
+			return writeMap(string, store);
+		case STORE_TABLE:
+			return writeTable(string, store);
+		default:
+			return writeList(string, store);
+	}
+}
+
+/**
+ * Writes a generic list or packed array store as a list in square brackets
+ */
+static bool writeList(GString *string, Store *store)
+{
+	g_string_append_c(string, '[');
+
+	int length = storeListGetLength(store);
+	GList *link = store->type == STORE_LIST ? store->content.listValue->head : NULL;
+	for(int i = 0; i < length; i++) {
+		Store buffer;
+		Store *element = &buffer;
+		if(link != NULL) {
+			element = (Store *) link->data;
+			link = link->next;
+		} else {
+			storeListGetElement(store, i, &buffer);
+		}
+
+		if(i > 0) {
+			g_string_append_c(string, ' ');
+		}
+
+		if(!writeValue(string, element)) {
+			return false;
+		}
+	}
+
+	g_string_append_c(string, ']');
+	return true;
+}
+
+static bool writeMap(GString *string, Store *store)
+{
+	g_string_append_c(string, '{');
+
+	bool first = true;
+	StoreMapIterator iterator;
+	const char *key;
+	Store *value;
+	storeMapIteratorInit(&iterator, store);
+	while(storeMapIteratorNext(&iterator, &key, &value)) {
+		if(!first) {
+			g_string_append_c(string, ' ');
+		}
+
+		writeString(string, key, strlen(key));
+		g_string_append(string, " = ");
+		if(!writeValue(string, value)) {
+			return false;
+		}
+
+		first = false;
+	}
+
+	g_string_append_c(string, '}');
+	return true;
+}
+
+/**
+ * Writes a table store as a list of maps, one per row, leaving out the row's absent cells
+ */
+static bool writeTable(GString *string, Store *store)
+{
+	int numRows = storeTableGetNumRows(store);
+	int numColumns = storeTableGetNumColumns(store);
+
+	g_string_append_c(string, '[');
+	for(int row = 0; row < numRows; row++) {
+		if(row > 0) {
+			g_string_append_c(string, ' ');
+		}
+
+		g_string_append_c(string, '{');
+		bool first = true;
+		for(int column = 0; column < numColumns; column++) {
+			Store value;
+			if(!storeTableGetValue(store, column, row, &value)) {
+				continue;
+			}
+
+			if(!first) {
+				g_string_append_c(string, ' ');
+			}
+
+			const char *name = storeTableGetColumnName(store, column);
+			writeString(string, name, strlen(name));
+			g_string_append(string, " = ");
+			if(!writeValue(string, &value)) {
+				return false;
+			}
+
+			first = false;
+		}
+		g_string_append_c(string, '}');
+	}
+	g_string_append_c(string, ']');
+
+	return true;
+}
+
+/**
+ * Writes a float with enough digits to be read back exactly, and with a fraction or exponent so that it isn't read back
+ * as an int
+ */
+static bool writeFloat(GString *string, double value)
+{
+	if(value != value || value - value != 0) {
+		return false;
+	}
+
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%.17g", value);
+	g_string_append(string, buffer);
+
+	if(strpbrk(buffer, ".eE") == NULL) {
+		g_string_append(string, ".0");
+	}
+
+	return true;
+}
+
+/**
+ * Writes a string in double quotes, escaping quotes, backslashes and control characters
+ */
+static void writeString(GString *string, const char *value, int length)
+{
+	g_string_append_c(string, '"');
+
+	for(int i = 0; i < length; i++) {
+		char c = value[i];
+		switch(c) {
+			case '"':
+				g_string_append(string, "\\\"");
+			break;
+			case '\\':
+				g_string_append(string, "\\\\");
+			break;
+			case '\b':
+				g_string_append(string, "\\b");
+			break;
+			case '\f':
+				g_string_append(string, "\\f");
+			break;
+			case '\n':
+				g_string_append(string, "\\n");
+			break;
+			case '\r':
+				g_string_append(string, "\\r");
+			break;
+			case '\t':
+				g_string_append(string, "\\t");
+			break;
+			default:
+				if((unsigned char) c < 0x20) {
+					g_string_append_printf(string, "\\u%04x", (unsigned int) c);
+				} else {
+					g_string_append_c(string, c);
+				}
+			break;
+		}
+	}
+
+	g_string_append_c(string, '"');
+}
@@ -0,0 +1,66 @@
+#include <cmath>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+	#include <store/parser.h>
+	#include <store/store.h>
+}
+
+#include "writer.c"
+
+static void expectRoundTrip(const char *input, int flags = 0)
+{
+	StoreParser *parser = storeCreateParser();
+	storeSetParserFlags(parser, flags);
+	Store *store = storeParse(parser, input);
+	ASSERT_TRUE(store != NULL) << "test store '" << input << "' should parse successfully";
+
+	char *written = storeWrite(store);
+	ASSERT_TRUE(written != NULL) << "store '" << input << "' should be written";
+
+	Store *reparsed = storeParse(parser, written);
+	ASSERT_TRUE(reparsed != NULL) << "written store '" << written << "' should parse successfully";
+
+	// compare the written texts since the writer doesn't depend on the comparison module
+	char *rewritten = storeWrite(reparsed);
+	ASSERT_STREQ(rewritten, written) << "written store '" << written << "' should be read back unchanged";
+
+	free(rewritten);
+	free(written);
+	storeFree(reparsed);
+	storeFree(store);
+	storeFreeParser(parser);
+}
+
+TEST(Writer, roundTrip)
+{
+	expectRoundTrip("a = 1; b = -2.5; c = hello; d = \"with spaces\"");
+	expectRoundTrip("a = {b = [1 2 3], c = {}}; d = []");
+	expectRoundTrip("\"quote \\\" backslash \\\\ newline \\n tab \\t bell \\u0007\"");
+	expectRoundTrip("[1.0 1e300 -0.0 0.1 123456789.125]");
+	expectRoundTrip("[[1 2 3] [1.5 2.5]]", STORE_PARSE_PACK_LISTS);
+	expectRoundTrip("{\"key with = and ;\" = value}");
+	expectRoundTrip("42");
+}
+
+TEST(Writer, format)
+{
+	Store *store = storeCreateMapValue();
+	storeMapInsert(store, "a", storeCreateIntValue(1));
+	storeMapInsert(store, "b", storeCreateFloatValue(2));
+	Store *list = storeCreateListValue();
+	storeListAppend(list, storeCreateStringValue("x"));
+	storeListAppend(list, storeCreateStringValue("y\"z"));
+	storeMapInsert(store, "c", list);
+
+	char *written = storeWrite(store);
+	ASSERT_STREQ(written, "{\"a\" = 1 \"b\" = 2.0 \"c\" = [\"x\" \"y\\\"z\"]}") << "store should be written in the expected format";
+	free(written);
+
+	storeMapInsert(store, "d", storeCreateFloatValue(INFINITY));
+	ASSERT_TRUE(storeWrite(store) == NULL) << "infinite floats should not be written";
+
+	storeFree(store);
+}